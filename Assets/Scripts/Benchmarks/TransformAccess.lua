@@ -0,0 +1,47 @@
+--
+-- > Notice: Amélie Heinrich @ 2025
+-- > Create Time: 2025-02-20 16:40:51
+--
+
+-- Attach to a batch of entities and press F9 to compare the usertype path against the flat array path.
+local module = {}
+local positions = {}
+local iterations = 100
+
+local function usertypePath(entities, dt)
+    for i = 1, #entities do
+        local position = Entity.GetTransform(entities[i]).position
+        position.x = position.x + dt
+        position.z = position.z - dt
+    end
+end
+
+local function arrayPath(entities, dt)
+    Transforms.ReadPositions(entities, positions)
+    for i = 1, #entities do
+        local base = (i - 1) * 3
+        positions[base + 1] = positions[base + 1] + dt
+        positions[base + 3] = positions[base + 3] - dt
+    end
+    Transforms.WritePositions(entities, positions)
+end
+
+local function measure(fn, entities)
+    local start = os.clock()
+    for _ = 1, iterations do
+        fn(entities, 0.0)
+    end
+    return (os.clock() - start) * 1000.0 / iterations
+end
+
+function module.updateAll(entities, dt)
+    if not Input.IsKeyPressed(Keycode.F9) then
+        return
+    end
+
+    local usertype = measure(usertypePath, entities)
+    local array = measure(arrayPath, entities)
+    print(string.format("[TransformAccess] %d entities: usertype %.4fms, arrays %.4fms", #entities, usertype, array))
+end
+
+return module
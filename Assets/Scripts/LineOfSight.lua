@@ -0,0 +1,64 @@
+--
+-- > Notice: Amélie Heinrich @ 2025
+-- > Create Time: 2025-02-26 11:20:37
+--
+
+-- Every entity carrying this script checks whether it can see the entity named "Player".
+-- All the line-of-sight rays of the frame go through a single Physics.Raycast batch.
+-- The result of the last frame is kept in module.seesPlayer, by entity, for that frame's entities only.
+local module = {}
+module.seesPlayer = {}
+-- Last frame's table, emptied and refilled so entities that are gone drop out without a new table every frame
+local spare = {}
+local positions = {}
+local origins = {}
+local directions = {}
+local distances = {}
+local results = {}
+
+function module.updateAll(entities, dt)
+    local player = Entity.GetEntityByName("Player")
+    if player == -1 then
+        return
+    end
+
+    local target = Entity.GetTransform(player).position
+    Transforms.ReadPositions(entities, positions)
+    for i = 1, #entities do
+        local base = (i - 1) * 3
+        local x = target.x - positions[base + 1]
+        local y = target.y - positions[base + 2]
+        local z = target.z - positions[base + 3]
+        origins[base + 1] = positions[base + 1]
+        origins[base + 2] = positions[base + 2]
+        origins[base + 3] = positions[base + 3]
+        directions[base + 1] = x
+        directions[base + 2] = y
+        directions[base + 3] = z
+        distances[i] = math.sqrt(x * x + y * y + z * z)
+    end
+
+    -- Physics.Raycast casts one ray per origin, drop the ones left over from frames with more entities
+    for j = #origins, #entities * 3 + 1, -1 do
+        origins[j] = nil
+        directions[j] = nil
+    end
+    for j = #distances, #entities + 1, -1 do
+        distances[j] = nil
+    end
+
+    -- Rays start inside the entities' own colliders, skip them
+    Physics.Raycast(origins, directions, distances, results, entities)
+    local sees = spare
+    for entity in pairs(sees) do
+        sees[entity] = nil
+    end
+    for i = 1, #entities do
+        -- Whatever the ray hits first is either the player or something in the way
+        sees[entities[i]] = results.hit[i] and results.entity[i] == player
+    end
+    spare = module.seesPlayer
+    module.seesPlayer = sees
+end
+
+return module
@@ -0,0 +1,33 @@
+--
+-- > Notice: Amélie Heinrich @ 2025
+-- > Create Time: 2025-02-20 14:12:08
+--
+
+-- Batched version of Translate.lua: one updateAll call per frame for every entity carrying this script.
+local module = {}
+local positions = {}
+
+-- Only touches the transforms it is handed, so it can run on the script workers.
+module.parallel = true
+
+function module.updateAll(entities, dt)
+    local dx = 0.0
+    local dz = 0.0
+    if Input.IsKeyDown(Keycode.Left) then dz = dz - (1.0 * dt) end
+    if Input.IsKeyDown(Keycode.Right) then dz = dz + (1.0 * dt) end
+    if Input.IsKeyDown(Keycode.Up) then dx = dx + (1.0 * dt) end
+    if Input.IsKeyDown(Keycode.Down) then dx = dx - (1.0 * dt) end
+    if dx == 0.0 and dz == 0.0 then
+        return
+    end
+
+    Transforms.ReadPositions(entities, positions)
+    for i = 1, #entities do
+        local base = (i - 1) * 3
+        positions[base + 1] = positions[base + 1] + dx
+        positions[base + 3] = positions[base + 3] + dz
+    end
+    Transforms.WritePositions(entities, positions)
+end
+
+return module
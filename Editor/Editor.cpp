@@ -101,6 +101,7 @@ void Editor::OnImGui(const Frame& frame)
         return;
 
     PROFILE_FUNCTION();
+    MEMORY_TAG(MemoryTag::Editor);
 
     BeginDockSpace();
     ProjectEditor();
@@ -403,7 +403,9 @@ void Editor::AssetPanel()
                 ICON_FA_SUN_O " Environment Maps",
                 ICON_FA_CODE " Scripts",
                 ICON_FA_MUSIC " Audio Files",
-                ICON_FA_CAMERA_RETRO " Post Process Volumes"
+                ICON_FA_CAMERA_RETRO " Post Process Volumes",
+                ICON_FA_SHIELD " Colliders",
+                ICON_FA_MAP " Navigation Meshes"
             };
             for (int i = 1; i < (int)AssetType::MAX; i++) {
                 ImGui::PushStyleColor(ImGuiCol_Header, (ImVec4)ImColor::HSV(i / 7.0f, 0.6f, 0.6f));
@@ -422,7 +424,9 @@ void Editor::AssetPanel()
                             ICON_FA_SUN_O,
                             ICON_FA_CODE,
                             ICON_FA_MUSIC,
-                            ICON_FA_CAMERA_RETRO
+                            ICON_FA_CAMERA_RETRO,
+                            ICON_FA_SHIELD,
+                            ICON_FA_MAP
                         };
 
                         char temp[256];
@@ -717,9 +721,21 @@ void Editor::EntityEditor()
                 }
 
                 ImGui::Separator();
+                if (audio.Handle) {
+                    ImGui::Text("Decoding: %s", audio.Handle->Audio->GetMode() == AudioDecodeMode::Streamed ? "Streamed" : "Pre-decoded");
+                }
                 ImGui::SliderFloat("Volume", &audio.Volume, 0.0f, 100.0f, "%.1f");
+                ImGui::DragInt("Priority", &audio.Priority);
                 ImGui::Checkbox("Play On Awake", &audio.PlayOnAwake);
                 ImGui::Checkbox("Looping", &audio.Looping);
+                ImGui::Checkbox("Spatial", &audio.Spatial);
+                if (audio.Spatial) {
+                    ImGui::DragFloatRange2("Distance", &audio.MinDistance, &audio.MaxDistance, 0.1f, 0.0f, 1000.0f, "Min: %.1f", "Max: %.1f");
+                    ImGui::SliderFloat("Rolloff", &audio.Rolloff, 0.0f, 10.0f, "%.2f");
+                    ImGui::DragFloatRange2("Cone", &audio.ConeInnerAngle, &audio.ConeOuterAngle, 1.0f, 0.0f, 360.0f, "Inner: %.0f", "Outer: %.0f");
+                    ImGui::SliderFloat("Cone Outer Gain", &audio.ConeOuterGain, 0.0f, 1.0f, "%.2f");
+                    ImGui::SliderFloat("Doppler Factor", &audio.DopplerFactor, 0.0f, 5.0f, "%.2f");
+                }
                 ImGui::TreePop();
 
                 if (shouldDelete) {
@@ -729,6 +745,202 @@ void Editor::EntityEditor()
             }
         }
 
+        // Rigid Body
+        if (mSelectedEntity.HasComponent<RigidBodyComponent>()) {
+            if (ImGui::TreeNodeEx(ICON_FA_CUBES " Rigid Body Component", ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_DefaultOpen)) {
+                auto& rigidBody = mSelectedEntity.GetComponent<RigidBodyComponent>();
+
+                bool shouldDelete = false;
+                ImGui::PushStyleColor(ImGuiCol_Button, (ImVec4)ImColor::HSV(7.0f, 0.6f, 0.6f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, (ImVec4)ImColor::HSV(7.0f, 0.7f, 0.7f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonActive, (ImVec4)ImColor::HSV(7.0f, 0.8f, 0.8f));
+                ImGui::PushStyleVar(ImGuiStyleVar_ButtonTextAlign, ImVec2(0.5f, 0.5f));
+                if (ImGui::Button(ICON_FA_TRASH " Delete", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+                    shouldDelete = true;
+                }
+                ImGui::PopStyleColor(3);
+                ImGui::PopStyleVar();
+                ImGui::Separator();
+
+                const char* types[] = { "Static", "Kinematic", "Dynamic" };
+                ImGui::Combo("Type", (int*)&rigidBody.Type, types, 3);
+                ImGui::DragFloat("Mass", &rigidBody.Mass, 0.1f, 0.001f, 10000.0f);
+                ImGui::SliderFloat("Friction", &rigidBody.Friction, 0.0f, 1.0f);
+                ImGui::SliderFloat("Restitution", &rigidBody.Restitution, 0.0f, 1.0f);
+                ImGui::SliderFloat("Linear Damping", &rigidBody.LinearDamping, 0.0f, 1.0f);
+                ImGui::SliderFloat("Angular Damping", &rigidBody.AngularDamping, 0.0f, 1.0f);
+                ImGui::DragFloat("Gravity Factor", &rigidBody.GravityFactor, 0.05f);
+                ImGui::TreePop();
+
+                if (shouldDelete) {
+                    mSelectedEntity.RemoveComponent<RigidBodyComponent>();
+                }
+            }
+        }
+
+        // Collider
+        if (mSelectedEntity.HasComponent<ColliderComponent>()) {
+            if (ImGui::TreeNodeEx(ICON_FA_SHIELD " Collider Component", ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_DefaultOpen)) {
+                auto& collider = mSelectedEntity.GetComponent<ColliderComponent>();
+
+                bool shouldDelete = false;
+                ImGui::PushStyleColor(ImGuiCol_Button, (ImVec4)ImColor::HSV(7.0f, 0.6f, 0.6f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, (ImVec4)ImColor::HSV(7.0f, 0.7f, 0.7f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonActive, (ImVec4)ImColor::HSV(7.0f, 0.8f, 0.8f));
+                ImGui::PushStyleVar(ImGuiStyleVar_ButtonTextAlign, ImVec2(0.5f, 0.5f));
+                if (ImGui::Button(ICON_FA_TRASH " Delete", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+                    shouldDelete = true;
+                }
+                ImGui::PopStyleColor(3);
+                ImGui::PopStyleVar();
+                ImGui::Separator();
+
+                const char* shapes[] = { "Box", "Sphere", "Capsule", "Mesh", "Convex Hull" };
+                ImGui::Combo("Shape", (int*)&collider.Shape, shapes, 5);
+                switch (collider.Shape) {
+                    case ColliderShape::Box: {
+                        ImGui::DragFloat3("Half Extents", glm::value_ptr(collider.HalfExtents), 0.05f, 0.001f, 1000.0f);
+                        break;
+                    }
+                    case ColliderShape::Sphere: {
+                        ImGui::DragFloat("Radius", &collider.Radius, 0.05f, 0.001f, 1000.0f);
+                        break;
+                    }
+                    case ColliderShape::Capsule: {
+                        ImGui::DragFloat("Radius", &collider.Radius, 0.05f, 0.001f, 1000.0f);
+                        ImGui::DragFloat("Half Height", &collider.HalfHeight, 0.05f, 0.001f, 1000.0f);
+                        break;
+                    }
+                    case ColliderShape::Mesh:
+                    case ColliderShape::ConvexHull: {
+                        char temp[512];
+                        sprintf(temp, "%s %s", ICON_FA_FILE, collider.MeshPath.empty() ? "Open..." : collider.MeshPath.c_str());
+                        if (ImGui::Button(temp, ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+                            String path = Dialog::Open({ ".gltf", ".glb", ".obj", ".fbx" });
+                            if (!path.empty()) {
+                                collider.MeshPath = path;
+                            }
+                        }
+                        break;
+                    }
+                }
+                ImGui::TreePop();
+
+                if (shouldDelete) {
+                    mSelectedEntity.RemoveComponent<ColliderComponent>();
+                }
+            }
+        }
+
+        // Nav Mesh
+        if (mSelectedEntity.HasComponent<NavMeshComponent>()) {
+            if (ImGui::TreeNodeEx(ICON_FA_MAP " Nav Mesh Component", ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_DefaultOpen)) {
+                auto& navMesh = mSelectedEntity.GetComponent<NavMeshComponent>();
+
+                bool shouldDelete = false;
+                ImGui::PushStyleColor(ImGuiCol_Button, (ImVec4)ImColor::HSV(7.0f, 0.6f, 0.6f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, (ImVec4)ImColor::HSV(7.0f, 0.7f, 0.7f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonActive, (ImVec4)ImColor::HSV(7.0f, 0.8f, 0.8f));
+                ImGui::PushStyleVar(ImGuiStyleVar_ButtonTextAlign, ImVec2(0.5f, 0.5f));
+                if (ImGui::Button(ICON_FA_TRASH " Delete", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+                    shouldDelete = true;
+                }
+                ImGui::PopStyleColor(3);
+                ImGui::PopStyleVar();
+                ImGui::Separator();
+
+                char temp[512];
+                sprintf(temp, "%s %s", ICON_FA_FILE, navMesh.MeshPath.empty() ? "Open..." : navMesh.MeshPath.c_str());
+                if (ImGui::Button(temp, ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+                    String path = Dialog::Open({ ".gltf", ".glb", ".obj", ".fbx" });
+                    if (!path.empty()) {
+                        navMesh.MeshPath = path;
+                    }
+                }
+                ImGui::DragFloat("Cell Size", &navMesh.Settings.CellSize, 0.01f, 0.05f, 2.0f);
+                ImGui::DragFloat("Cell Height", &navMesh.Settings.CellHeight, 0.01f, 0.05f, 2.0f);
+                ImGui::DragFloat("Agent Height", &navMesh.Settings.AgentHeight, 0.05f, 0.1f, 10.0f);
+                ImGui::DragFloat("Agent Radius", &navMesh.Settings.AgentRadius, 0.05f, 0.0f, 10.0f);
+                ImGui::DragFloat("Agent Max Climb", &navMesh.Settings.AgentMaxClimb, 0.05f, 0.0f, 10.0f);
+                ImGui::DragFloat("Agent Max Slope", &navMesh.Settings.AgentMaxSlope, 1.0f, 0.0f, 90.0f);
+                ImGui::DragInt("Tile Size", &navMesh.Settings.TileSize, 1.0f, 16, 255);
+                ImGui::Checkbox("Dynamic Obstacles", &navMesh.Dynamic);
+                ImGui::TreePop();
+
+                if (shouldDelete) {
+                    mSelectedEntity.RemoveComponent<NavMeshComponent>();
+                }
+            }
+        }
+
+        // Nav Obstacle
+        if (mSelectedEntity.HasComponent<NavObstacleComponent>()) {
+            if (ImGui::TreeNodeEx(ICON_FA_BAN " Nav Obstacle Component", ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_DefaultOpen)) {
+                auto& obstacle = mSelectedEntity.GetComponent<NavObstacleComponent>();
+
+                bool shouldDelete = false;
+                ImGui::PushStyleColor(ImGuiCol_Button, (ImVec4)ImColor::HSV(7.0f, 0.6f, 0.6f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, (ImVec4)ImColor::HSV(7.0f, 0.7f, 0.7f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonActive, (ImVec4)ImColor::HSV(7.0f, 0.8f, 0.8f));
+                ImGui::PushStyleVar(ImGuiStyleVar_ButtonTextAlign, ImVec2(0.5f, 0.5f));
+                if (ImGui::Button(ICON_FA_TRASH " Delete", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+                    shouldDelete = true;
+                }
+                ImGui::PopStyleColor(3);
+                ImGui::PopStyleVar();
+                ImGui::Separator();
+
+                const char* shapes[] = { "Cylinder", "Box" };
+                ImGui::Combo("Shape", (int*)&obstacle.Shape, shapes, 2);
+                if (obstacle.Shape == NavObstacleShape::Box) {
+                    ImGui::DragFloat3("Half Extents", glm::value_ptr(obstacle.HalfExtents), 0.05f, 0.001f, 1000.0f);
+                } else {
+                    ImGui::DragFloat("Radius", &obstacle.Radius, 0.05f, 0.001f, 1000.0f);
+                    ImGui::DragFloat("Height", &obstacle.Height, 0.05f, 0.001f, 1000.0f);
+                }
+                ImGui::TreePop();
+
+                if (shouldDelete) {
+                    mSelectedEntity.RemoveComponent<NavObstacleComponent>();
+                }
+            }
+        }
+
+        // Nav Agent
+        if (mSelectedEntity.HasComponent<NavAgentComponent>()) {
+            if (ImGui::TreeNodeEx(ICON_FA_USERS " Nav Agent Component", ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_DefaultOpen)) {
+                auto& agent = mSelectedEntity.GetComponent<NavAgentComponent>();
+
+                bool shouldDelete = false;
+                ImGui::PushStyleColor(ImGuiCol_Button, (ImVec4)ImColor::HSV(7.0f, 0.6f, 0.6f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, (ImVec4)ImColor::HSV(7.0f, 0.7f, 0.7f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonActive, (ImVec4)ImColor::HSV(7.0f, 0.8f, 0.8f));
+                ImGui::PushStyleVar(ImGuiStyleVar_ButtonTextAlign, ImVec2(0.5f, 0.5f));
+                if (ImGui::Button(ICON_FA_TRASH " Delete", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+                    shouldDelete = true;
+                }
+                ImGui::PopStyleColor(3);
+                ImGui::PopStyleVar();
+                ImGui::Separator();
+
+                ImGui::DragFloat("Radius", &agent.Params.Radius, 0.05f, 0.05f, NavCrowd::MaxAgentRadius);
+                ImGui::DragFloat("Height", &agent.Params.Height, 0.05f, 0.1f, 10.0f);
+                ImGui::DragFloat("Max Speed", &agent.Params.MaxSpeed, 0.1f, 0.0f, 50.0f);
+                ImGui::DragFloat("Max Acceleration", &agent.Params.MaxAcceleration, 0.1f, 0.0f, 100.0f);
+                ImGui::Checkbox("Has Destination", &agent.HasDestination);
+                if (agent.HasDestination) {
+                    ImGui::DragFloat3("Destination", glm::value_ptr(agent.Destination), 0.1f);
+                    if (agent.DestinationUnreachable)
+                        ImGui::TextColored(ImVec4(1, 0, 0, 1), "Destination is off the navmesh");
+                }
+                ImGui::TreePop();
+
+                if (shouldDelete) {
+                    mSelectedEntity.RemoveComponent<NavAgentComponent>();
+                }
+            }
+        }
+
         ImGui::Separator();
 
         // Add component
@@ -752,6 +964,31 @@ void Editor::EntityEditor()
                     mSelectedEntity.AddComponent<AudioSourceComponent>();
                 }
             }
+            if (!mSelectedEntity.HasComponent<RigidBodyComponent>()) {
+                if (ImGui::MenuItem(ICON_FA_CUBES " Rigid Body Component")) {
+                    mSelectedEntity.AddComponent<RigidBodyComponent>();
+                }
+            }
+            if (!mSelectedEntity.HasComponent<ColliderComponent>()) {
+                if (ImGui::MenuItem(ICON_FA_SHIELD " Collider Component")) {
+                    mSelectedEntity.AddComponent<ColliderComponent>();
+                }
+            }
+            if (!mSelectedEntity.HasComponent<NavMeshComponent>()) {
+                if (ImGui::MenuItem(ICON_FA_MAP " Nav Mesh Component")) {
+                    mSelectedEntity.AddComponent<NavMeshComponent>();
+                }
+            }
+            if (!mSelectedEntity.HasComponent<NavObstacleComponent>()) {
+                if (ImGui::MenuItem(ICON_FA_BAN " Nav Obstacle Component")) {
+                    mSelectedEntity.AddComponent<NavObstacleComponent>();
+                }
+            }
+            if (!mSelectedEntity.HasComponent<NavAgentComponent>()) {
+                if (ImGui::MenuItem(ICON_FA_USERS " Nav Agent Component")) {
+                    mSelectedEntity.AddComponent<NavAgentComponent>();
+                }
+            }
             if (ImGui::MenuItem(ICON_FA_CODE " Script Component")) {
                 mSelectedEntity.GetComponent<ScriptComponent>().AddEmptyScript();
             }
@@ -933,16 +1170,19 @@ void Editor::LogWindow()
 
     ImGui::Begin(ICON_FA_TERMINAL " Log");
     if (ImGui::Button(ICON_FA_ERASER " Clear")) {
-        Logger::sEntries.clear();
+        Logger::Clear();
     }
     ImGui::SameLine();
     mLogFilter.Draw();
     const char* logChildName = "LogChild"; 
     ImGui::BeginChild(logChildName, ImVec2(0, 0), true, ImGuiWindowFlags_HorizontalScrollbar);
-    for (auto& entry : Logger::sEntries) {
-        if (mLogFilter.PassFilter(entry.Message.c_str()))
-            ImGui::TextColored(entry.Color, entry.Message.c_str());
-    }
+    Logger::ForEachEntry([&](const Logger::LogEntry& entry) {
+        if (!mLogFilter.PassFilter(entry.Message, entry.Message + entry.Length))
+            return;
+        ImGui::PushStyleColor(ImGuiCol_Text, entry.Color);
+        ImGui::TextUnformatted(entry.Message, entry.Message + entry.Length);
+        ImGui::PopStyleColor();
+    });
     ImGui::EndChild();
     ImGui::End();
 }
@@ -6,6 +6,9 @@
 #pragma once
 
 #include "Mnemen/AI/AISystem.hpp"
+#include "Mnemen/AI/NavCrowd.hpp"
+#include "Mnemen/AI/NavMeshBuilder.hpp"
+#include "Mnemen/AI/NavPathfinder.hpp"
 
 #include "Mnemen/Asset/AssetCacher.hpp"
 #include "Mnemen/Asset/AssetManager.hpp"
@@ -19,7 +22,11 @@
 #include "Mnemen/Core/Assert.hpp"
 #include "Mnemen/Core/Common.hpp"
 #include "Mnemen/Core/File.hpp"
+#include "Mnemen/Core/FrameStats.hpp"
+#include "Mnemen/Core/JobSystem.hpp"
 #include "Mnemen/Core/Logger.hpp"
+#include "Mnemen/Core/MemoryTracker.hpp"
+#include "Mnemen/Core/Metrics.hpp"
 #include "Mnemen/Core/Profiler.hpp"
 #include "Mnemen/Core/Random.hpp"
 #include "Mnemen/Core/Timer.hpp"
@@ -28,6 +35,10 @@
 
 #include "Mnemen/Input/Input.hpp"
 
+#include "Mnemen/Physics/PhysicsJobSystem.hpp"
+#include "Mnemen/Physics/PhysicsLayers.hpp"
+#include "Mnemen/Physics/PhysicsQuery.hpp"
+#include "Mnemen/Physics/PhysicsShapes.hpp"
 #include "Mnemen/Physics/PhysicsSystem.hpp"
 
 #include "Mnemen/Renderer/Renderer.hpp"
@@ -58,11 +69,16 @@
 #include "Mnemen/RHI/View.hpp"
 
 #include "Mnemen/Script/Script.hpp"
+#include "Mnemen/Script/ScriptAllocator.hpp"
 #include "Mnemen/Script/ScriptInstance.hpp"
+#include "Mnemen/Script/ScriptProfiler.hpp"
+#include "Mnemen/Script/ScriptScheduler.hpp"
 #include "Mnemen/Script/ScriptSystem.hpp"
+#include "Mnemen/Script/ScriptWorker.hpp"
 
 #include "Mnemen/Utility/Math.hpp"
 #include "Mnemen/Utility/PointCloud.hpp"
+#include "Mnemen/Utility/TimerWheel.hpp"
 #include "Mnemen/Utility/UUID.hpp"
 
 #include "Mnemen/World/Entity.hpp"
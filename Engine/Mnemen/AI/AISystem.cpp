@@ -5,8 +5,22 @@
 
 #include "AISystem.hpp"
 
+#include <Asset/AssetCacher.hpp>
 #include <Core/Logger.hpp>
 #include <Core/Profiler.hpp>
+#include <Core/Timer.hpp>
+
+#include <DetourCrowd.h>
+#include <DetourNavMesh.h>
+#include <DetourNavMeshQuery.h>
+#include <DetourTileCache.h>
+
+AISystem::Data AISystem::sData;
+
+static UInt64 TileKey(int x, int y, int layer)
+{
+    return ((UInt64)(UInt32)layer << 40) | ((UInt64)(UInt32)y << 20) | (UInt64)(UInt32)x;
+}
 
 void AISystem::Init()
 {
@@ -15,10 +29,335 @@ void AISystem::Init()
 
 void AISystem::Exit()
 {
+    UnloadNavMesh();
+}
+
+void AISystem::Awake(Ref<Scene> scene)
+{
+    PROFILE_FUNCTION();
+
+    entt::registry* registry = scene->GetRegistry();
+    auto view = registry->view<NavMeshComponent>();
+    for (auto [entity, navMesh] : view.each()) {
+        if (navMesh.MeshPath.empty())
+            continue;
+
+        UInt64 settingsHash = AssetCacher::Hash(&navMesh.Settings, sizeof(NavMeshSettings));
+        if (!sData.NavMesh || sData.LoadedPath != navMesh.MeshPath || sData.LoadedSettingsHash != settingsHash || sData.LoadedDynamic != navMesh.Dynamic)
+            LoadNavMesh(navMesh.MeshPath, navMesh.Settings, navMesh.Dynamic);
+        break;
+    }
+
+    if (!sData.NavMesh)
+        return;
+
+    // A partition per thread, agents join it on their first update.
+    sData.Crowd.Init(sData.NavMesh, JobSystem::GetWorkerCount() + 1, MaxAgents);
+    NavPathfinder::Init(sData.NavMesh);
+    registry->on_destroy<NavAgentComponent>().connect<&AISystem::OnNavAgentDestroyed>();
+}
+
+void AISystem::Quit(Ref<Scene> scene)
+{
+    PROFILE_FUNCTION();
+
+    scene->GetRegistry()->on_destroy<NavAgentComponent>().disconnect<&AISystem::OnNavAgentDestroyed>();
+    sData.Crowd.Shutdown();
+    NavPathfinder::Exit();
+
+    if (!sData.TileCache)
+        return;
+
+    if (sData.Rebuilding) {
+        JobSystem::Wait(&sData.RebuildCounter);
+        SwapRebuiltTiles();
+    }
+
+    // Give the navmesh back its level-only shape for the next play, a batch of requests at a time.
+    while (!sData.Obstacles.empty()) {
+        int requests = 0;
+        for (auto it = sData.Obstacles.begin(); it != sData.Obstacles.end() && requests < MaxObstacleRequests;) {
+            sData.TileCache->removeObstacle(it->second.Ref);
+            it = sData.Obstacles.erase(it);
+            requests++;
+        }
+        SnapshotStagingTiles(sData.StagingTiles);
+        RebuildTiles();
+        SwapRebuiltTiles();
+    }
+}
+
+void AISystem::Update(Ref<Scene> scene, float dt)
+{
+    PROFILE_FUNCTION();
+
+    // Obstacles can't be touched while the tile cache rebuilds, changes wait for the next update.
+    if (sData.Rebuilding && !JobSystem::IsBusy(&sData.RebuildCounter))
+        SwapRebuiltTiles();
+    if (sData.TileCache && !sData.Rebuilding && SyncObstacles(scene)) {
+        SnapshotStagingTiles(sData.StagingTiles);
+        sData.Rebuilding = true;
+        JobSystem::Execute([](UInt32) {
+            RebuildTiles();
+        }, &sData.RebuildCounter);
+    }
+
+    UpdateAgents(scene, dt);
+    NavPathfinder::Sync();
+}
+
+bool AISystem::LoadNavMesh(const String& meshPath, const NavMeshSettings& settings, bool dynamic)
+{
+    PROFILE_FUNCTION();
+
+    UnloadNavMesh();
+
+    Timer timer;
+    Vector<UInt8> bytes;
+    if (!AssetCacher::ReadNavMesh(meshPath, settings, dynamic, bytes))
+        return false;
+
+    if (dynamic) {
+        if (!NavMeshBuilder::LoadTileCache(bytes.data(), bytes.size(), &sData.TileCache, &sData.StagingNavMesh))
+            return false;
+
+        sData.NavMesh = dtAllocNavMesh();
+        if (dtStatusFailed(sData.NavMesh->init(sData.StagingNavMesh->getParams()))) {
+            LOG_ERROR("Failed to initialize navmesh");
+            UnloadNavMesh();
+            return false;
+        }
+
+        const dtNavMesh* staging = sData.StagingNavMesh;
+        for (int i = 0; i < staging->getMaxTiles(); i++) {
+            const dtMeshTile* tile = staging->getTile(i);
+            if (tile->header)
+                NavMeshBuilder::CopyTile(staging, sData.NavMesh, tile->header->x, tile->header->y, tile->header->layer);
+        }
+    } else {
+        sData.NavMesh = NavMeshBuilder::Load(bytes.data(), bytes.size());
+        if (!sData.NavMesh)
+            return false;
+    }
+
+    sData.Query = dtAllocNavMeshQuery();
+    if (dtStatusFailed(sData.Query->init(sData.NavMesh, MaxQueryNodes))) {
+        LOG_ERROR("Failed to initialize navmesh query");
+        UnloadNavMesh();
+        return false;
+    }
+
+    sData.LoadedPath = meshPath;
+    sData.LoadedSettingsHash = AssetCacher::Hash(&settings, sizeof(NavMeshSettings));
+    sData.LoadedDynamic = dynamic;
+    LOG_INFO("Loaded {0} navmesh of {1} in {2}ms", dynamic ? "dynamic" : "static", meshPath, timer.GetElapsed());
+    return true;
+}
+
+void AISystem::UnloadNavMesh()
+{
+    if (sData.Rebuilding) {
+        JobSystem::Wait(&sData.RebuildCounter);
+        sData.Rebuilding = false;
+    }
+
+    // The crowd and the pathfinder walk on the navmesh, they can't outlive it.
+    sData.Crowd.Shutdown();
+    NavPathfinder::Exit();
+    dtFreeNavMeshQuery(sData.Query);
+    dtFreeNavMesh(sData.NavMesh);
+    dtFreeTileCache(sData.TileCache);
+    dtFreeNavMesh(sData.StagingNavMesh);
+    sData.Query = nullptr;
+    sData.NavMesh = nullptr;
+    sData.TileCache = nullptr;
+    sData.StagingNavMesh = nullptr;
+    sData.StagingTiles.clear();
+    sData.Obstacles.clear();
+    sData.LoadedPath = "";
+    sData.LoadedSettingsHash = 0;
+    sData.LoadedDynamic = false;
+}
+
+void AISystem::UpdateAgents(Ref<Scene> scene, float dt)
+{
+    PROFILE_FUNCTION();
+
+    if (!sData.Crowd.IsValid())
+        return;
+
+    entt::registry* registry = scene->GetRegistry();
+    auto view = registry->view<TransformComponent, NavAgentComponent>();
+    for (auto [entity, transform, agent] : view.each()) {
+        UInt32 id = (UInt32)entity;
+        if (!sData.Crowd.HasAgent(id)) {
+            if (!sData.Crowd.AddAgent(id, transform.Position, agent.Params))
+                continue;
+            agent.DestinationChanged = agent.HasDestination;
+        }
+        if (!agent.DestinationChanged)
+            continue;
+
+        if (agent.HasDestination) {
+            // A destination off the navmesh (or on a tile that isn't loaded yet) stays pending and is retried.
+            bool accepted = sData.Crowd.SetTarget(id, agent.Destination);
+            if (!accepted && !agent.DestinationUnreachable)
+                LOG_WARN("Nav agent {0} can't reach ({1}, {2}, {3}), it is off the navmesh", id, agent.Destination.x, agent.Destination.y, agent.Destination.z);
+            agent.DestinationUnreachable = !accepted;
+            if (!accepted)
+                continue;
+        } else {
+            sData.Crowd.ResetTarget(id);
+        }
+        agent.DestinationChanged = false;
+    }
 
+    // Each partition writes its own agents back, no two jobs touch the same transform.
+    sData.Crowd.Update(dt, [registry](UInt32 partition) {
+        sData.Crowd.ForEachAgent(partition, [registry](UInt32 id, const dtCrowdAgent* agent) {
+            TransformComponent& transform = registry->get<TransformComponent>((entt::entity)id);
+            transform.Position = glm::vec3(agent->npos[0], agent->npos[1], agent->npos[2]);
+            if (agent->vel[0] * agent->vel[0] + agent->vel[2] * agent->vel[2] > 0.01f)
+                transform.Rotation = glm::angleAxis(glm::atan(agent->vel[0], agent->vel[2]), glm::vec3(0.0f, 1.0f, 0.0f));
+        });
+    });
 }
 
-void AISystem::Update(Ref<Scene> scene)
+void AISystem::OnNavAgentDestroyed(entt::registry& registry, entt::entity entity)
+{
+    sData.Crowd.RemoveAgent((UInt32)entity);
+}
+
+bool AISystem::SyncObstacles(Ref<Scene> scene)
 {
     PROFILE_FUNCTION();
+
+    for (auto& [entity, tracked] : sData.Obstacles)
+        tracked.Seen = false;
+
+    // Whatever doesn't fit in this batch is still out of sync next update and goes in the next one.
+    int requests = 0;
+    auto view = scene->GetRegistry()->view<TransformComponent, NavObstacleComponent>();
+    for (auto [entity, transform, obstacle] : view.each()) {
+        TrackedObstacle current = {};
+        current.Shape = obstacle.Shape;
+        current.Position = transform.Position;
+        current.Seen = true;
+        if (obstacle.Shape == NavObstacleShape::Box) {
+            glm::vec3 forward = transform.Rotation * glm::vec3(0.0f, 0.0f, 1.0f);
+            current.Size = obstacle.HalfExtents * transform.Scale;
+            current.Yaw = glm::atan(forward.x, forward.z);
+        } else {
+            current.Size = glm::vec3(obstacle.Radius * glm::max(transform.Scale.x, transform.Scale.z), obstacle.Height * transform.Scale.y, 0.0f);
+            current.Yaw = 0.0f;
+        }
+
+        auto it = sData.Obstacles.find(entity);
+        if (it != sData.Obstacles.end()) {
+            TrackedObstacle& tracked = it->second;
+            tracked.Seen = true;
+            bool moved = glm::distance(tracked.Position, current.Position) > ObstacleMoveThreshold
+                      || glm::distance(tracked.Size, current.Size) > ObstacleMoveThreshold
+                      || glm::abs(tracked.Yaw - current.Yaw) > glm::radians(1.0f)
+                      || tracked.Shape != current.Shape;
+            if (!moved || requests + 2 > MaxObstacleRequests)
+                continue;
+            sData.TileCache->removeObstacle(tracked.Ref);
+            sData.Obstacles.erase(it);
+            requests++;
+        } else if (requests + 1 > MaxObstacleRequests) {
+            continue;
+        }
+
+        dtObstacleRef ref = 0;
+        dtStatus status;
+        if (current.Shape == NavObstacleShape::Box) {
+            status = sData.TileCache->addBoxObstacle(&current.Position.x, &current.Size.x, current.Yaw, &ref);
+        } else {
+            glm::vec3 base = current.Position - glm::vec3(0.0f, current.Size.y * 0.5f, 0.0f);
+            status = sData.TileCache->addObstacle(&base.x, current.Size.x, current.Size.y, &ref);
+        }
+        requests++;
+
+        // A full obstacle pool just leaves the entity out, it's tried again next update.
+        if (dtStatusSucceed(status)) {
+            current.Ref = ref;
+            sData.Obstacles[entity] = current;
+        }
+    }
+
+    for (auto it = sData.Obstacles.begin(); it != sData.Obstacles.end();) {
+        if (it->second.Seen || requests >= MaxObstacleRequests) {
+            ++it;
+            continue;
+        }
+        sData.TileCache->removeObstacle(it->second.Ref);
+        it = sData.Obstacles.erase(it);
+        requests++;
+    }
+
+    return requests > 0;
+}
+
+void AISystem::RebuildTiles()
+{
+    Timer timer;
+
+    // Each update rebuilds a bounded number of tiles, loop until every touched tile is done.
+    bool upToDate = false;
+    while (!upToDate) {
+        if (dtStatusFailed(sData.TileCache->update(0.0f, sData.StagingNavMesh, &upToDate)))
+            break;
+    }
+
+    sData.RebuildMs = timer.GetElapsed();
+}
+
+void AISystem::SwapRebuiltTiles()
+{
+    PROFILE_FUNCTION();
+
+    sData.Rebuilding = false;
+
+    // Searches in flight read the navmesh, and cached paths may cross the tiles about to change.
+    NavPathfinder::WaitIdle();
+
+    UnorderedMap<UInt64, UInt64> rebuilt;
+    SnapshotStagingTiles(rebuilt);
+
+    UInt32 swapped = 0;
+    for (auto& [key, ref] : rebuilt) {
+        auto it = sData.StagingTiles.find(key);
+        if (it != sData.StagingTiles.end() && it->second == ref)
+            continue;
+        const dtMeshTile* tile = sData.StagingNavMesh->getTileByRef((dtTileRef)ref);
+        NavMeshBuilder::CopyTile(sData.StagingNavMesh, sData.NavMesh, tile->header->x, tile->header->y, tile->header->layer);
+        swapped++;
+    }
+
+    // Tiles an obstacle covers entirely have no polygons left and are gone from the staging navmesh.
+    for (auto& [key, ref] : sData.StagingTiles) {
+        if (rebuilt.count(key))
+            continue;
+        NavMeshBuilder::CopyTile(sData.StagingNavMesh, sData.NavMesh, (int)(key & 0xFFFFF), (int)((key >> 20) & 0xFFFFF), (int)(key >> 40));
+        swapped++;
+    }
+
+    if (swapped > 0) {
+        NavPathfinder::InvalidateCache();
+        LOG_DEBUG("Rebuilt {0} navmesh tiles in {1}ms", swapped, sData.RebuildMs);
+    }
+}
+
+void AISystem::SnapshotStagingTiles(UnorderedMap<UInt64, UInt64>& tiles)
+{
+    tiles.clear();
+
+    const dtNavMesh* staging = sData.StagingNavMesh;
+    for (int i = 0; i < staging->getMaxTiles(); i++) {
+        const dtMeshTile* tile = staging->getTile(i);
+        if (!tile->header)
+            continue;
+        tiles[TileKey(tile->header->x, tile->header->y, tile->header->layer)] = staging->getTileRef(tile);
+    }
 }
@@ -7,6 +7,14 @@
 
 #include "World/Scene.hpp"
 
+#include <Core/JobSystem.hpp>
+#include <AI/NavCrowd.hpp>
+#include <AI/NavPathfinder.hpp>
+
+class dtNavMesh;
+class dtNavMeshQuery;
+class dtTileCache;
+
 /// @class AISystem
 /// @brief A system responsible for AI-related processing.
 ///
@@ -21,8 +29,111 @@ public:
     /// @brief Shuts down the AI system.
     static void Exit();
 
+    /// @brief Loads the navmesh of the scene's NavMeshComponent and creates the crowd and the pathfinder, when the scene starts playing.
+    ///
+    /// The navmesh stays loaded between plays as long as its mesh and settings don't change.
+    /// @param scene The scene that starts playing.
+    static void Awake(Ref<Scene> scene);
+
+    /// @brief Removes the scene's obstacles from the navmesh and destroys the crowd and the pending path requests, when the scene stops playing.
+    /// @param scene The scene that stops playing.
+    static void Quit(Ref<Scene> scene);
+
     /// @brief Updates the AI system for the given scene.
-    /// 
+    ///
+    /// On a dynamic navmesh, obstacles that spawned, moved or disappeared are pushed to the tile cache and the
+    /// tiles they touch are rebuilt on a worker. The rebuilt tiles are swapped into the navmesh on a later
+    /// update, so queries never see a half-built tile.
+    ///
+    /// Then NavAgentComponents join the crowd, new destinations are requested, the crowd partitions are
+    /// stepped in parallel and every partition writes its agents back to their transforms from its own job.
+    ///
+    /// Last comes the pathfinder's sync point: finished path requests are called back and the next frame of
+    /// searches starts in the background, until the next update.
     /// @param scene The scene to update AI components in.
-    static void Update(Ref<Scene> scene);
+    /// @param dt The frame time in seconds.
+    static void Update(Ref<Scene> scene, float dt);
+
+    /// @brief Loads the navmesh of a mesh, from the asset cache or by building it.
+    /// @param meshPath The mesh file to build from.
+    /// @param settings The build parameters.
+    /// @param dynamic Whether to load a tile cache, so obstacles can carve the navmesh.
+    /// @return False if the navmesh couldn't be built.
+    static bool LoadNavMesh(const String& meshPath, const NavMeshSettings& settings, bool dynamic = false);
+
+    /// @brief Unloads the current navmesh.
+    static void UnloadNavMesh();
+
+    /// @brief Gets the loaded navmesh, null if there is none.
+    static dtNavMesh* GetNavMesh() { return sData.NavMesh; }
+
+    /// @brief Gets the query object of the loaded navmesh. Main thread only.
+    static dtNavMeshQuery* GetNavMeshQuery() { return sData.Query; }
+
+    /// @brief Gets the crowd of the playing scene.
+    static NavCrowd& GetCrowd() { return sData.Crowd; }
+
+    /// @brief Maximum number of search nodes of the main thread query.
+    static constexpr int MaxQueryNodes = 2048;
+
+    /// @brief Maximum number of obstacle additions and removals pushed to the tile cache per rebuild. Detour queues at most 64.
+    static constexpr int MaxObstacleRequests = 64;
+
+    /// @brief How far an obstacle has to move, in world units, before its tiles are rebuilt.
+    static constexpr float ObstacleMoveThreshold = 0.1f;
+
+    /// @brief Maximum number of agents in the crowd.
+    static constexpr UInt32 MaxAgents = 16384;
+
+private:
+    /// @brief The state of an obstacle as last pushed to the tile cache.
+    struct TrackedObstacle
+    {
+        UInt32 Ref = 0;
+        NavObstacleShape Shape;
+        glm::vec3 Position;
+        glm::vec3 Size;
+        float Yaw;
+        bool Seen;
+    };
+
+    /// @brief Adds new agents to the crowd, forwards destination changes, steps the crowd and writes the agents back.
+    static void UpdateAgents(Ref<Scene> scene, float dt);
+
+    /// @brief Removes the agent of an entity from the crowd when its component goes away.
+    static void OnNavAgentDestroyed(entt::registry& registry, entt::entity entity);
+
+    /// @brief Pushes the obstacle changes since the last call to the tile cache.
+    /// @return True if the tile cache has tiles to rebuild.
+    static bool SyncObstacles(Ref<Scene> scene);
+
+    /// @brief Rebuilds the dirty tiles into the staging navmesh. Runs on a worker.
+    static void RebuildTiles();
+
+    /// @brief Copies the tiles the last rebuild changed from the staging navmesh into the navmesh.
+    static void SwapRebuiltTiles();
+
+    /// @brief Records the tile refs of the staging navmesh, to find the rebuilt tiles afterwards.
+    static void SnapshotStagingTiles(UnorderedMap<UInt64, UInt64>& tiles);
+
+    static struct Data {
+        dtNavMesh* NavMesh = nullptr;
+        dtNavMeshQuery* Query = nullptr;
+
+        // Dynamic navmeshes: the tile cache rebuilds into the staging navmesh, only ever touched by the rebuild job
+        // while it runs, and the changed tiles are then copied into NavMesh on the main thread.
+        dtTileCache* TileCache = nullptr;
+        dtNavMesh* StagingNavMesh = nullptr;
+        JobSystem::Counter RebuildCounter;
+        bool Rebuilding = false;
+        float RebuildMs = 0.0f;
+        UnorderedMap<UInt64, UInt64> StagingTiles;
+        UnorderedMap<entt::entity, TrackedObstacle> Obstacles;
+
+        NavCrowd Crowd;
+
+        String LoadedPath = "";
+        UInt64 LoadedSettingsHash = 0;
+        bool LoadedDynamic = false;
+    } sData;
 };
@@ -0,0 +1,298 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-28 15:31:02
+//
+
+#include "NavCrowd.hpp"
+#include "NavMeshBuilder.hpp"
+
+#include <Core/Logger.hpp>
+#include <Core/Profiler.hpp>
+#include <Core/JobSystem.hpp>
+#include <Core/Timer.hpp>
+
+#include <DetourCommon.h>
+#include <DetourCrowd.h>
+#include <DetourNavMesh.h>
+#include <DetourNavMeshQuery.h>
+
+NavCrowd::~NavCrowd()
+{
+    Shutdown();
+}
+
+bool NavCrowd::Init(dtNavMesh* navMesh, UInt32 partitionCount, UInt32 maxAgents)
+{
+    Shutdown();
+
+    mNavMesh = navMesh;
+    mMaxAgentsPerPartition = (maxAgents + partitionCount - 1) / partitionCount;
+    mPartitions.resize(partitionCount);
+    for (Partition& partition : mPartitions) {
+        partition.Crowd = dtAllocCrowd();
+        if (!partition.Crowd || !partition.Crowd->init((int)mMaxAgentsPerPartition, MaxAgentRadius, navMesh)) {
+            LOG_ERROR("Failed to initialize crowd partition");
+            Shutdown();
+            return false;
+        }
+        partition.Ids.resize(mMaxAgentsPerPartition, 0);
+
+        // The cheapest avoidance sampling, it's what keeps thousands of agents affordable.
+        dtObstacleAvoidanceParams avoidance;
+        memcpy(&avoidance, partition.Crowd->getObstacleAvoidanceParams(0), sizeof(dtObstacleAvoidanceParams));
+        avoidance.velBias = 0.5f;
+        avoidance.adaptiveDivs = 5;
+        avoidance.adaptiveRings = 2;
+        avoidance.adaptiveDepth = 1;
+        partition.Crowd->setObstacleAvoidanceParams(0, &avoidance);
+    }
+    return true;
+}
+
+void NavCrowd::Shutdown()
+{
+    for (Partition& partition : mPartitions)
+        dtFreeCrowd(partition.Crowd);
+    mPartitions.clear();
+    mAgents.clear();
+    mNavMesh = nullptr;
+}
+
+bool NavCrowd::AddAgent(UInt32 id, const glm::vec3& position, const NavAgentParams& params)
+{
+    if (!IsValid())
+        return false;
+    RemoveAgent(id);
+
+    dtCrowdAgentParams agentParams = {};
+    agentParams.radius = glm::min(params.Radius, MaxAgentRadius);
+    agentParams.height = params.Height;
+    agentParams.maxAcceleration = params.MaxAcceleration;
+    agentParams.maxSpeed = params.MaxSpeed;
+    agentParams.collisionQueryRange = agentParams.radius * 12.0f;
+    agentParams.pathOptimizationRange = agentParams.radius * 30.0f;
+    agentParams.separationWeight = 2.0f;
+    agentParams.updateFlags = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OPTIMIZE_TOPO | DT_CROWD_OBSTACLE_AVOIDANCE | DT_CROWD_SEPARATION;
+    agentParams.obstacleAvoidanceType = 0;
+    agentParams.queryFilterType = 0;
+
+    // The region's partition if it has room, the emptiest one otherwise.
+    UInt32 partition = GetPartitionAt(position);
+    if (mPartitions[partition].AgentCount >= mMaxAgentsPerPartition) {
+        for (UInt32 i = 0; i < mPartitions.size(); i++) {
+            if (mPartitions[i].AgentCount < mPartitions[partition].AgentCount)
+                partition = i;
+        }
+    }
+    return AddToPartition(partition, id, &position.x, agentParams) >= 0;
+}
+
+void NavCrowd::RemoveAgent(UInt32 id)
+{
+    auto it = mAgents.find(id);
+    if (it == mAgents.end())
+        return;
+
+    Partition& partition = mPartitions[it->second.Partition];
+    partition.Crowd->removeAgent(it->second.Index);
+    partition.AgentCount--;
+    mAgents.erase(it);
+}
+
+bool NavCrowd::SetTarget(UInt32 id, const glm::vec3& target)
+{
+    auto it = mAgents.find(id);
+    if (it == mAgents.end())
+        return false;
+
+    dtCrowd* crowd = mPartitions[it->second.Partition].Crowd;
+    dtPolyRef ref = 0;
+    float nearest[3];
+    crowd->getNavMeshQuery()->findNearestPoly(&target.x, crowd->getQueryHalfExtents(), crowd->getFilter(0), &ref, nearest);
+    if (!ref)
+        return false;
+    return crowd->requestMoveTarget(it->second.Index, ref, nearest);
+}
+
+void NavCrowd::ResetTarget(UInt32 id)
+{
+    auto it = mAgents.find(id);
+    if (it != mAgents.end())
+        mPartitions[it->second.Partition].Crowd->resetMoveTarget(it->second.Index);
+}
+
+void NavCrowd::Update(float dt, const PartitionCallback& onUpdated)
+{
+    PROFILE_FUNCTION();
+
+    if (!IsValid())
+        return;
+
+    // Partitions only read the navmesh, each crowd has its own query and path queue.
+    auto updatePartition = [&](UInt32 index) {
+        Partition& partition = mPartitions[index];
+        if (partition.AgentCount > 0)
+            partition.Crowd->update(dt, nullptr);
+        if (onUpdated)
+            onUpdated(index);
+    };
+
+    if (mPartitions.size() == 1 || JobSystem::GetCurrentWorker() >= 0 || JobSystem::GetWorkerCount() == 0) {
+        for (UInt32 i = 0; i < mPartitions.size(); i++)
+            updatePartition(i);
+    } else {
+        JobSystem::Counter counter;
+        JobSystem::Dispatch((UInt32)mPartitions.size(), [&](UInt32 jobIndex, UInt32) { updatePartition(jobIndex); }, &counter);
+        JobSystem::Wait(&counter);
+    }
+
+    MigrateAgents();
+}
+
+void NavCrowd::ForEachAgent(UInt32 partition, const std::function<void(UInt32 id, const dtCrowdAgent* agent)>& function) const
+{
+    const Partition& p = mPartitions[partition];
+    if (p.AgentCount == 0)
+        return;
+
+    for (int i = 0; i < p.Crowd->getAgentCount(); i++) {
+        const dtCrowdAgent* agent = p.Crowd->getAgent(i);
+        if (agent->active)
+            function(p.Ids[i], agent);
+    }
+}
+
+UInt32 NavCrowd::GetPartitionAt(const glm::vec3& position) const
+{
+    int x = (int)glm::floor(position.x / RegionSize);
+    int z = (int)glm::floor(position.z / RegionSize);
+    UInt32 hash = ((UInt32)x * 73856093u) ^ ((UInt32)z * 19349663u);
+    return hash % (UInt32)mPartitions.size();
+}
+
+int NavCrowd::AddToPartition(UInt32 index, UInt32 id, const float* position, const dtCrowdAgentParams& params)
+{
+    Partition& partition = mPartitions[index];
+    if (partition.AgentCount >= mMaxAgentsPerPartition)
+        return -1;
+
+    int agentIndex = partition.Crowd->addAgent(position, &params);
+    if (agentIndex < 0)
+        return -1;
+
+    // Detour keeps agents that spawn off the navmesh, as invalid ones that never move.
+    if (partition.Crowd->getAgent(agentIndex)->state == DT_CROWDAGENT_STATE_INVALID) {
+        partition.Crowd->removeAgent(agentIndex);
+        return -1;
+    }
+
+    partition.Ids[agentIndex] = id;
+    partition.AgentCount++;
+    mAgents[id] = { index, agentIndex };
+    return agentIndex;
+}
+
+void NavCrowd::MigrateAgents()
+{
+    PROFILE_FUNCTION();
+
+    if (mPartitions.size() == 1)
+        return;
+
+    for (UInt32 from = 0; from < mPartitions.size(); from++) {
+        Partition& partition = mPartitions[from];
+        if (partition.AgentCount == 0)
+            continue;
+
+        for (int i = 0; i < partition.Crowd->getAgentCount(); i++) {
+            const dtCrowdAgent* agent = partition.Crowd->getAgent(i);
+            if (!agent->active || agent->state != DT_CROWDAGENT_STATE_WALKING)
+                continue;
+
+            UInt32 to = GetPartitionAt(glm::vec3(agent->npos[0], agent->npos[1], agent->npos[2]));
+            if (to == from || mPartitions[to].AgentCount >= mMaxAgentsPerPartition)
+                continue;
+
+            // Carry the agent over with its target and velocity, the new crowd plans its path again.
+            UInt32 id = partition.Ids[i];
+            dtCrowdAgentParams params = agent->params;
+            bool hasTarget = agent->targetState != DT_CROWDAGENT_TARGET_NONE && agent->targetState != DT_CROWDAGENT_TARGET_FAILED;
+            dtPolyRef targetRef = agent->targetRef;
+            float position[3], velocity[3], targetPosition[3];
+            dtVcopy(position, agent->npos);
+            dtVcopy(velocity, agent->vel);
+            dtVcopy(targetPosition, agent->targetPos);
+
+            partition.Crowd->removeAgent(i);
+            partition.AgentCount--;
+            mAgents.erase(id);
+
+            UInt32 owner = to;
+            int index = AddToPartition(to, id, position, params);
+            if (index < 0) {
+                owner = from;
+                index = AddToPartition(from, id, position, params);
+            }
+            if (index < 0)
+                continue;
+
+            dtCrowd* crowd = mPartitions[owner].Crowd;
+            dtCrowdAgent* moved = crowd->getEditableAgent(index);
+            dtVcopy(moved->vel, velocity);
+            dtVcopy(moved->nvel, velocity);
+            dtVcopy(moved->dvel, velocity);
+            if (hasTarget && targetRef)
+                crowd->requestMoveTarget(index, targetRef, targetPosition);
+        }
+    }
+}
+
+void NavCrowd::RunBenchmark(const String& meshPath, UInt32 frameCount)
+{
+    const float frameDuration = 1.0f / 60.0f;
+    const UInt32 partitionCount = JobSystem::GetWorkerCount() + 1;
+    const UInt32 agentCounts[] = { 1000, 5000, 10000 };
+
+    LOG_INFO("[CROWD BENCHMARK] {0}, {1} frames, {2} partitions", meshPath, frameCount, partitionCount);
+
+    PointCloud cloud(meshPath);
+    Vector<UInt8> bytes;
+    if (!NavMeshBuilder::Build(cloud, NavMeshSettings(), bytes))
+        return;
+    dtNavMesh* navMesh = NavMeshBuilder::Load(bytes.data(), bytes.size());
+    if (!navMesh)
+        return;
+
+    dtNavMeshQuery* query = dtAllocNavMeshQuery();
+    query->init(navMesh, 2048);
+    dtQueryFilter filter;
+
+    for (UInt32 agentCount : agentCounts) {
+        NavCrowd crowd;
+        if (!crowd.Init(navMesh, partitionCount, agentCount))
+            break;
+
+        for (UInt32 i = 0; i < agentCount; i++) {
+            dtPolyRef ref = 0;
+            glm::vec3 spawn, target;
+            query->findRandomPoint(&filter, NavMeshBuilder::BenchmarkRandom, &ref, &spawn.x);
+            query->findRandomPoint(&filter, NavMeshBuilder::BenchmarkRandom, &ref, &target.x);
+            if (crowd.AddAgent(i, spawn, NavAgentParams()))
+                crowd.SetTarget(i, target);
+        }
+
+        float totalMs = 0.0f;
+        float maxMs = 0.0f;
+        for (UInt32 frame = 0; frame < frameCount; frame++) {
+            Timer timer;
+            crowd.Update(frameDuration);
+            float elapsed = timer.GetElapsed();
+            totalMs += elapsed;
+            maxMs = glm::max(maxMs, elapsed);
+        }
+        LOG_INFO("[CROWD BENCHMARK] {0} agents: {1}ms average, {2}ms worst frame", crowd.GetAgentCount(), totalMs / frameCount, maxMs);
+    }
+
+    dtFreeNavMeshQuery(query);
+    dtFreeNavMesh(navMesh);
+}
@@ -0,0 +1,127 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-28 15:06:51
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+
+#include <glm/glm.hpp>
+
+#include <functional>
+
+class dtNavMesh;
+class dtCrowd;
+struct dtCrowdAgent;
+struct dtCrowdAgentParams;
+
+/// @brief Movement parameters of a crowd agent.
+struct NavAgentParams
+{
+    float Radius = 0.6f; ///< Radius of the agent, for avoidance.
+    float Height = 2.0f; ///< Height of the agent.
+    float MaxSpeed = 3.5f; ///< Maximum speed in units per second.
+    float MaxAcceleration = 8.0f; ///< Maximum acceleration in units per second squared.
+};
+
+/// @brief A crowd of agents steering on a navmesh, split in several Detour crowds updated in parallel.
+///
+/// A single dtCrowd is updated on one thread and its cost grows with the agent count, so agents are
+/// spread over partitions by hashing the region of the level they're in. Each partition is a dtCrowd with
+/// its own navmesh query and path queue: path requests are batched per partition and run as sliced
+/// queries over as many frames as they need. Agents only avoid agents of their own partition, and move to
+/// another one when they walk into a region hashed to it.
+class NavCrowd
+{
+public:
+    /// @brief Called from the job of a partition once it's updated, with its index.
+    using PartitionCallback = std::function<void(UInt32 partition)>;
+
+    /// @brief Size of the regions hashed to partitions, in world units.
+    static constexpr float RegionSize = 32.0f;
+
+    /// @brief The largest agent radius a crowd supports.
+    static constexpr float MaxAgentRadius = 2.0f;
+
+    NavCrowd() = default;
+    ~NavCrowd();
+
+    /// @brief Creates the partitions.
+    /// @param navMesh The navmesh the agents walk on. It has to outlive the crowd.
+    /// @param partitionCount The number of partitions, usually the number of threads.
+    /// @param maxAgents The maximum number of agents over every partition.
+    /// @return False if a partition couldn't be created.
+    bool Init(dtNavMesh* navMesh, UInt32 partitionCount, UInt32 maxAgents);
+
+    /// @brief Destroys every partition and agent.
+    void Shutdown();
+
+    /// @brief Returns whether or not the crowd is initialized.
+    bool IsValid() const { return !mPartitions.empty(); }
+
+    /// @brief Adds an agent at the point of the navmesh closest to the given position.
+    /// @param id A unique identifier for the agent, the entity for instance.
+    /// @param position Where to spawn the agent.
+    /// @param params The movement parameters of the agent.
+    /// @return False if the crowd is full or the position is too far from the navmesh.
+    bool AddAgent(UInt32 id, const glm::vec3& position, const NavAgentParams& params);
+
+    /// @brief Removes an agent.
+    void RemoveAgent(UInt32 id);
+
+    /// @brief Returns whether or not an agent is in the crowd.
+    bool HasAgent(UInt32 id) const { return mAgents.count(id) > 0; }
+
+    /// @brief Sends an agent towards the point of the navmesh closest to the target. The path is found over the next frames.
+    /// @return False if the agent doesn't exist or the target is too far from the navmesh.
+    bool SetTarget(UInt32 id, const glm::vec3& target);
+
+    /// @brief Stops an agent.
+    void ResetTarget(UInt32 id);
+
+    /// @brief Steps every partition in parallel, then moves the agents that changed region to their new partition.
+    /// @param dt The time step in seconds.
+    /// @param onUpdated Optional callback run in each partition's job after its update, to read its agents back.
+    void Update(float dt, const PartitionCallback& onUpdated = nullptr);
+
+    /// @brief Returns the number of partitions.
+    UInt32 GetPartitionCount() const { return (UInt32)mPartitions.size(); }
+
+    /// @brief Returns the number of agents over every partition.
+    UInt32 GetAgentCount() const { return (UInt32)mAgents.size(); }
+
+    /// @brief Calls a function for every active agent of a partition. Safe to call from the partition's callback.
+    /// @param partition The partition index.
+    /// @param function Called with the id and the Detour state of each agent.
+    void ForEachAgent(UInt32 partition, const std::function<void(UInt32 id, const dtCrowdAgent* agent)>& function) const;
+
+    /// @brief Spawns crowds of 1k, 5k and 10k agents with random targets on the navmesh of a mesh and logs the ms per frame of each.
+    /// @param meshPath The mesh to build the navmesh from.
+    /// @param frameCount The number of frames to simulate per crowd.
+    static void RunBenchmark(const String& meshPath, UInt32 frameCount = 300);
+private:
+    /// @brief Where an agent lives.
+    struct Slot
+    {
+        UInt32 Partition;
+        int Index;
+    };
+
+    /// @brief A Detour crowd and the ids of its agents, by agent index.
+    struct Partition
+    {
+        dtCrowd* Crowd = nullptr;
+        Vector<UInt32> Ids;
+        UInt32 AgentCount = 0;
+    };
+
+    UInt32 GetPartitionAt(const glm::vec3& position) const;
+    int AddToPartition(UInt32 partition, UInt32 id, const float* position, const dtCrowdAgentParams& params);
+    void MigrateAgents();
+
+    dtNavMesh* mNavMesh = nullptr;
+    UInt32 mMaxAgentsPerPartition = 0;
+    Vector<Partition> mPartitions;
+    UnorderedMap<UInt32, Slot> mAgents;
+};
@@ -0,0 +1,731 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-27 10:34:20
+//
+
+#include "NavMeshBuilder.hpp"
+
+#include <Core/Logger.hpp>
+#include <Core/Profiler.hpp>
+#include <Core/JobSystem.hpp>
+#include <Core/Timer.hpp>
+
+#include <Recast.h>
+#include <DetourAlloc.h>
+#include <DetourNavMesh.h>
+#include <DetourNavMeshBuilder.h>
+#include <DetourTileCache.h>
+#include <DetourTileCacheBuilder.h>
+
+#include <glm/glm.hpp>
+
+#include <cfloat>
+#include <random>
+
+/// @brief Prefix of a serialized navmesh, followed by TileCount pairs of (UInt32 size, tile data).
+struct NavMeshBlobHeader
+{
+    UInt32 Magic; ///< NavMeshMagic.
+    UInt32 Version; ///< NavMeshBuilder::FormatVersion.
+    UInt32 TileCount; ///< Number of tiles (or compressed layers, for a tile cache) that follow.
+    UInt32 TileCache; ///< Whether the tiles are compressed tile cache layers rather than Detour tiles.
+    dtNavMeshParams Params; ///< The parameters to initialize the dtNavMesh with.
+    dtTileCacheParams CacheParams; ///< The parameters to initialize the dtTileCache with, if any.
+};
+
+constexpr UInt32 NavMeshMagic = 'M' | ('N' << 8) | ('A' << 16) | ('V' << 24);
+
+// Every polygon of the navmesh is walkable ground for now, queries filter on this flag.
+constexpr unsigned short NavPolyWalk = 0x01;
+
+// Tile cache layers are slices of a tile stacked on top of each other (floors, bridges...).
+constexpr int ExpectedLayersPerTile = 4;
+constexpr int MaxLayersPerTile = 32;
+
+/// @brief Run length encoding of the tile cache layers.
+///
+/// Layers are mostly long runs of identical heights and areas, which this catches well enough
+/// without pulling in a compression library. A control byte below 128 is followed by that many
+/// plus one literal bytes, anything above is a run of (control - 126) copies of the next byte.
+class NavMeshCompressor : public dtTileCacheCompressor
+{
+public:
+    virtual int maxCompressedSize(const int bufferSize) override
+    {
+        return bufferSize + (bufferSize + 127) / 128 + 1;
+    }
+
+    virtual dtStatus compress(const unsigned char* buffer, const int bufferSize, unsigned char* compressed, const int maxCompressedSize, int* compressedSize) override
+    {
+        int out = 0;
+        int i = 0;
+        while (i < bufferSize) {
+            int run = 1;
+            while (i + run < bufferSize && run < 129 && buffer[i + run] == buffer[i])
+                run++;
+
+            if (run >= 2) {
+                if (out + 2 > maxCompressedSize)
+                    return DT_FAILURE | DT_BUFFER_TOO_SMALL;
+                compressed[out++] = (unsigned char)(run + 126);
+                compressed[out++] = buffer[i];
+                i += run;
+                continue;
+            }
+
+            int start = i;
+            int literals = 0;
+            while (i < bufferSize && literals < 128) {
+                if (i + 1 < bufferSize && buffer[i + 1] == buffer[i])
+                    break;
+                i++;
+                literals++;
+            }
+            if (out + 1 + literals > maxCompressedSize)
+                return DT_FAILURE | DT_BUFFER_TOO_SMALL;
+            compressed[out++] = (unsigned char)(literals - 1);
+            memcpy(compressed + out, buffer + start, literals);
+            out += literals;
+        }
+        *compressedSize = out;
+        return DT_SUCCESS;
+    }
+
+    virtual dtStatus decompress(const unsigned char* compressed, const int compressedSize, unsigned char* buffer, const int maxBufferSize, int* bufferSize) override
+    {
+        int out = 0;
+        int i = 0;
+        while (i < compressedSize) {
+            int control = compressed[i++];
+            if (control >= 128) {
+                int run = control - 126;
+                if (i >= compressedSize || out + run > maxBufferSize)
+                    return DT_FAILURE | DT_BUFFER_TOO_SMALL;
+                memset(buffer + out, compressed[i++], run);
+                out += run;
+            } else {
+                int literals = control + 1;
+                if (i + literals > compressedSize || out + literals > maxBufferSize)
+                    return DT_FAILURE | DT_BUFFER_TOO_SMALL;
+                memcpy(buffer + out, compressed + i, literals);
+                i += literals;
+                out += literals;
+            }
+        }
+        *bufferSize = out;
+        return DT_SUCCESS;
+    }
+};
+
+/// @brief Gives the polygons rebuilt by the tile cache the same area and flags as the static build.
+class NavMeshProcess : public dtTileCacheMeshProcess
+{
+public:
+    virtual void process(dtNavMeshCreateParams* params, unsigned char* polyAreas, unsigned short* polyFlags) override
+    {
+        for (int i = 0; i < params->polyCount; i++) {
+            if (polyAreas[i] == DT_TILECACHE_WALKABLE_AREA)
+                polyAreas[i] = 0;
+            polyFlags[i] = NavPolyWalk;
+        }
+    }
+};
+
+// Stateless, shared by every build job and tile cache.
+static NavMeshCompressor sCompressor;
+static NavMeshProcess sMeshProcess;
+static dtTileCacheAlloc sTileCacheAllocator;
+
+/// @brief The Recast intermediates of a tile, freed when the tile is done.
+struct TileScratch
+{
+    rcHeightfield* Solid = nullptr;
+    rcCompactHeightfield* Compact = nullptr;
+    rcContourSet* Contours = nullptr;
+    rcPolyMesh* Mesh = nullptr;
+    rcPolyMeshDetail* Detail = nullptr;
+    rcHeightfieldLayerSet* Layers = nullptr;
+
+    ~TileScratch()
+    {
+        rcFreeHeightField(Solid);
+        rcFreeCompactHeightfield(Compact);
+        rcFreeContourSet(Contours);
+        rcFreePolyMesh(Mesh);
+        rcFreePolyMeshDetail(Detail);
+        rcFreeHeightfieldLayerSet(Layers);
+    }
+};
+
+/// @brief The output of a tile: one Detour tile, or one compressed blob per layer for a tile cache.
+struct TileResult
+{
+    struct Blob
+    {
+        unsigned char* Data;
+        int Size;
+    };
+
+    Vector<Blob> Blobs;
+    float Ms = 0.0f;
+};
+
+/// @brief The tiling of the geometry, shared by every tile job.
+struct TileGrid
+{
+    float BoundsMin[3];
+    float BoundsMax[3];
+    int TilesX = 0;
+    int TilesY = 0;
+    float TileWorldSize = 0.0f;
+    rcConfig Config = {};
+    Vector<Vector<int>> Triangles;
+};
+
+static bool PrepareGrid(const PointCloud& cloud, const NavMeshSettings& settings, TileGrid& grid)
+{
+    if (cloud.Points.empty() || cloud.Indices.empty()) {
+        LOG_ERROR("Can't build a navmesh from empty geometry");
+        return false;
+    }
+    if (settings.VertsPerPoly < 3 || settings.VertsPerPoly > DT_VERTS_PER_POLYGON || settings.TileSize <= 0 || settings.TileSize > 255) {
+        LOG_ERROR("Invalid navmesh settings: {0} vertices per polygon, tile size {1}", settings.VertsPerPoly, settings.TileSize);
+        return false;
+    }
+
+    rcCalcBounds(cloud.Points.data(), (int)(cloud.Points.size() / 3), grid.BoundsMin, grid.BoundsMax);
+
+    int gridWidth = 0, gridHeight = 0;
+    rcCalcGridSize(grid.BoundsMin, grid.BoundsMax, settings.CellSize, &gridWidth, &gridHeight);
+    grid.TilesX = (gridWidth + settings.TileSize - 1) / settings.TileSize;
+    grid.TilesY = (gridHeight + settings.TileSize - 1) / settings.TileSize;
+    grid.TileWorldSize = settings.TileSize * settings.CellSize;
+
+    rcConfig& config = grid.Config;
+    config.cs = settings.CellSize;
+    config.ch = settings.CellHeight;
+    config.walkableSlopeAngle = settings.AgentMaxSlope;
+    config.walkableHeight = (int)glm::ceil(settings.AgentHeight / config.ch);
+    config.walkableClimb = (int)glm::floor(settings.AgentMaxClimb / config.ch);
+    config.walkableRadius = (int)glm::ceil(settings.AgentRadius / config.cs);
+    config.maxEdgeLen = (int)(settings.EdgeMaxLength / config.cs);
+    config.maxSimplificationError = settings.EdgeMaxError;
+    config.minRegionArea = (int)rcSqr(settings.RegionMinSize);
+    config.mergeRegionArea = (int)rcSqr(settings.RegionMergeSize);
+    config.maxVertsPerPoly = settings.VertsPerPoly;
+    config.tileSize = settings.TileSize;
+    config.borderSize = config.walkableRadius + 3;
+    config.width = config.tileSize + config.borderSize * 2;
+    config.height = config.tileSize + config.borderSize * 2;
+    config.detailSampleDist = settings.DetailSampleDistance < 0.9f ? 0.0f : config.cs * settings.DetailSampleDistance;
+    config.detailSampleMaxError = config.ch * settings.DetailSampleMaxError;
+
+    // Bin the triangles in the tiles they touch, border included, so each job only rasterizes its own.
+    grid.Triangles.assign(grid.TilesX * grid.TilesY, {});
+    const float border = config.borderSize * config.cs;
+    for (UInt64 i = 0; i + 2 < cloud.Indices.size(); i += 3) {
+        float minX = FLT_MAX, minZ = FLT_MAX, maxX = -FLT_MAX, maxZ = -FLT_MAX;
+        for (int j = 0; j < 3; j++) {
+            const float* vertex = &cloud.Points[cloud.Indices[i + j] * 3];
+            minX = glm::min(minX, vertex[0]);
+            maxX = glm::max(maxX, vertex[0]);
+            minZ = glm::min(minZ, vertex[2]);
+            maxZ = glm::max(maxZ, vertex[2]);
+        }
+
+        int x0 = glm::clamp((int)glm::floor((minX - border - grid.BoundsMin[0]) / grid.TileWorldSize), 0, grid.TilesX - 1);
+        int x1 = glm::clamp((int)glm::floor((maxX + border - grid.BoundsMin[0]) / grid.TileWorldSize), 0, grid.TilesX - 1);
+        int y0 = glm::clamp((int)glm::floor((minZ - border - grid.BoundsMin[2]) / grid.TileWorldSize), 0, grid.TilesY - 1);
+        int y1 = glm::clamp((int)glm::floor((maxZ + border - grid.BoundsMin[2]) / grid.TileWorldSize), 0, grid.TilesY - 1);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                Vector<int>& triangles = grid.Triangles[y * grid.TilesX + x];
+                triangles.push_back((int)cloud.Indices[i]);
+                triangles.push_back((int)cloud.Indices[i + 1]);
+                triangles.push_back((int)cloud.Indices[i + 2]);
+            }
+        }
+    }
+    return true;
+}
+
+static void GetTileConfig(const TileGrid& grid, int tileX, int tileY, rcConfig& config)
+{
+    config = grid.Config;
+    config.bmin[0] = grid.BoundsMin[0] + tileX * grid.TileWorldSize - config.borderSize * config.cs;
+    config.bmin[1] = grid.BoundsMin[1];
+    config.bmin[2] = grid.BoundsMin[2] + tileY * grid.TileWorldSize - config.borderSize * config.cs;
+    config.bmax[0] = grid.BoundsMin[0] + (tileX + 1) * grid.TileWorldSize + config.borderSize * config.cs;
+    config.bmax[1] = grid.BoundsMax[1];
+    config.bmax[2] = grid.BoundsMin[2] + (tileY + 1) * grid.TileWorldSize + config.borderSize * config.cs;
+}
+
+// Voxelizes the tile's triangles down to an eroded compact heightfield, the part both kinds of build share.
+static bool RasterizeTile(rcContext& context, const PointCloud& cloud, const Vector<int>& triangles, const rcConfig& config, TileScratch& scratch)
+{
+    const float* vertices = cloud.Points.data();
+    int vertexCount = (int)(cloud.Points.size() / 3);
+    int triangleCount = (int)(triangles.size() / 3);
+
+    scratch.Solid = rcAllocHeightfield();
+    if (!rcCreateHeightfield(&context, *scratch.Solid, config.width, config.height, config.bmin, config.bmax, config.cs, config.ch))
+        return false;
+
+    Vector<unsigned char> areas(triangleCount, 0);
+    rcMarkWalkableTriangles(&context, config.walkableSlopeAngle, vertices, vertexCount, triangles.data(), triangleCount, areas.data());
+    if (!rcRasterizeTriangles(&context, vertices, vertexCount, triangles.data(), areas.data(), triangleCount, *scratch.Solid, config.walkableClimb))
+        return false;
+
+    rcFilterLowHangingWalkableObstacles(&context, config.walkableClimb, *scratch.Solid);
+    rcFilterLedgeSpans(&context, config.walkableHeight, config.walkableClimb, *scratch.Solid);
+    rcFilterWalkableLowHeightSpans(&context, config.walkableHeight, *scratch.Solid);
+
+    scratch.Compact = rcAllocCompactHeightfield();
+    if (!rcBuildCompactHeightfield(&context, config.walkableHeight, config.walkableClimb, *scratch.Solid, *scratch.Compact))
+        return false;
+    rcFreeHeightField(scratch.Solid);
+    scratch.Solid = nullptr;
+
+    return rcErodeWalkableArea(&context, config.walkableRadius, *scratch.Compact);
+}
+
+static void BuildTile(const PointCloud& cloud, const TileGrid& grid, const NavMeshSettings& settings, int tileX, int tileY, TileResult& result)
+{
+    const Vector<int>& triangles = grid.Triangles[tileY * grid.TilesX + tileX];
+    if (triangles.empty())
+        return;
+
+    // rcContext logging and timers aren't thread-safe, every tile gets its own silent one.
+    rcContext context(false);
+    rcConfig config;
+    GetTileConfig(grid, tileX, tileY, config);
+
+    TileScratch scratch;
+    if (!RasterizeTile(context, cloud, triangles, config, scratch))
+        return;
+    if (!rcBuildDistanceField(&context, *scratch.Compact))
+        return;
+    if (!rcBuildRegions(&context, *scratch.Compact, config.borderSize, config.minRegionArea, config.mergeRegionArea))
+        return;
+
+    scratch.Contours = rcAllocContourSet();
+    if (!rcBuildContours(&context, *scratch.Compact, config.maxSimplificationError, config.maxEdgeLen, *scratch.Contours))
+        return;
+    if (scratch.Contours->nconts == 0)
+        return;
+
+    scratch.Mesh = rcAllocPolyMesh();
+    if (!rcBuildPolyMesh(&context, *scratch.Contours, config.maxVertsPerPoly, *scratch.Mesh))
+        return;
+    scratch.Detail = rcAllocPolyMeshDetail();
+    if (!rcBuildPolyMeshDetail(&context, *scratch.Mesh, *scratch.Compact, config.detailSampleDist, config.detailSampleMaxError, *scratch.Detail))
+        return;
+    if (scratch.Mesh->nverts == 0 || scratch.Mesh->npolys == 0)
+        return;
+
+    for (int i = 0; i < scratch.Mesh->npolys; i++) {
+        if (scratch.Mesh->areas[i] == RC_WALKABLE_AREA)
+            scratch.Mesh->areas[i] = 0;
+        scratch.Mesh->flags[i] = NavPolyWalk;
+    }
+
+    dtNavMeshCreateParams params = {};
+    params.verts = scratch.Mesh->verts;
+    params.vertCount = scratch.Mesh->nverts;
+    params.polys = scratch.Mesh->polys;
+    params.polyAreas = scratch.Mesh->areas;
+    params.polyFlags = scratch.Mesh->flags;
+    params.polyCount = scratch.Mesh->npolys;
+    params.nvp = scratch.Mesh->nvp;
+    params.detailMeshes = scratch.Detail->meshes;
+    params.detailVerts = scratch.Detail->verts;
+    params.detailVertsCount = scratch.Detail->nverts;
+    params.detailTris = scratch.Detail->tris;
+    params.detailTriCount = scratch.Detail->ntris;
+    params.walkableHeight = settings.AgentHeight;
+    params.walkableRadius = settings.AgentRadius;
+    params.walkableClimb = settings.AgentMaxClimb;
+    params.tileX = tileX;
+    params.tileY = tileY;
+    params.tileLayer = 0;
+    rcVcopy(params.bmin, scratch.Mesh->bmin);
+    rcVcopy(params.bmax, scratch.Mesh->bmax);
+    params.cs = config.cs;
+    params.ch = config.ch;
+    params.buildBvTree = true;
+
+    TileResult::Blob blob = {};
+    if (dtCreateNavMeshData(&params, &blob.Data, &blob.Size))
+        result.Blobs.push_back(blob);
+}
+
+static void BuildTileLayers(const PointCloud& cloud, const TileGrid& grid, int tileX, int tileY, TileResult& result)
+{
+    const Vector<int>& triangles = grid.Triangles[tileY * grid.TilesX + tileX];
+    if (triangles.empty())
+        return;
+
+    rcContext context(false);
+    rcConfig config;
+    GetTileConfig(grid, tileX, tileY, config);
+
+    TileScratch scratch;
+    if (!RasterizeTile(context, cloud, triangles, config, scratch))
+        return;
+
+    scratch.Layers = rcAllocHeightfieldLayerSet();
+    if (!rcBuildHeightfieldLayers(&context, *scratch.Compact, config.borderSize, config.walkableHeight, *scratch.Layers))
+        return;
+
+    int layerCount = glm::min(scratch.Layers->nlayers, MaxLayersPerTile);
+    for (int i = 0; i < layerCount; i++) {
+        const rcHeightfieldLayer& layer = scratch.Layers->layers[i];
+
+        dtTileCacheLayerHeader header = {};
+        header.magic = DT_TILECACHE_MAGIC;
+        header.version = DT_TILECACHE_VERSION;
+        header.tx = tileX;
+        header.ty = tileY;
+        header.tlayer = i;
+        rcVcopy(header.bmin, layer.bmin);
+        rcVcopy(header.bmax, layer.bmax);
+        header.width = (unsigned char)layer.width;
+        header.height = (unsigned char)layer.height;
+        header.minx = (unsigned char)layer.minx;
+        header.maxx = (unsigned char)layer.maxx;
+        header.miny = (unsigned char)layer.miny;
+        header.maxy = (unsigned char)layer.maxy;
+        header.hmin = (unsigned short)layer.hmin;
+        header.hmax = (unsigned short)layer.hmax;
+
+        TileResult::Blob blob = {};
+        if (dtStatusSucceed(dtBuildTileCacheLayer(&sCompressor, &header, layer.heights, layer.areas, layer.cons, &blob.Data, &blob.Size)))
+            result.Blobs.push_back(blob);
+    }
+}
+
+// Tiles don't share anything, so they go wide. From a worker, build inline rather than wait on ourselves.
+static void RunTileJobs(const TileGrid& grid, Vector<TileResult>& tiles, const std::function<void(int, int, TileResult&)>& buildTile)
+{
+    tiles.resize(grid.TilesX * grid.TilesY);
+    auto job = [&](UInt32 index) {
+        Timer tileTimer;
+        buildTile((int)index % grid.TilesX, (int)index / grid.TilesX, tiles[index]);
+        tiles[index].Ms = tileTimer.GetElapsed();
+    };
+
+    if (JobSystem::GetCurrentWorker() >= 0 || JobSystem::GetWorkerCount() == 0) {
+        for (UInt32 i = 0; i < tiles.size(); i++)
+            job(i);
+    } else {
+        JobSystem::Counter counter;
+        JobSystem::Dispatch((UInt32)tiles.size(), [&](UInt32 jobIndex, UInt32) { job(jobIndex); }, &counter);
+        JobSystem::Wait(&counter);
+    }
+}
+
+static int GetTileBits(int tileCount)
+{
+    // Tile and polygon ids share the 22 bits Detour leaves after the salt.
+    int tileBits = 0;
+    while ((1 << tileBits) < tileCount)
+        tileBits++;
+    return glm::min(tileBits, 14);
+}
+
+static void WriteBlob(NavMeshBlobHeader& header, Vector<TileResult>& tiles, Vector<UInt8>& bytes)
+{
+    UInt64 totalSize = sizeof(NavMeshBlobHeader);
+    for (const TileResult& tile : tiles) {
+        for (const TileResult::Blob& blob : tile.Blobs) {
+            header.TileCount++;
+            totalSize += sizeof(UInt32) + blob.Size;
+        }
+    }
+
+    bytes.clear();
+    bytes.reserve(totalSize);
+    bytes.resize(sizeof(NavMeshBlobHeader));
+    memcpy(bytes.data(), &header, sizeof(NavMeshBlobHeader));
+    for (TileResult& tile : tiles) {
+        for (TileResult::Blob& blob : tile.Blobs) {
+            UInt32 size = (UInt32)blob.Size;
+            const UInt8* sizeBytes = reinterpret_cast<const UInt8*>(&size);
+            bytes.insert(bytes.end(), sizeBytes, sizeBytes + sizeof(UInt32));
+            bytes.insert(bytes.end(), blob.Data, blob.Data + blob.Size);
+            dtFree(blob.Data);
+        }
+        tile.Blobs.clear();
+    }
+}
+
+static void FillStats(const Vector<TileResult>& tiles, UInt32 builtTiles, Timer& timer, NavMeshBuildStats* stats)
+{
+    if (!stats)
+        return;
+    stats->TileCount = (UInt32)tiles.size();
+    stats->BuiltTiles = builtTiles;
+    stats->TotalMs = timer.GetElapsed();
+    stats->TileMs.resize(tiles.size());
+    for (UInt64 i = 0; i < tiles.size(); i++)
+        stats->TileMs[i] = tiles[i].Ms;
+}
+
+bool NavMeshBuilder::Build(const PointCloud& cloud, const NavMeshSettings& settings, Vector<UInt8>& bytes, NavMeshBuildStats* stats)
+{
+    PROFILE_FUNCTION();
+
+    Timer timer;
+    TileGrid grid;
+    if (!PrepareGrid(cloud, settings, grid))
+        return false;
+
+    const int tileCount = grid.TilesX * grid.TilesY;
+    const int tileBits = GetTileBits(tileCount);
+    if (tileCount > (1 << tileBits)) {
+        LOG_ERROR("Navmesh needs {0} tiles but can only address {1}, increase the tile size", tileCount, 1 << tileBits);
+        return false;
+    }
+
+    Vector<TileResult> tiles;
+    RunTileJobs(grid, tiles, [&](int x, int y, TileResult& result) {
+        BuildTile(cloud, grid, settings, x, y, result);
+    });
+
+    NavMeshBlobHeader header = {};
+    header.Magic = NavMeshMagic;
+    header.Version = FormatVersion;
+    rcVcopy(header.Params.orig, grid.BoundsMin);
+    header.Params.tileWidth = grid.TileWorldSize;
+    header.Params.tileHeight = grid.TileWorldSize;
+    header.Params.maxTiles = 1 << tileBits;
+    header.Params.maxPolys = 1 << (22 - tileBits);
+
+    WriteBlob(header, tiles, bytes);
+    FillStats(tiles, header.TileCount, timer, stats);
+
+    if (header.TileCount == 0) {
+        LOG_ERROR("Navmesh build produced no walkable tile");
+        return false;
+    }
+    return true;
+}
+
+bool NavMeshBuilder::BuildTileCache(const PointCloud& cloud, const NavMeshSettings& settings, Vector<UInt8>& bytes, NavMeshBuildStats* stats)
+{
+    PROFILE_FUNCTION();
+
+    Timer timer;
+    TileGrid grid;
+    if (!PrepareGrid(cloud, settings, grid))
+        return false;
+
+    const int tileCount = grid.TilesX * grid.TilesY;
+    const int tileBits = GetTileBits(tileCount * ExpectedLayersPerTile);
+
+    Vector<TileResult> tiles;
+    RunTileJobs(grid, tiles, [&](int x, int y, TileResult& result) {
+        BuildTileLayers(cloud, grid, x, y, result);
+    });
+
+    NavMeshBlobHeader header = {};
+    header.Magic = NavMeshMagic;
+    header.Version = FormatVersion;
+    header.TileCache = 1;
+    rcVcopy(header.Params.orig, grid.BoundsMin);
+    header.Params.tileWidth = grid.TileWorldSize;
+    header.Params.tileHeight = grid.TileWorldSize;
+    header.Params.maxTiles = 1 << tileBits;
+    header.Params.maxPolys = 1 << (22 - tileBits);
+
+    dtTileCacheParams& cacheParams = header.CacheParams;
+    rcVcopy(cacheParams.orig, grid.BoundsMin);
+    cacheParams.cs = settings.CellSize;
+    cacheParams.ch = settings.CellHeight;
+    cacheParams.width = settings.TileSize;
+    cacheParams.height = settings.TileSize;
+    cacheParams.walkableHeight = settings.AgentHeight;
+    cacheParams.walkableRadius = settings.AgentRadius;
+    cacheParams.walkableClimb = settings.AgentMaxClimb;
+    cacheParams.maxSimplificationError = settings.EdgeMaxError;
+    cacheParams.maxTiles = tileCount * ExpectedLayersPerTile;
+    cacheParams.maxObstacles = MaxObstacles;
+
+    WriteBlob(header, tiles, bytes);
+    FillStats(tiles, header.TileCount, timer, stats);
+
+    if (header.TileCount == 0) {
+        LOG_ERROR("Navmesh build produced no walkable layer");
+        return false;
+    }
+    return true;
+}
+
+static bool ReadBlobHeader(const UInt8* data, UInt64 size, NavMeshBlobHeader& header)
+{
+    if (size < sizeof(NavMeshBlobHeader)) {
+        LOG_ERROR("Navmesh data is truncated");
+        return false;
+    }
+    memcpy(&header, data, sizeof(NavMeshBlobHeader));
+    if (header.Magic != NavMeshMagic || header.Version != NavMeshBuilder::FormatVersion) {
+        LOG_ERROR("Navmesh data has an unknown format");
+        return false;
+    }
+    return true;
+}
+
+// Hands every tile of a blob whose header was validated to the callback.
+static void ReadBlobTiles(const UInt8* data, UInt64 size, const NavMeshBlobHeader& header, const std::function<void(UInt32, const UInt8*, UInt32)>& readTile)
+{
+    UInt64 offset = sizeof(NavMeshBlobHeader);
+    for (UInt32 i = 0; i < header.TileCount; i++) {
+        UInt32 tileSize = 0;
+        if (offset + sizeof(UInt32) > size)
+            break;
+        memcpy(&tileSize, data + offset, sizeof(UInt32));
+        offset += sizeof(UInt32);
+        if (offset + tileSize > size)
+            break;
+        readTile(i, data + offset, tileSize);
+        offset += tileSize;
+    }
+
+    if (offset != size)
+        LOG_WARN("Navmesh data is truncated, some tiles are missing");
+}
+
+dtNavMesh* NavMeshBuilder::Load(const UInt8* data, UInt64 size)
+{
+    PROFILE_FUNCTION();
+
+    NavMeshBlobHeader header = {};
+    if (!ReadBlobHeader(data, size, header))
+        return nullptr;
+    if (header.TileCache) {
+        LOG_ERROR("Navmesh data is a tile cache, load it with LoadTileCache");
+        return nullptr;
+    }
+
+    dtNavMesh* navMesh = dtAllocNavMesh();
+    if (!navMesh || dtStatusFailed(navMesh->init(&header.Params))) {
+        LOG_ERROR("Failed to initialize navmesh");
+        dtFreeNavMesh(navMesh);
+        return nullptr;
+    }
+
+    ReadBlobTiles(data, size, header, [&](UInt32 index, const UInt8* tile, UInt32 tileSize) {
+        // The navmesh owns its tiles, they're copied out of the cache blob.
+        unsigned char* tileData = (unsigned char*)dtAlloc(tileSize, DT_ALLOC_PERM);
+        memcpy(tileData, tile, tileSize);
+        if (dtStatusFailed(navMesh->addTile(tileData, (int)tileSize, DT_TILE_FREE_DATA, 0, nullptr))) {
+            LOG_WARN("Skipping invalid navmesh tile {0}", index);
+            dtFree(tileData);
+        }
+    });
+    return navMesh;
+}
+
+bool NavMeshBuilder::LoadTileCache(const UInt8* data, UInt64 size, dtTileCache** tileCache, dtNavMesh** navMesh)
+{
+    PROFILE_FUNCTION();
+
+    *tileCache = nullptr;
+    *navMesh = nullptr;
+
+    NavMeshBlobHeader header = {};
+    if (!ReadBlobHeader(data, size, header))
+        return false;
+    if (!header.TileCache) {
+        LOG_ERROR("Navmesh data isn't a tile cache, load it with Load");
+        return false;
+    }
+
+    dtTileCache* cache = dtAllocTileCache();
+    dtNavMesh* mesh = dtAllocNavMesh();
+    if (!cache || !mesh || dtStatusFailed(cache->init(&header.CacheParams, &sTileCacheAllocator, &sCompressor, &sMeshProcess)) || dtStatusFailed(mesh->init(&header.Params))) {
+        LOG_ERROR("Failed to initialize navmesh tile cache");
+        dtFreeTileCache(cache);
+        dtFreeNavMesh(mesh);
+        return false;
+    }
+
+    ReadBlobTiles(data, size, header, [&](UInt32 index, const UInt8* layer, UInt32 layerSize) {
+        unsigned char* layerData = (unsigned char*)dtAlloc(layerSize, DT_ALLOC_PERM);
+        memcpy(layerData, layer, layerSize);
+        if (dtStatusFailed(cache->addTile(layerData, (int)layerSize, DT_COMPRESSEDTILE_FREE_DATA, nullptr))) {
+            LOG_WARN("Skipping navmesh layer {0}, the tile cache is full", index);
+            dtFree(layerData);
+        }
+    });
+
+    // Polygonize every layer once, obstacles only rebuild what they touch from then on.
+    for (int i = 0; i < cache->getTileCount(); i++) {
+        const dtCompressedTile* tile = cache->getTile(i);
+        if (!tile || !tile->header)
+            continue;
+        cache->buildNavMeshTile(cache->getTileRef(tile), mesh);
+    }
+
+    *tileCache = cache;
+    *navMesh = mesh;
+    return true;
+}
+
+bool NavMeshBuilder::CopyTile(const dtNavMesh* source, dtNavMesh* destination, int tileX, int tileY, int layer)
+{
+    dtTileRef existing = destination->getTileRefAt(tileX, tileY, layer);
+    if (existing)
+        destination->removeTile(existing, nullptr, nullptr);
+
+    const dtMeshTile* tile = source->getTileAt(tileX, tileY, layer);
+    if (!tile || !tile->header || !tile->data)
+        return true;
+
+    // Detour patches links into the tile data it's given, so the destination gets its own copy.
+    unsigned char* data = (unsigned char*)dtAlloc(tile->dataSize, DT_ALLOC_PERM);
+    memcpy(data, tile->data, tile->dataSize);
+    if (dtStatusFailed(destination->addTile(data, tile->dataSize, DT_TILE_FREE_DATA, 0, nullptr))) {
+        dtFree(data);
+        return false;
+    }
+    return true;
+}
+
+void NavMeshBuilder::RunBenchmark(const String& meshPath, const NavMeshSettings& settings)
+{
+    LOG_INFO("[NAVMESH BENCHMARK] {0}, tile size {1}, {2} workers", meshPath, settings.TileSize, JobSystem::GetWorkerCount());
+
+    Timer loadTimer;
+    PointCloud cloud(meshPath);
+    LOG_INFO("[NAVMESH BENCHMARK] Loaded {0} vertices, {1} triangles in {2}ms", cloud.Points.size() / 3, cloud.Indices.size() / 3, loadTimer.GetElapsed());
+
+    Vector<UInt8> bytes;
+    NavMeshBuildStats stats;
+    if (!NavMeshBuilder::Build(cloud, settings, bytes, &stats))
+        return;
+
+    float tileSum = 0.0f;
+    float tileMax = 0.0f;
+    for (UInt32 i = 0; i < stats.TileCount; i++) {
+        LOG_INFO("[NAVMESH BENCHMARK] Tile {0}: {1}ms", i, stats.TileMs[i]);
+        tileSum += stats.TileMs[i];
+        tileMax = glm::max(tileMax, stats.TileMs[i]);
+    }
+
+    Timer restoreTimer;
+    dtNavMesh* navMesh = NavMeshBuilder::Load(bytes.data(), bytes.size());
+    float restoreMs = restoreTimer.GetElapsed();
+    dtFreeNavMesh(navMesh);
+
+    LOG_INFO("[NAVMESH BENCHMARK] {0}/{1} tiles built in {2}ms ({3}ms summed over tiles, {4}ms average, {5}ms worst), {6}kb",
+             stats.BuiltTiles, stats.TileCount, stats.TotalMs, tileSum, tileSum / stats.TileCount, tileMax, bytes.size() / 1024);
+    LOG_INFO("[NAVMESH BENCHMARK] Loading the built navmesh takes {0}ms", restoreMs);
+}
+
+float NavMeshBuilder::BenchmarkRandom()
+{
+    // Detour wants [0, 1), 24 random bits fit a float exactly.
+    static std::mt19937 random(1234);
+    return (random() >> 8) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,107 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-27 10:11:48
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+#include <Utility/PointCloud.hpp>
+
+class dtNavMesh;
+class dtTileCache;
+
+/// @brief Parameters of a navmesh build. Distances are in world units.
+///
+/// Only 4-byte members, the struct is hashed as is to know whether a cached navmesh is still valid.
+struct NavMeshSettings
+{
+    float CellSize = 0.3f; ///< Horizontal voxel size.
+    float CellHeight = 0.2f; ///< Vertical voxel size.
+    float AgentHeight = 2.0f; ///< Minimum ceiling height an agent can walk under.
+    float AgentRadius = 0.6f; ///< Agent radius, walls are eroded by it.
+    float AgentMaxClimb = 0.9f; ///< Maximum ledge height an agent can step up.
+    float AgentMaxSlope = 45.0f; ///< Maximum walkable slope, in degrees.
+    float RegionMinSize = 8.0f; ///< Regions smaller than this (in cells, squared) are removed.
+    float RegionMergeSize = 20.0f; ///< Regions smaller than this (in cells, squared) are merged with their neighbours.
+    float EdgeMaxLength = 12.0f; ///< Maximum length of a contour edge.
+    float EdgeMaxError = 1.3f; ///< Maximum distance a simplified contour can deviate from the raw one, in cells.
+    float DetailSampleDistance = 6.0f; ///< Detail mesh sampling distance, in cells.
+    float DetailSampleMaxError = 1.0f; ///< Maximum detail mesh deviation, in cell heights.
+    int VertsPerPoly = 6; ///< Maximum vertices per navmesh polygon.
+    int TileSize = 48; ///< Width and depth of a tile, in cells.
+};
+
+/// @brief Timings of a navmesh build.
+struct NavMeshBuildStats
+{
+    UInt32 TileCount = 0; ///< Number of tiles covering the geometry.
+    UInt32 BuiltTiles = 0; ///< Number of tiles that ended up with polygons.
+    float TotalMs = 0.0f; ///< Wall clock time of the whole build.
+    Vector<float> TileMs; ///< Build time of each tile, row by row.
+};
+
+/// @brief Builds tiled Recast navmeshes and loads them into Detour.
+///
+/// The geometry is cut in square tiles that are rasterized and polygonized independently, on the job
+/// system. The result is a flat blob of every tile's Detour data, which is what gets cached on disk by
+/// `AssetCacher::ReadNavMesh` and handed to `Load`.
+///
+/// Navmeshes with dynamic obstacles are built as a tile cache instead: every tile is stored as compressed
+/// heightfield layers, which the tile cache polygonizes again whenever an obstacle touches the tile.
+class NavMeshBuilder
+{
+public:
+    /// @brief Version of the serialized blob, bumped whenever its layout changes.
+    static constexpr UInt32 FormatVersion = 2;
+
+    /// @brief Maximum number of obstacles a tile cache can hold.
+    static constexpr int MaxObstacles = 1024;
+
+    /// @brief Builds a navmesh from the given geometry.
+    /// @param cloud The level geometry.
+    /// @param settings The build parameters.
+    /// @param bytes Receives the serialized tiles.
+    /// @param stats Optional build timings.
+    /// @return False if no tile could be built.
+    static bool Build(const PointCloud& cloud, const NavMeshSettings& settings, Vector<UInt8>& bytes, NavMeshBuildStats* stats = nullptr);
+
+    /// @brief Builds the compressed layers of a tile cache from the given geometry.
+    /// @param cloud The level geometry.
+    /// @param settings The build parameters.
+    /// @param bytes Receives the serialized layers.
+    /// @param stats Optional build timings.
+    /// @return False if no layer could be built.
+    static bool BuildTileCache(const PointCloud& cloud, const NavMeshSettings& settings, Vector<UInt8>& bytes, NavMeshBuildStats* stats = nullptr);
+
+    /// @brief Creates a Detour navmesh from serialized tiles.
+    /// @param data The serialized tiles.
+    /// @param size The size of the data in bytes.
+    /// @return The navmesh, to free with dtFreeNavMesh, or null if the data is invalid.
+    static dtNavMesh* Load(const UInt8* data, UInt64 size);
+
+    /// @brief Creates a tile cache from serialized layers, and the navmesh it polygonizes them into.
+    /// @param data The serialized layers.
+    /// @param size The size of the data in bytes.
+    /// @param tileCache Receives the tile cache, to free with dtFreeTileCache.
+    /// @param navMesh Receives the navmesh with every tile built, to free with dtFreeNavMesh.
+    /// @return False if the data is invalid.
+    static bool LoadTileCache(const UInt8* data, UInt64 size, dtTileCache** tileCache, dtNavMesh** navMesh);
+
+    /// @brief Replaces a tile of a navmesh with a copy of the same tile in another navmesh, or removes it if the source has none.
+    /// @param source The navmesh to copy from. Both navmeshes must share the same parameters.
+    /// @param destination The navmesh to copy to.
+    /// @param tileX The tile column.
+    /// @param tileY The tile row.
+    /// @param layer The tile layer.
+    /// @return False if the copy couldn't be added.
+    static bool CopyTile(const dtNavMesh* source, dtNavMesh* destination, int tileX, int tileY, int layer);
+
+    /// @brief Builds the navmesh of a mesh file without any cache, and logs the time of every tile and the total.
+    /// @param meshPath The mesh file to build from.
+    /// @param settings The build parameters.
+    static void RunBenchmark(const String& meshPath, const NavMeshSettings& settings = NavMeshSettings());
+
+    /// @brief A random number in [0, 1) from a fixed seed, for Detour's random point queries in the navigation benchmarks.
+    static float BenchmarkRandom();
+};
@@ -0,0 +1,331 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-01 11:42:15
+//
+
+#include "NavPathfinder.hpp"
+#include "NavMeshBuilder.hpp"
+
+#include <Core/Logger.hpp>
+#include <Core/Profiler.hpp>
+#include <Core/Timer.hpp>
+
+#include <DetourNavMesh.h>
+#include <DetourNavMeshQuery.h>
+
+NavPathfinder::Data NavPathfinder::sData;
+
+/// @brief Longest corridor of polygons a search can return.
+static constexpr int MaxPathPolys = 512;
+
+/// @brief How far from the navmesh, per axis, start and goal positions are snapped to it.
+static const float sQueryHalfExtents[3] = { 2.0f, 4.0f, 2.0f };
+
+/// @brief Default filter, walks every polygon. Only read, by the lanes and by Sync while they are idle.
+static const dtQueryFilter sFilter;
+
+void NavPathfinder::Init(dtNavMesh* navMesh)
+{
+    Exit();
+
+    sData.NavMesh = navMesh;
+    sData.Lanes.resize(std::max(JobSystem::GetWorkerCount(), 1u));
+    for (Lane& lane : sData.Lanes) {
+        lane.Query = dtAllocNavMeshQuery();
+        if (!lane.Query || dtStatusFailed(lane.Query->init(navMesh, MaxQueryNodes))) {
+            LOG_ERROR("Failed to initialize pathfinding query");
+            Exit();
+            return;
+        }
+    }
+}
+
+void NavPathfinder::Exit()
+{
+    WaitIdle();
+
+    for (Lane& lane : sData.Lanes)
+        dtFreeNavMeshQuery(lane.Query);
+    sData.Lanes.clear();
+    sData.NavMesh = nullptr;
+
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    sData.Pending.clear();
+    sData.Live.clear();
+    InvalidateCache();
+}
+
+UInt64 NavPathfinder::RequestPath(const glm::vec3& start, const glm::vec3& goal, const Callback& callback)
+{
+    if (!sData.NavMesh)
+        return 0;
+
+    Request request = {};
+    request.Start = start;
+    request.Goal = goal;
+    request.CacheKey = GetCacheKey(start, goal);
+    request.OnDone = callback;
+
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    UInt64 id = sData.NextID++;
+    request.ID = id;
+    sData.Live.insert(id);
+    sData.Pending.push_back(std::move(request));
+    return id;
+}
+
+void NavPathfinder::Cancel(UInt64 request)
+{
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    sData.Live.erase(request);
+}
+
+void NavPathfinder::Sync()
+{
+    PROFILE_FUNCTION();
+
+    if (sData.Lanes.empty())
+        return;
+
+    // The lanes had the whole frame, this is usually already done.
+    WaitIdle();
+
+    Vector<Pair<Request, NavPathResult>> completed;
+    for (Lane& lane : sData.Lanes) {
+        for (auto& entry : lane.Completed)
+            completed.push_back(std::move(entry));
+        lane.Completed.clear();
+    }
+
+    Vector<Request> pending;
+    {
+        std::lock_guard<std::mutex> lock(sData.Mutex);
+        pending.swap(sData.Pending);
+    }
+
+    // New requests are either served from the cache now or handed to the emptiest lane.
+    for (Request& request : pending) {
+        auto it = sData.Cache.find(request.CacheKey);
+        if (it == sData.Cache.end()) {
+            Lane* lane = &sData.Lanes[0];
+            for (Lane& other : sData.Lanes) {
+                if (other.Requests.size() < lane->Requests.size())
+                    lane = &other;
+            }
+            lane->Requests.push(std::move(request));
+            continue;
+        }
+
+        // Same cells, same corridor: only the ends move to where this request asked, snapped to the navmesh
+        // like a search would. The lanes are idle, so the first one's query is free.
+        dtNavMeshQuery* query = sData.Lanes[0].Query;
+        dtPolyRef startRef = 0;
+        dtPolyRef goalRef = 0;
+        query->findNearestPoly(&request.Start.x, sQueryHalfExtents, &sFilter, &startRef, &request.Start.x);
+        query->findNearestPoly(&request.Goal.x, sQueryHalfExtents, &sFilter, &goalRef, &request.Goal.x);
+
+        NavPathResult result;
+        result.Cached = true;
+        if (startRef && goalRef) {
+            result.Found = true;
+            result.Points = it->second;
+            result.Points.front() = request.Start;
+            result.Points.back() = request.Goal;
+        }
+        completed.push_back({ std::move(request), std::move(result) });
+    }
+
+    for (auto& [request, result] : completed) {
+        if (result.Found && !result.Partial && !result.Cached && result.Points.size() >= 2) {
+            if (!sData.Cache.count(request.CacheKey)) {
+                if (sData.Cache.size() >= MaxCachedPaths) {
+                    sData.Cache.erase(sData.CacheOrder.front());
+                    sData.CacheOrder.pop();
+                }
+                sData.CacheOrder.push(request.CacheKey);
+            }
+            sData.Cache[request.CacheKey] = result.Points;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(sData.Mutex);
+            if (!sData.Live.erase(request.ID))
+                continue;
+        }
+        result.Request = request.ID;
+        if (request.OnDone)
+            request.OnDone(result);
+    }
+
+    bool hasWork = false;
+    for (Lane& lane : sData.Lanes)
+        hasWork |= !lane.Requests.empty();
+    if (!hasWork)
+        return;
+
+    int budget = NodeBudgetPerFrame / (int)sData.Lanes.size();
+    if (JobSystem::GetWorkerCount() == 0 || JobSystem::GetCurrentWorker() >= 0) {
+        for (Lane& lane : sData.Lanes)
+            RunLane(lane, budget);
+        return;
+    }
+
+    sData.Running = true;
+    JobSystem::Dispatch((UInt32)sData.Lanes.size(), [budget](UInt32 jobIndex, UInt32) {
+        RunLane(sData.Lanes[jobIndex], budget);
+    }, &sData.Counter);
+}
+
+void NavPathfinder::WaitIdle()
+{
+    if (!sData.Running)
+        return;
+    JobSystem::Wait(&sData.Counter);
+    sData.Running = false;
+}
+
+void NavPathfinder::InvalidateCache()
+{
+    sData.Cache.clear();
+    sData.CacheOrder = {};
+}
+
+UInt32 NavPathfinder::GetPendingCount()
+{
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    return (UInt32)sData.Live.size();
+}
+
+void NavPathfinder::RunLane(Lane& lane, int budget)
+{
+    while (budget > 0 && !lane.Requests.empty()) {
+        Request& request = lane.Requests.front();
+        dtNavMeshQuery* query = lane.Query;
+
+        if (!request.Started) {
+            dtPolyRef startRef = 0;
+            dtPolyRef goalRef = 0;
+            query->findNearestPoly(&request.Start.x, sQueryHalfExtents, &sFilter, &startRef, &request.Start.x);
+            query->findNearestPoly(&request.Goal.x, sQueryHalfExtents, &sFilter, &goalRef, &request.Goal.x);
+            if (!startRef || !goalRef || dtStatusFailed(query->initSlicedFindPath(startRef, goalRef, &request.Start.x, &request.Goal.x, &sFilter))) {
+                FinishSearch(lane, request, false);
+                continue;
+            }
+            request.GoalRef = goalRef;
+            request.Started = true;
+        }
+
+        int iterations = 0;
+        dtStatus status = query->updateSlicedFindPath(budget, &iterations);
+        budget -= glm::max(iterations, 1);
+        if (dtStatusInProgress(status))
+            break;
+
+        // Tiles swapped under a search invalidate its nodes, start it over once on the new ones.
+        if (dtStatusFailed(status) && !request.Retried) {
+            request.Started = false;
+            request.Retried = true;
+            continue;
+        }
+        FinishSearch(lane, request, dtStatusSucceed(status));
+    }
+}
+
+void NavPathfinder::FinishSearch(Lane& lane, Request& request, bool found)
+{
+    NavPathResult result;
+
+    dtPolyRef path[MaxPathPolys];
+    int pathCount = 0;
+    if (found) {
+        dtStatus status = lane.Query->finalizeSlicedFindPath(path, &pathCount, MaxPathPolys);
+        found = dtStatusSucceed(status) && pathCount > 0;
+    }
+
+    if (found) {
+        // A partial corridor stops at the polygon closest to the goal, so does the path.
+        glm::vec3 end = request.Goal;
+        if (path[pathCount - 1] != (dtPolyRef)request.GoalRef) {
+            lane.Query->closestPointOnPoly(path[pathCount - 1], &request.Goal.x, &end.x, nullptr);
+            result.Partial = true;
+        }
+
+        float points[MaxPathPoints * 3];
+        int pointCount = 0;
+        lane.Query->findStraightPath(&request.Start.x, &end.x, path, pathCount, points, nullptr, nullptr, &pointCount, MaxPathPoints);
+        result.Found = pointCount > 0;
+        result.Points.reserve(pointCount);
+        for (int i = 0; i < pointCount; i++)
+            result.Points.emplace_back(points[i * 3], points[i * 3 + 1], points[i * 3 + 2]);
+    }
+
+    lane.Completed.push_back({ std::move(request), std::move(result) });
+    lane.Requests.pop();
+}
+
+UInt64 NavPathfinder::GetCacheKey(const glm::vec3& start, const glm::vec3& goal)
+{
+    glm::ivec3 a = glm::ivec3(glm::floor(start / CacheCellSize));
+    glm::ivec3 b = glm::ivec3(glm::floor(goal / CacheCellSize));
+
+    UInt64 hash = 14695981039346656037ull;
+    for (int value : { a.x, a.y, a.z, b.x, b.y, b.z }) {
+        hash ^= (UInt32)value;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void NavPathfinder::RunBenchmark(const String& meshPath, UInt32 count)
+{
+    LOG_INFO("[PATHFINDING BENCHMARK] {0}, {1} requests, {2} lanes", meshPath, count, std::max(JobSystem::GetWorkerCount(), 1u));
+
+    PointCloud cloud(meshPath);
+    Vector<UInt8> bytes;
+    if (!NavMeshBuilder::Build(cloud, NavMeshSettings(), bytes))
+        return;
+    dtNavMesh* navMesh = NavMeshBuilder::Load(bytes.data(), bytes.size());
+    if (!navMesh)
+        return;
+
+    dtNavMeshQuery* query = dtAllocNavMeshQuery();
+    query->init(navMesh, 2048);
+    Vector<Pair<glm::vec3, glm::vec3>> pairs(count);
+    for (auto& [start, goal] : pairs) {
+        dtPolyRef ref = 0;
+        query->findRandomPoint(&sFilter, NavMeshBuilder::BenchmarkRandom, &ref, &start.x);
+        query->findRandomPoint(&sFilter, NavMeshBuilder::BenchmarkRandom, &ref, &goal.x);
+    }
+    dtFreeNavMeshQuery(query);
+
+    Init(navMesh);
+
+    // The second pass asks for the same paths again, it should be all cache hits.
+    const char* passes[] = { "cold", "cached" };
+    for (const char* pass : passes) {
+        UInt32 found = 0;
+        UInt32 cached = 0;
+        for (auto& [start, goal] : pairs) {
+            RequestPath(start, goal, [&](const NavPathResult& result) {
+                found += result.Found;
+                cached += result.Cached;
+            });
+        }
+
+        UInt32 frames = 0;
+        float totalMs = 0.0f;
+        float maxMs = 0.0f;
+        while (GetPendingCount() > 0) {
+            Timer timer;
+            Sync();
+            float elapsed = timer.GetElapsed();
+            totalMs += elapsed;
+            maxMs = glm::max(maxMs, elapsed);
+            frames++;
+        }
+        LOG_INFO("[PATHFINDING BENCHMARK] {0}: {1} found, {2} from cache, over {3} frames, {4}ms total, {5}ms worst frame", pass, found, cached, frames, totalMs, maxMs);
+    }
+
+    Exit();
+    dtFreeNavMesh(navMesh);
+}
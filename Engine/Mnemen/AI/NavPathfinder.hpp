@@ -0,0 +1,144 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-01 11:20:37
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+#include <Core/JobSystem.hpp>
+
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+class dtNavMesh;
+class dtNavMeshQuery;
+
+/// @brief The outcome of a path request.
+struct NavPathResult
+{
+    /// @brief The ID of the request.
+    UInt64 Request = 0;
+    /// @brief Whether a path was found. It may stop short of the goal, see Partial.
+    bool Found = false;
+    /// @brief Whether the goal couldn't be reached and the path leads to the closest point instead.
+    bool Partial = false;
+    /// @brief Whether the path came from the cache.
+    bool Cached = false;
+    /// @brief The corners of the path, from start to goal.
+    Vector<glm::vec3> Points;
+};
+
+/// @brief Finds navmesh paths in the background.
+///
+/// Requests are queued from any thread and spread over lanes, each owning a dtNavMeshQuery and run as one
+/// job per lane. Searches are sliced: a lane spends its share of the per-frame node budget, and a search
+/// that runs out of it carries on next frame, so a burst of requests is spread over frames instead of
+/// stalling one. Straight paths are cached by start and goal cell, and callbacks are only ever called
+/// from `Sync`, on the main thread.
+class NavPathfinder
+{
+public:
+    /// @brief Called on the main thread with the result of a request.
+    using Callback = std::function<void(const NavPathResult& result)>;
+
+    /// @brief Search nodes each lane's query can hold.
+    static constexpr int MaxQueryNodes = 4096;
+
+    /// @brief Search iterations shared by every lane per frame.
+    static constexpr int NodeBudgetPerFrame = 8192;
+
+    /// @brief Size of the cells start and goal positions are snapped to for the cache, in world units.
+    static constexpr float CacheCellSize = 1.0f;
+
+    /// @brief Maximum number of cached paths, the oldest ones are dropped first.
+    static constexpr UInt32 MaxCachedPaths = 2048;
+
+    /// @brief Maximum number of corners of a returned path.
+    static constexpr int MaxPathPoints = 256;
+
+    /// @brief Creates the lanes for a navmesh.
+    /// @param navMesh The navmesh to search. It has to outlive the pathfinder.
+    static void Init(dtNavMesh* navMesh);
+
+    /// @brief Waits for the running searches and drops every request without calling them back.
+    static void Exit();
+
+    /// @brief Queues a path request. Thread-safe.
+    /// @param start Where the path starts.
+    /// @param goal Where the path should end.
+    /// @param callback Called from `Sync` once the path is found, or not.
+    /// @return An ID to cancel the request with, 0 if there is no navmesh.
+    static UInt64 RequestPath(const glm::vec3& start, const glm::vec3& goal, const Callback& callback);
+
+    /// @brief Cancels a request, its callback won't be called. Thread-safe.
+    static void Cancel(UInt64 request);
+
+    /// @brief The sync point: collects the lanes' last frame of work, calls the completed requests back and starts the next frame of searches.
+    ///
+    /// Call from the main thread, where the navmesh can't change while the lanes run.
+    static void Sync();
+
+    /// @brief Waits until the lanes are done with the current frame of searches, so the navmesh can be modified.
+    static void WaitIdle();
+
+    /// @brief Forgets every cached path, when the navmesh changed.
+    static void InvalidateCache();
+
+    /// @brief Returns the number of requests waiting or being searched.
+    static UInt32 GetPendingCount();
+
+    /// @brief Queues `count` requests between random points of a mesh's navmesh at once and logs how long each frame of searching takes until they're all done.
+    /// @param meshPath The mesh to build the navmesh from.
+    /// @param count The number of simultaneous requests.
+    static void RunBenchmark(const String& meshPath, UInt32 count = 500);
+private:
+    /// @brief A queued or running request.
+    struct Request
+    {
+        UInt64 ID;
+        glm::vec3 Start;
+        glm::vec3 Goal;
+        UInt64 CacheKey;
+        UInt64 GoalRef = 0;
+        Callback OnDone;
+        bool Started = false;
+        bool Retried = false;
+    };
+
+    /// @brief A query and the requests it works through, the front one possibly mid-search.
+    struct Lane
+    {
+        dtNavMeshQuery* Query = nullptr;
+        QueueArray<Request> Requests;
+        Vector<Pair<Request, NavPathResult>> Completed;
+    };
+
+    /// @brief Runs a lane for one frame of its budget. Runs on a worker.
+    static void RunLane(Lane& lane, int budget);
+
+    /// @brief Turns the finished search of a lane's query into a straight path.
+    static void FinishSearch(Lane& lane, Request& request, bool found);
+
+    /// @brief The cache key of a start and goal.
+    static UInt64 GetCacheKey(const glm::vec3& start, const glm::vec3& goal);
+
+    static struct Data {
+        dtNavMesh* NavMesh = nullptr;
+        Vector<Lane> Lanes;
+
+        std::mutex Mutex; ///< Guards Pending, Live and NextID.
+        Vector<Request> Pending;
+        std::unordered_set<UInt64> Live; ///< Requests that haven't been called back or cancelled yet.
+        UInt64 NextID = 1;
+
+        JobSystem::Counter Counter;
+        bool Running = false;
+
+        UnorderedMap<UInt64, Vector<glm::vec3>> Cache;
+        QueueArray<UInt64> CacheOrder;
+    } sData;
+};
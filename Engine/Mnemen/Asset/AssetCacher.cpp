@@ -6,9 +6,14 @@
 #include <Asset/AssetCacher.hpp>
 #include <Core/Logger.hpp>
 #include <Core/Application.hpp>
+#include <Core/Timer.hpp>
+
+#include <DetourNavMesh.h>
 
 #include <filesystem>
 
+#include <sol/sol.hpp>
+
 AssetCacher::Data AssetCacher::sData;
 
 /// @brief A custom error handler for NVTT (NVIDIA Texture Tools).
@@ -101,14 +106,14 @@ private:
 };
 
 
-String AssetCacher::GetCachedAsset(const String& normalPath)
+UInt64 AssetCacher::Hash(const void* bytes, UInt64 size)
 {
     const UInt64 m = 0xc6a4a7935bd1e995ULL;
     const UInt32 r = 47;
 
-    UInt64 h = 1000 ^ (normalPath.size() * m);
-    const UInt64 * data = (const UInt64 *)normalPath.data();
-    const UInt64 * end = data + (normalPath.size() / 8);
+    UInt64 h = 1000 ^ (size * m);
+    const UInt64 * data = (const UInt64 *)bytes;
+    const UInt64 * end = data + (size / 8);
     while (data != end) {
         UInt64 k = *data++;
         k *= m;
@@ -120,7 +125,7 @@ String AssetCacher::GetCachedAsset(const String& normalPath)
     }
 
     const UInt8 * data2 = (const UInt8*)data;
-    switch(normalPath.size() & 7) {
+    switch(size & 7) {
         case 7: h ^= UInt64(data2[6]) << 48;
         case 6: h ^= UInt64(data2[5]) << 40;
         case 5: h ^= UInt64(data2[4]) << 32;
@@ -134,7 +139,12 @@ String AssetCacher::GetCachedAsset(const String& normalPath)
     h ^= h >> r;
     h *= m;
     h ^= h >> r;
-    return ".cache/" + String(std::to_string(h)) + ".ma";
+    return h;
+}
+
+String AssetCacher::GetCachedAsset(const String& normalPath)
+{
+    return ".cache/" + String(std::to_string(Hash(normalPath.data(), normalPath.size()))) + ".ma";
 }
 
 AssetFile AssetCacher::ReadAsset(const String& path)
@@ -157,6 +167,156 @@ AssetFile AssetCacher::ReadAsset(const String& path)
     return result;
 }
 
+bool AssetCacher::ReadScriptBytecode(const String& normalPath, Vector<UInt8>& bytecode)
+{
+    CacheAsset(normalPath);
+
+    // The cache is refreshed on file time, the content hash catches edits that kept it.
+    String source = File::ReadFile(normalPath);
+    UInt64 sourceHash = Hash(source.data(), source.size());
+
+    AssetFile file;
+    bool upToDate = false;
+    if (IsCached(normalPath)) {
+        file = ReadAsset(normalPath);
+
+        ScriptCacheHeader header = {};
+        if (file.Header.Type == AssetType::Script && file.Bytes.size() > sizeof(ScriptCacheHeader))
+            memcpy(&header, file.Bytes.data(), sizeof(ScriptCacheHeader));
+        upToDate = header.VMVersion == LUA_VERSION_NUM && header.NumberSize == sizeof(lua_Number) && header.SourceHash == sourceHash;
+    }
+
+    // Built by another VM or from an older source: rebuild it now, so the next load doesn't pay for this again.
+    if (!upToDate) {
+        LOG_INFO("Cached bytecode for {0} is out of date, recompiling it", normalPath);
+        file.Header = {};
+        file.Header.Filetime = File::GetLastModified(normalPath);
+        file.Header.Type = AssetType::Script;
+        if (!CompileScript(normalPath, source, file.Bytes))
+            return false;
+        WriteAsset(normalPath, file);
+    }
+
+    bytecode.assign(file.Bytes.begin() + sizeof(ScriptCacheHeader), file.Bytes.end());
+    return true;
+}
+
+bool AssetCacher::CompileScript(const String& normalPath, const String& source, Vector<UInt8>& bytes)
+{
+    ScriptCacheHeader header;
+    header.SourceHash = Hash(source.data(), source.size());
+    header.VMVersion = LUA_VERSION_NUM;
+    header.NumberSize = sizeof(lua_Number);
+
+    bytes.resize(sizeof(ScriptCacheHeader));
+    memcpy(bytes.data(), &header, sizeof(ScriptCacheHeader));
+
+    // Compiling only needs a bare state, nothing is run.
+    lua_State* L = luaL_newstate();
+    String chunkName = "@" + normalPath;
+    if (luaL_loadbufferx(L, source.data(), source.size(), chunkName.c_str(), "t") != LUA_OK) {
+        LOG_ERROR("Failed to compile script {0}: {1}", normalPath, lua_tostring(L, -1));
+        lua_close(L);
+        return false;
+    }
+
+    // Debug info is kept so errors still report file and line.
+    lua_dump(L, [](lua_State*, const void* p, size_t size, void* ud) -> int {
+        Vector<UInt8>* out = reinterpret_cast<Vector<UInt8>*>(ud);
+        const UInt8* data = reinterpret_cast<const UInt8*>(p);
+        out->insert(out->end(), data, data + size);
+        return 0;
+    }, &bytes, 0);
+    lua_close(L);
+    return true;
+}
+
+bool AssetCacher::ReadCollider(const String& meshPath, BakedShapeType type, Vector<UInt8>& bytes)
+{
+    // Colliders are cached under the mesh path plus a tag, next to the mesh's own entry.
+    String key = meshPath + (type == BakedShapeType::TriangleMesh ? "#collider-mesh" : "#collider-hulls");
+    File::Filetime meshFiletime = File::GetLastModified(meshPath);
+
+    if (IsCached(key)) {
+        AssetFile file = ReadAsset(key);
+
+        ColliderCacheHeader header = {};
+        if (file.Bytes.size() > sizeof(ColliderCacheHeader))
+            memcpy(&header, file.Bytes.data(), sizeof(ColliderCacheHeader));
+        if (file.Header.Type == AssetType::Collider && file.Header.Filetime == meshFiletime && header.Type == type && header.JoltVersion == JPH_VERSION_ID) {
+            bytes.assign(file.Bytes.begin() + sizeof(ColliderCacheHeader), file.Bytes.end());
+            return true;
+        }
+    }
+
+    Timer cookTimer;
+    PointCloud cloud(meshPath);
+    JPH::ShapeRefC shape = PhysicsShapes::Cook(cloud, type);
+    if (!shape) {
+        LOG_ERROR("Failed to bake collider for {0}", meshPath);
+        return false;
+    }
+    bytes.clear();
+    PhysicsShapes::Serialize(shape, bytes);
+    float cookTime = cookTimer.GetElapsed();
+
+    AssetFile file;
+    file.Header.Filetime = meshFiletime;
+    file.Header.Type = AssetType::Collider;
+
+    ColliderCacheHeader header = { type, JPH_VERSION_ID };
+    file.Bytes.resize(sizeof(ColliderCacheHeader));
+    memcpy(file.Bytes.data(), &header, sizeof(ColliderCacheHeader));
+    file.Bytes.insert(file.Bytes.end(), bytes.begin(), bytes.end());
+    WriteAsset(key, file);
+
+    // What the next loads will cost instead, restoring the baked shape.
+    Timer loadTimer;
+    PhysicsShapes::Deserialize(bytes.data(), bytes.size());
+    LOG_INFO("Baked collider {0} ({1}kb): cooking took {2}ms, loading the baked shape takes {3}ms", key, bytes.size() / 1024, cookTime, loadTimer.GetElapsed());
+    return true;
+}
+
+bool AssetCacher::ReadNavMesh(const String& meshPath, const NavMeshSettings& settings, bool tileCache, Vector<UInt8>& bytes)
+{
+    String key = meshPath + (tileCache ? "#navmesh-tilecache" : "#navmesh");
+    File::Filetime meshFiletime = File::GetLastModified(meshPath);
+    UInt64 settingsHash = Hash(&settings, sizeof(NavMeshSettings));
+
+    if (IsCached(key)) {
+        AssetFile file = ReadAsset(key);
+
+        NavMeshCacheHeader header = {};
+        if (file.Bytes.size() > sizeof(NavMeshCacheHeader))
+            memcpy(&header, file.Bytes.data(), sizeof(NavMeshCacheHeader));
+        if (file.Header.Type == AssetType::NavMesh && file.Header.Filetime == meshFiletime && header.SettingsHash == settingsHash && header.DetourVersion == DT_NAVMESH_VERSION && header.FormatVersion == NavMeshBuilder::FormatVersion && header.TileCache == tileCache) {
+            bytes.assign(file.Bytes.begin() + sizeof(NavMeshCacheHeader), file.Bytes.end());
+            return true;
+        }
+    }
+
+    PointCloud cloud(meshPath);
+    NavMeshBuildStats stats;
+    bool built = tileCache ? NavMeshBuilder::BuildTileCache(cloud, settings, bytes, &stats) : NavMeshBuilder::Build(cloud, settings, bytes, &stats);
+    if (!built) {
+        LOG_ERROR("Failed to build navmesh for {0}", meshPath);
+        return false;
+    }
+
+    AssetFile file;
+    file.Header.Filetime = meshFiletime;
+    file.Header.Type = AssetType::NavMesh;
+
+    NavMeshCacheHeader header = { settingsHash, DT_NAVMESH_VERSION, (UInt16)NavMeshBuilder::FormatVersion, (UInt16)tileCache };
+    file.Bytes.resize(sizeof(NavMeshCacheHeader));
+    memcpy(file.Bytes.data(), &header, sizeof(NavMeshCacheHeader));
+    file.Bytes.insert(file.Bytes.end(), bytes.begin(), bytes.end());
+    WriteAsset(key, file);
+
+    LOG_INFO("Built navmesh {0} ({1}kb): {2} tiles or layers over a {3} tile grid in {4}ms", key, bytes.size() / 1024, stats.BuiltTiles, stats.TileCount, stats.TotalMs);
+    return true;
+}
+
 AssetFile AssetCacher::ReadAssetHeader(const String& path)
 {
     String cached = GetCachedAsset(path);
@@ -234,6 +394,8 @@ AssetType AssetCacher::GetAssetTypeFromPath(const String& normalPath)
         return AssetType::Texture;
     if (extension == ".hlsl")
         return AssetType::Shader;
+    if (extension == ".lua")
+        return AssetType::Script;
 
     return AssetType::None;
 }
@@ -259,6 +421,7 @@ void AssetCacher::CacheAsset(const String& normalPath)
 
     AssetFile file;
     file.Header.Filetime = assetFiletime;
+    file.Header.Type = type;
 
     switch (type) {
         case AssetType::Texture: {
@@ -320,14 +483,25 @@ void AssetCacher::CacheAsset(const String& normalPath)
             memcpy(file.Bytes.data(), shader.Bytecode.data(), shader.Bytecode.size());
             break;
         }
+        case AssetType::Script: {
+            LOG_INFO("Caching script {0}", normalPath);
+            if (!CompileScript(normalPath, File::ReadFile(normalPath), file.Bytes))
+                return;
+            break;
+        }
     }
 
+    WriteAsset(normalPath, file);
+}
+
+void AssetCacher::WriteAsset(const String& normalPath, const AssetFile& file)
+{
     Vector<UInt8> bytesToWrite;
     bytesToWrite.resize(sizeof(AssetFile::Header));
     memcpy(bytesToWrite.data(), &file.Header, sizeof(AssetFile::Header));
     bytesToWrite.insert(bytesToWrite.end(), file.Bytes.begin(), file.Bytes.end());
 
-    File::WriteBytes(cached, bytesToWrite.data(), bytesToWrite.size());
+    File::WriteBytes(GetCachedAsset(normalPath), bytesToWrite.data(), bytesToWrite.size());
 }
 
 bool AssetCacher::IsCached(const String& normalPath)
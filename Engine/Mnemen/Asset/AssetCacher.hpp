@@ -9,6 +9,8 @@
 #include <Asset/Shader.hpp>
 #include <Core/File.hpp>
 #include <Core/Project.hpp>
+#include <Physics/PhysicsShapes.hpp>
+#include <AI/NavMeshBuilder.hpp>
 
 #include <nvtt/nvtt.h>
 
@@ -43,6 +45,35 @@ struct AssetFile
     Vector<UInt8> Bytes; ///< The binary data of the asset.
 };
 
+/// @struct ScriptCacheHeader
+/// @brief Prefix of the bytes of a cached script, ahead of the Lua bytecode.
+///
+/// Kept in the payload rather than in AssetFile::Header so existing texture and shader cache entries stay readable.
+struct ScriptCacheHeader
+{
+    UInt64 SourceHash; ///< Hash of the source text the bytecode was compiled from.
+    UInt32 VMVersion; ///< LUA_VERSION_NUM of the VM that compiled the bytecode.
+    UInt32 NumberSize; ///< sizeof(lua_Number) of the VM that compiled the bytecode.
+};
+
+/// @struct ColliderCacheHeader
+/// @brief Prefix of the bytes of a baked collider, ahead of the serialized Jolt shape.
+struct ColliderCacheHeader
+{
+    BakedShapeType Type; ///< The kind of shape that was baked.
+    UInt32 JoltVersion; ///< JPH_VERSION_ID of the Jolt build that serialized the shape.
+};
+
+/// @struct NavMeshCacheHeader
+/// @brief Prefix of the bytes of a cached navmesh, ahead of the serialized tiles.
+struct NavMeshCacheHeader
+{
+    UInt64 SettingsHash; ///< Hash of the NavMeshSettings the navmesh was built with.
+    UInt32 DetourVersion; ///< DT_NAVMESH_VERSION of the Detour build that created the tiles.
+    UInt16 FormatVersion; ///< NavMeshBuilder::FormatVersion of the blob.
+    UInt16 TileCache; ///< Whether the blob holds tile cache layers rather than navmesh tiles.
+};
+
 /// @class AssetCacher
 /// @brief Manages asset caching and retrieval.
 ///
@@ -69,6 +100,33 @@ public:
     /// @return The AssetFile object containing the asset data.
     static AssetFile ReadAsset(const String& path);
 
+    /// @brief Reads the precompiled bytecode of a Lua script, recompiling and caching it first if it's stale or built by another VM.
+    /// @param normalPath The path of the .lua source.
+    /// @param bytecode Receives the Lua bytecode.
+    /// @return False if the script doesn't compile, in which case the source should be loaded instead to report the error.
+    static bool ReadScriptBytecode(const String& normalPath, Vector<UInt8>& bytecode);
+
+    /// @brief Reads the baked collision shape of a mesh, cooking and caching it first if it's missing or stale.
+    /// @param meshPath The path of the mesh file.
+    /// @param type The kind of shape to bake.
+    /// @param bytes Receives the serialized shape, to restore with `PhysicsShapes::Deserialize`.
+    /// @return False if the mesh can't produce that kind of shape.
+    static bool ReadCollider(const String& meshPath, BakedShapeType type, Vector<UInt8>& bytes);
+
+    /// @brief Reads the navmesh of a mesh, building and caching it first if it's missing, stale or built with other settings.
+    /// @param meshPath The path of the mesh file.
+    /// @param settings The build parameters.
+    /// @param tileCache Whether to read the tile cache layers of the mesh, for dynamic obstacles, rather than a static navmesh.
+    /// @param bytes Receives the serialized tiles, to load with `NavMeshBuilder::Load` or `NavMeshBuilder::LoadTileCache`.
+    /// @return False if the mesh has no walkable surface.
+    static bool ReadNavMesh(const String& meshPath, const NavMeshSettings& settings, bool tileCache, Vector<UInt8>& bytes);
+
+    /// @brief Hashes a block of memory (MurmurHash64A).
+    /// @param data The data to hash.
+    /// @param size The size of the data in bytes.
+    /// @return The 64-bit hash.
+    static UInt64 Hash(const void* data, UInt64 size);
+
 private:
     friend class AssetManager; ///< Allows AssetManager to access private members.
 
@@ -99,6 +157,18 @@ private:
     /// @return The corresponding AssetType.
     static AssetType GetAssetTypeFromPath(const String& normalPath);
 
+    /// @brief Compiles a Lua script to bytecode, prefixed with a ScriptCacheHeader.
+    /// @param normalPath The path of the .lua source, used as the chunk name.
+    /// @param source The source text.
+    /// @param bytes Receives the header and the bytecode.
+    /// @return True if the script compiled.
+    static bool CompileScript(const String& normalPath, const String& source, Vector<UInt8>& bytes);
+
+    /// @brief Writes a cache entry, header then bytes.
+    /// @param normalPath The path the entry is cached under.
+    /// @param file The header and bytes to write.
+    static void WriteAsset(const String& normalPath, const AssetFile& file);
+
     /// @brief Retrieves the cached asset file path.
     /// @param normalPath The file path of the original asset.
     /// @return The cached asset file path.
@@ -9,6 +9,8 @@
 #include <Core/Logger.hpp>
 #include <RHI/Uploader.hpp>
 #include <Core/Profiler.hpp>
+#include <Core/Metrics.hpp>
+#include <Core/MemoryTracker.hpp>
 #include <Core/Application.hpp>
 
 AssetManager::Data AssetManager::sData;
@@ -72,6 +74,8 @@ Asset::Handle AssetManager::Get(const String& path, AssetType type)
         return sData.mAssets[path];
     }
 
+    MEMORY_TAG(MemoryTag::Asset);
+    UInt64 loadStart = Profiler::GetTicks();
     Asset::Handle asset = MakeRef<Asset>();
     asset->RefCount = 1;
     asset->Type = type;
@@ -148,7 +152,7 @@ Asset::Handle AssetManager::Get(const String& path, AssetType type)
             asset->Audio = MakeRef<AudioFile>(path);
             if (!asset->Audio->IsValid()) {
                 asset.reset();
-                nullptr;
+                return nullptr;
             }
             break;
         }
@@ -158,6 +162,9 @@ Asset::Handle AssetManager::Get(const String& path, AssetType type)
         }
     }
 
+    Profiler::RecordAssetLoad(path, loadStart);
+    COUNTER_ADD("Assets Loaded", 1);
+    COUNTER_ADD("Asset Bytes Loaded", File::GetFileSize(path));
     sData.mAssets[path] = asset;
     return asset;
 }
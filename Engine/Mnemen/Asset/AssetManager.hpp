@@ -28,6 +28,8 @@ enum class AssetType
     Script,           ///< A game script.
     Audio,            ///< An audio file.
     PostFXVolume,     ///< A post processing volume.
+    Collider,         ///< A collision shape baked from a mesh.
+    NavMesh,          ///< A navigation mesh built from a mesh.
     MAX               ///< Max enum.
 };
 
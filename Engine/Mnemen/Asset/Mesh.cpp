@@ -5,6 +5,7 @@
 
 #include "Mesh.hpp"
 #include "Core/Logger.hpp"
+#include "Core/MemoryTracker.hpp"
 
 #include <meshoptimizer.h>
 
@@ -13,6 +14,7 @@
 
 void Mesh::Load(RHI::Ref rhi, const String& path)
 {
+    MEMORY_TAG(MemoryTag::MeshImport);
     mRHI = rhi;
     Path = path;
     Directory = path.substr(0, path.find_last_of('/'));
@@ -0,0 +1,144 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-03 10:52:40
+//
+
+#include "AudioEmitterBatch.hpp"
+
+#include <Core/Profiler.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define AUDIO_BATCH_SSE
+#endif
+
+static constexpr float MinDistanceEpsilon = 0.0001f;
+static constexpr float MinPitch = 0.5f;
+static constexpr float MaxPitch = 2.0f;
+
+void AudioEmitterBatch::Clear()
+{
+    mCount = 0;
+    for (Vector<float>* array : { &mPositionX, &mPositionY, &mPositionZ, &mVelocityX, &mVelocityY, &mVelocityZ, &mForwardX, &mForwardY, &mForwardZ,
+                                  &mVolume, &mMinDistance, &mMaxDistance, &mRolloff, &mCosInner, &mCosOuter, &mOuterGain, &mDoppler })
+        array->clear();
+}
+
+void AudioEmitterBatch::Add(const AudioEmitter& emitter)
+{
+    // Cones are stored as cosines of their half angles, a full circle falls below any cosine.
+    float cosInner = emitter.ConeInnerAngle >= 360.0f ? -2.0f : glm::cos(glm::radians(emitter.ConeInnerAngle * 0.5f));
+    float cosOuter = emitter.ConeOuterAngle >= 360.0f ? -3.0f : glm::cos(glm::radians(emitter.ConeOuterAngle * 0.5f));
+    cosOuter = glm::min(cosOuter, cosInner - 0.0001f);
+
+    float minDistance = glm::max(emitter.MinDistance, 0.001f);
+
+    mPositionX.push_back(emitter.Position.x);
+    mPositionY.push_back(emitter.Position.y);
+    mPositionZ.push_back(emitter.Position.z);
+    mVelocityX.push_back(emitter.Velocity.x);
+    mVelocityY.push_back(emitter.Velocity.y);
+    mVelocityZ.push_back(emitter.Velocity.z);
+    mForwardX.push_back(emitter.Forward.x);
+    mForwardY.push_back(emitter.Forward.y);
+    mForwardZ.push_back(emitter.Forward.z);
+    mVolume.push_back(emitter.Volume);
+    mMinDistance.push_back(minDistance);
+    mMaxDistance.push_back(glm::max(emitter.MaxDistance, minDistance));
+    mRolloff.push_back(glm::max(emitter.Rolloff, 0.0f));
+    mCosInner.push_back(cosInner);
+    mCosOuter.push_back(cosOuter);
+    mOuterGain.push_back(emitter.ConeOuterGain);
+    mDoppler.push_back(emitter.DopplerFactor);
+    mCount++;
+}
+
+void AudioEmitterBatch::Process(const AudioListener& listener)
+{
+    PROFILE_FUNCTION();
+
+    mGain.resize(mCount);
+    mPitch.resize(mCount);
+
+#ifdef AUDIO_BATCH_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 epsilon = _mm_set1_ps(MinDistanceEpsilon);
+    const __m128 speedOfSound = _mm_set1_ps(SpeedOfSound);
+    const __m128 maxSpeed = _mm_set1_ps(SpeedOfSound * 0.5f);
+    const __m128 minSpeed = _mm_set1_ps(-SpeedOfSound * 0.5f);
+    const __m128 minPitch = _mm_set1_ps(MinPitch);
+    const __m128 maxPitch = _mm_set1_ps(MaxPitch);
+    const __m128 lx = _mm_set1_ps(listener.Position.x);
+    const __m128 ly = _mm_set1_ps(listener.Position.y);
+    const __m128 lz = _mm_set1_ps(listener.Position.z);
+    const __m128 lvx = _mm_set1_ps(listener.Velocity.x);
+    const __m128 lvy = _mm_set1_ps(listener.Velocity.y);
+    const __m128 lvz = _mm_set1_ps(listener.Velocity.z);
+
+    UInt32 blockEnd = mCount & ~3u;
+    for (UInt32 i = 0; i < blockEnd; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&mPositionX[i]), lx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&mPositionY[i]), ly);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(&mPositionZ[i]), lz);
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+        __m128 onListener = _mm_cmplt_ps(distance, epsilon);
+        __m128 inverseDistance = _mm_div_ps(one, _mm_max_ps(distance, epsilon));
+        __m128 ux = _mm_mul_ps(dx, inverseDistance);
+        __m128 uy = _mm_mul_ps(dy, inverseDistance);
+        __m128 uz = _mm_mul_ps(dz, inverseDistance);
+
+        // Inverse distance, clamped between the min and max distance.
+        __m128 minDistance = _mm_loadu_ps(&mMinDistance[i]);
+        __m128 clamped = _mm_min_ps(_mm_max_ps(distance, minDistance), _mm_loadu_ps(&mMaxDistance[i]));
+        __m128 attenuation = _mm_div_ps(minDistance, _mm_add_ps(minDistance, _mm_mul_ps(_mm_loadu_ps(&mRolloff[i]), _mm_sub_ps(clamped, minDistance))));
+
+        // Cone, from the angle between the emitter's forward axis and the direction to the listener.
+        __m128 cosAngle = _mm_sub_ps(zero, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&mForwardX[i]), ux), _mm_mul_ps(_mm_loadu_ps(&mForwardY[i]), uy)), _mm_mul_ps(_mm_loadu_ps(&mForwardZ[i]), uz)));
+        cosAngle = _mm_or_ps(_mm_and_ps(onListener, one), _mm_andnot_ps(onListener, cosAngle));
+        __m128 cosInner = _mm_loadu_ps(&mCosInner[i]);
+        __m128 cosOuter = _mm_loadu_ps(&mCosOuter[i]);
+        __m128 t = _mm_div_ps(_mm_sub_ps(cosAngle, cosOuter), _mm_sub_ps(cosInner, cosOuter));
+        t = _mm_min_ps(_mm_max_ps(t, zero), one);
+        __m128 outerGain = _mm_loadu_ps(&mOuterGain[i]);
+        __m128 cone = _mm_add_ps(outerGain, _mm_mul_ps(_mm_sub_ps(one, outerGain), t));
+
+        __m128 gain = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&mVolume[i]), attenuation), cone);
+        _mm_storeu_ps(&mGain[i], gain);
+
+        // Doppler, from both velocities projected on the axis between the listener and the emitter.
+        __m128 doppler = _mm_loadu_ps(&mDoppler[i]);
+        __m128 listenerSpeed = _mm_mul_ps(doppler, _mm_add_ps(_mm_add_ps(_mm_mul_ps(lvx, ux), _mm_mul_ps(lvy, uy)), _mm_mul_ps(lvz, uz)));
+        __m128 emitterSpeed = _mm_mul_ps(doppler, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&mVelocityX[i]), ux), _mm_mul_ps(_mm_loadu_ps(&mVelocityY[i]), uy)), _mm_mul_ps(_mm_loadu_ps(&mVelocityZ[i]), uz)));
+        listenerSpeed = _mm_min_ps(_mm_max_ps(listenerSpeed, minSpeed), maxSpeed);
+        emitterSpeed = _mm_min_ps(_mm_max_ps(emitterSpeed, minSpeed), maxSpeed);
+        __m128 pitch = _mm_div_ps(_mm_add_ps(speedOfSound, listenerSpeed), _mm_add_ps(speedOfSound, emitterSpeed));
+        _mm_storeu_ps(&mPitch[i], _mm_min_ps(_mm_max_ps(pitch, minPitch), maxPitch));
+    }
+    ProcessScalar(listener, blockEnd, mCount);
+#else
+    ProcessScalar(listener, 0, mCount);
+#endif
+}
+
+void AudioEmitterBatch::ProcessScalar(const AudioListener& listener, UInt32 begin, UInt32 end)
+{
+    for (UInt32 i = begin; i < end; i++) {
+        glm::vec3 delta = glm::vec3(mPositionX[i], mPositionY[i], mPositionZ[i]) - listener.Position;
+        float distance = glm::length(delta);
+        glm::vec3 direction = delta / glm::max(distance, MinDistanceEpsilon);
+
+        float clamped = glm::clamp(distance, mMinDistance[i], mMaxDistance[i]);
+        float attenuation = mMinDistance[i] / (mMinDistance[i] + mRolloff[i] * (clamped - mMinDistance[i]));
+
+        float cosAngle = distance < MinDistanceEpsilon ? 1.0f : -glm::dot(glm::vec3(mForwardX[i], mForwardY[i], mForwardZ[i]), direction);
+        float t = glm::clamp((cosAngle - mCosOuter[i]) / (mCosInner[i] - mCosOuter[i]), 0.0f, 1.0f);
+        float cone = mOuterGain[i] + (1.0f - mOuterGain[i]) * t;
+
+        mGain[i] = mVolume[i] * attenuation * cone;
+
+        float listenerSpeed = glm::clamp(mDoppler[i] * glm::dot(listener.Velocity, direction), -SpeedOfSound * 0.5f, SpeedOfSound * 0.5f);
+        float emitterSpeed = glm::clamp(mDoppler[i] * glm::dot(glm::vec3(mVelocityX[i], mVelocityY[i], mVelocityZ[i]), direction), -SpeedOfSound * 0.5f, SpeedOfSound * 0.5f);
+        mPitch[i] = glm::clamp((SpeedOfSound + listenerSpeed) / (SpeedOfSound + emitterSpeed), MinPitch, MaxPitch);
+    }
+}
@@ -0,0 +1,69 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-03 10:37:12
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+
+#include <glm/glm.hpp>
+
+/// @brief The spatial parameters of an emitter, as handed to the batch.
+struct AudioEmitter
+{
+    glm::vec3 Position;
+    glm::vec3 Velocity;
+    glm::vec3 Forward;
+    float Volume;
+    float MinDistance;    ///< Full volume closer than this.
+    float MaxDistance;    ///< The attenuation stops here.
+    float Rolloff;        ///< How fast the volume falls between the two distances.
+    float ConeInnerAngle; ///< Full volume inside this cone around the forward axis, in degrees. 360 is omnidirectional.
+    float ConeOuterAngle; ///< `ConeOuterGain` outside this cone, in degrees.
+    float ConeOuterGain;
+    float DopplerFactor;  ///< 0 disables the doppler effect.
+};
+
+/// @brief Where the listener is and how fast it moves.
+struct AudioListener
+{
+    glm::vec3 Position = glm::vec3(0.0f);
+    glm::vec3 Velocity = glm::vec3(0.0f);
+};
+
+/// @brief Computes the gain and pitch of thousands of emitters in one pass, before any of them reaches miniaudio.
+///
+/// Emitters are stored as structure of arrays so the pass runs four at a time with SSE: inverse distance
+/// attenuation clamped between the min and max distance, cone attenuation and doppler pitch. Only the
+/// emitters that end up audible are worth a voice, and the voices get the gain and pitch from here.
+class AudioEmitterBatch
+{
+public:
+    /// @brief The speed of sound, in world units per second.
+    static constexpr float SpeedOfSound = 343.0f;
+
+    /// @brief Removes every emitter.
+    void Clear();
+
+    /// @brief Adds an emitter, its index is the number of emitters before it.
+    void Add(const AudioEmitter& emitter);
+
+    /// @brief Computes the gain and pitch of every emitter.
+    void Process(const AudioListener& listener);
+
+    UInt32 GetCount() const { return mCount; }
+    float GetGain(UInt32 index) const { return mGain[index]; }
+    float GetPitch(UInt32 index) const { return mPitch[index]; }
+private:
+    /// @brief The reference version of the pass, also used where SSE isn't available.
+    void ProcessScalar(const AudioListener& listener, UInt32 begin, UInt32 end);
+
+    UInt32 mCount = 0;
+    Vector<float> mPositionX, mPositionY, mPositionZ;
+    Vector<float> mVelocityX, mVelocityY, mVelocityZ;
+    Vector<float> mForwardX, mForwardY, mForwardZ;
+    Vector<float> mVolume, mMinDistance, mMaxDistance, mRolloff;
+    Vector<float> mCosInner, mCosOuter, mOuterGain, mDoppler;
+    Vector<float> mGain, mPitch;
+};
@@ -4,24 +4,87 @@
 //
 
 #include "AudioFile.hpp"
+#include "AudioStream.hpp"
+#include "AudioSystem.hpp"
 
 #include <Core/Logger.hpp>
-#include <Audio/AudioSystem.hpp>
 
-AudioFile::AudioFile(const String& path)
+AudioFile::AudioFile(const String& path, AudioDecodeMode mode)
+    : mPath(path), mMode(mode)
 {
-    auto engine = AudioSystem::GetEngine();
-
-    ma_result result = ma_decoder_init_file(path.c_str(), nullptr, &mDecoder);
-    if (result != MA_SUCCESS) {
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 0, 0);
+    ma_decoder decoder;
+    if (ma_decoder_init_file(path.c_str(), &config, &decoder) != MA_SUCCESS) {
         LOG_ERROR("Failed to load audio file {0}", path);
-        mValid = false;
+        return;
     }
+    mChannels = decoder.outputChannels;
+    mSampleRate = decoder.outputSampleRate;
+
+    // Compressed formats may not know their length without decoding, those are streamed to be safe.
+    ma_uint64 length = 0;
+    bool known = ma_decoder_get_length_in_pcm_frames(&decoder, &length) == MA_SUCCESS && length > 0;
+    if (mMode == AudioDecodeMode::Auto)
+        mMode = known && length < (ma_uint64)(StreamThreshold * mSampleRate) ? AudioDecodeMode::Predecoded : AudioDecodeMode::Streamed;
+
+    if (mMode == AudioDecodeMode::Streamed) {
+        mFrameCount = known ? length : 0;
+    } else {
+        const ma_uint64 chunkFrames = 4096;
+        for (;;) {
+            mFrames.resize((mFrameCount + chunkFrames) * mChannels);
+            ma_uint64 decoded = 0;
+            ma_decoder_read_pcm_frames(&decoder, mFrames.data() + mFrameCount * mChannels, chunkFrames, &decoded);
+            mFrameCount += decoded;
+            if (decoded < chunkFrames)
+                break;
+        }
+        mFrames.resize(mFrameCount * mChannels);
+        mFrames.shrink_to_fit();
+    }
+
+    ma_decoder_uninit(&decoder);
     mValid = true;
 }
 
 AudioFile::~AudioFile()
 {
-    ma_decoder_uninit(&mDecoder);
     mValid = false;
 }
+
+ma_data_source* AudioFile::CreateSource()
+{
+    if (!mValid)
+        return nullptr;
+
+    if (mMode == AudioDecodeMode::Streamed) {
+        AudioStream* stream = new AudioStream(mPath, mChannels, mSampleRate);
+        return stream->GetDataSource();
+    }
+
+    // The PCM is shared, the buffer only holds a cursor over it.
+    ma_audio_buffer_config config = ma_audio_buffer_config_init(ma_format_f32, mChannels, mFrameCount, mFrames.data(), nullptr);
+    config.sampleRate = mSampleRate;
+    ma_audio_buffer* buffer = new ma_audio_buffer;
+    if (ma_audio_buffer_init(&config, buffer) != MA_SUCCESS) {
+        LOG_ERROR("Failed to create audio buffer for {0}", mPath);
+        delete buffer;
+        return nullptr;
+    }
+    return buffer;
+}
+
+void AudioFile::FreeSource(ma_data_source* source)
+{
+    if (!source)
+        return;
+
+    if (mMode == AudioDecodeMode::Streamed) {
+        AudioSystem::RemoveStream(AudioStream::FromDataSource(source));
+        return;
+    }
+
+    ma_audio_buffer* buffer = (ma_audio_buffer*)source;
+    ma_audio_buffer_uninit(buffer);
+    delete buffer;
+}
@@ -9,17 +9,48 @@
 
 #include <miniaudio.h>
 
+/// @brief How an audio file is decoded.
+enum class AudioDecodeMode
+{
+    Auto,       ///< Pre-decoded if shorter than `AudioFile::StreamThreshold`, streamed otherwise.
+    Predecoded, ///< Decoded to PCM once at load, shared by every sound. For short effects.
+    Streamed    ///< Decoded while playing into a small buffer per sound. For music and long tracks.
+};
+
+/// @brief An audio asset. Sounds don't read it directly but from sources it creates, each with its own cursor.
 class AudioFile
 {
 public:
     using Ref = Ref<AudioFile>;
 
-    AudioFile(const String& path);
+    /// @brief Files longer than this, in seconds, are streamed in `AudioDecodeMode::Auto`.
+    static constexpr float StreamThreshold = 10.0f;
+
+    AudioFile(const String& path, AudioDecodeMode mode = AudioDecodeMode::Auto);
     ~AudioFile();
 
     bool IsValid() { return mValid; }
-    ma_decoder* GetDecoder() { return &mDecoder; }
+    AudioDecodeMode GetMode() { return mMode; }
+    UInt32 GetSampleRate() { return mSampleRate; }
+
+    /// @brief The length of the file in seconds, 0 if the decoder can't tell without decoding it all.
+    float GetLength() { return mSampleRate ? (float)mFrameCount / mSampleRate : 0.0f; }
+
+    /// @brief Creates a data source with its own cursor for a sound to read from: a view of the PCM if pre-decoded, a stream otherwise.
+    /// @return The data source, to free with `FreeSource` once the sound is uninitialized, or null on failure.
+    ma_data_source* CreateSource();
+
+    /// @brief Frees a data source created by `CreateSource`.
+    void FreeSource(ma_data_source* source);
 private:
     bool mValid = false;
-    ma_decoder mDecoder;
+    String mPath;
+    AudioDecodeMode mMode;
+
+    UInt32 mChannels = 0;
+    UInt32 mSampleRate = 0;
+    UInt64 mFrameCount = 0;
+
+    // Pre-decoded only.
+    Vector<float> mFrames;
 };
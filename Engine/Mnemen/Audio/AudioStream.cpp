@@ -0,0 +1,177 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-02 14:26:50
+//
+
+#include "AudioStream.hpp"
+#include "AudioSystem.hpp"
+
+#include <Core/Logger.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+// The stream handles its own looping, miniaudio mustn't seek back to the start at the end of the file.
+ma_data_source_vtable AudioStream::sVTable = {
+    AudioStream::OnRead,
+    AudioStream::OnSeek,
+    AudioStream::OnGetDataFormat,
+    nullptr,
+    nullptr,
+    AudioStream::OnSetLooping,
+    MA_DATA_SOURCE_SELF_MANAGED_RANGE_AND_LOOP_POINT
+};
+
+AudioStream::AudioStream(const String& path, UInt32 channels, UInt32 sampleRate)
+    : mPath(path), mChannels(channels), mSampleRate(sampleRate)
+{
+    ma_data_source_config sourceConfig = ma_data_source_config_init();
+    sourceConfig.vtable = &sVTable;
+    ma_data_source_init(&sourceConfig, &mSource.Base);
+    mSource.Stream = this;
+
+    // Voices create streams on the main thread, opening the file is left to the streaming thread.
+    AudioSystem::AddStream(this);
+}
+
+AudioStream::~AudioStream()
+{
+    ma_data_source_uninit(&mSource.Base);
+    if (!mOpened)
+        return;
+    ma_pcm_rb_uninit(&mBuffer);
+    ma_decoder_uninit(&mDecoder);
+}
+
+bool AudioStream::Open()
+{
+    // Decoded to the format the file reported at load, the one the sound was created with.
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, mChannels, mSampleRate);
+    if (ma_decoder_init_file(mPath.c_str(), &config, &mDecoder) != MA_SUCCESS) {
+        LOG_ERROR("Failed to open audio stream {0}", mPath);
+        return false;
+    }
+
+    UInt32 frameCount = mSampleRate * BufferMs / 1000;
+    if (ma_pcm_rb_init(ma_format_f32, mChannels, frameCount, nullptr, nullptr, &mBuffer) != MA_SUCCESS) {
+        LOG_ERROR("Failed to allocate audio stream buffer for {0}", mPath);
+        ma_decoder_uninit(&mDecoder);
+        return false;
+    }
+    return true;
+}
+
+void AudioStream::Pump()
+{
+    if (mFailed.load(std::memory_order_relaxed))
+        return;
+    if (!mOpened) {
+        if (!Open()) {
+            mFailed.store(true, std::memory_order_release);
+            return;
+        }
+        mOpened = true;
+    }
+
+    Int64 seekFrame = mSeekFrame.load(std::memory_order_acquire);
+    if (seekFrame >= 0) {
+        ma_pcm_rb_reset(&mBuffer);
+        ma_decoder_seek_to_pcm_frame(&mDecoder, (ma_uint64)seekFrame);
+        mDecoderAtEnd.store(false, std::memory_order_relaxed);
+    } else if (mLooping.load(std::memory_order_relaxed) && mDecoderAtEnd.load(std::memory_order_relaxed)) {
+        // Looping was turned on after the whole file was decoded.
+        ma_decoder_seek_to_pcm_frame(&mDecoder, 0);
+        mDecoderAtEnd.store(false, std::memory_order_relaxed);
+    }
+
+    bool wrapped = false;
+    while (!mDecoderAtEnd.load(std::memory_order_relaxed)) {
+        ma_uint32 space = ma_pcm_rb_available_write(&mBuffer);
+        if (space == 0)
+            break;
+
+        void* data = nullptr;
+        ma_pcm_rb_acquire_write(&mBuffer, &space, &data);
+        ma_uint64 decoded = 0;
+        ma_decoder_read_pcm_frames(&mDecoder, data, space, &decoded);
+        ma_pcm_rb_commit_write(&mBuffer, (ma_uint32)decoded);
+        if (decoded == space)
+            continue;
+
+        // End of the file: wrap around when looping, once per pump in case the file is empty.
+        if (mLooping.load(std::memory_order_relaxed) && !wrapped) {
+            ma_decoder_seek_to_pcm_frame(&mDecoder, 0);
+            wrapped = true;
+        } else if (!mLooping.load(std::memory_order_relaxed)) {
+            mDecoderAtEnd.store(true, std::memory_order_release);
+        } else {
+            break;
+        }
+    }
+
+    // Hand the buffer back, unless the audio thread asked for another seek in the meantime.
+    if (seekFrame >= 0)
+        mSeekFrame.compare_exchange_strong(seekFrame, -1, std::memory_order_release);
+}
+
+ma_result AudioStream::OnRead(ma_data_source* source, void* output, ma_uint64 frameCount, ma_uint64* framesRead)
+{
+    AudioStream* stream = FromDataSource(source);
+    UInt32 channels = stream->mChannels;
+    float* frames = (float*)output;
+
+    // The file couldn't be opened, the sound ends right away.
+    if (stream->mFailed.load(std::memory_order_acquire)) {
+        *framesRead = 0;
+        return MA_AT_END;
+    }
+
+    ma_uint64 read = 0;
+    bool pending = stream->mSeekFrame.load(std::memory_order_acquire) >= 0;
+    bool atEnd = stream->mDecoderAtEnd.load(std::memory_order_acquire);
+    while (!pending && read < frameCount) {
+        ma_uint32 chunk = (ma_uint32)std::min(frameCount - read, (ma_uint64)UINT32_MAX);
+        void* data = nullptr;
+        ma_pcm_rb_acquire_read(&stream->mBuffer, &chunk, &data);
+        if (chunk == 0)
+            break;
+        memcpy(frames + read * channels, data, chunk * channels * sizeof(float));
+        ma_pcm_rb_commit_read(&stream->mBuffer, chunk);
+        read += chunk;
+    }
+
+    // Everything the decoder will ever write was already there, what's missing is the end of the file.
+    if (!pending && atEnd && read < frameCount) {
+        *framesRead = read;
+        return read == 0 ? MA_AT_END : MA_SUCCESS;
+    }
+
+    // The streaming thread is behind or handling a seek: play silence rather than ending the sound.
+    memset(frames + read * channels, 0, (frameCount - read) * channels * sizeof(float));
+    *framesRead = frameCount;
+    return MA_SUCCESS;
+}
+
+ma_result AudioStream::OnSeek(ma_data_source* source, ma_uint64 frame)
+{
+    // Sounds seek from the audio thread, the one reading, so the ring buffer is left alone until the seek is done.
+    FromDataSource(source)->mSeekFrame.store((Int64)frame, std::memory_order_release);
+    return MA_SUCCESS;
+}
+
+ma_result AudioStream::OnGetDataFormat(ma_data_source* source, ma_format* format, ma_uint32* channels, ma_uint32* sampleRate, ma_channel* channelMap, size_t channelMapCap)
+{
+    AudioStream* stream = FromDataSource(source);
+    *format = ma_format_f32;
+    *channels = stream->mChannels;
+    *sampleRate = stream->mSampleRate;
+    if (channelMap)
+        ma_channel_map_init_standard(ma_standard_channel_map_default, channelMap, channelMapCap, stream->mChannels);
+    return MA_SUCCESS;
+}
+
+ma_result AudioStream::OnSetLooping(ma_data_source* source, ma_bool32 looping)
+{
+    FromDataSource(source)->mLooping.store(looping != MA_FALSE, std::memory_order_relaxed);
+    return MA_SUCCESS;
+}
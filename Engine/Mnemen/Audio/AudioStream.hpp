@@ -0,0 +1,75 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-02 14:08:21
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+
+#include <miniaudio.h>
+
+#include <atomic>
+
+/// @brief A file decoded on the streaming thread into a small ring buffer, for one sound to read from.
+///
+/// Each stream owns its decoder, so any number of sounds can stream the same file with their own cursor,
+/// and only holds `BufferMs` of decoded audio however long the file is. The stream loops by itself when
+/// the sound loops, so the loop point doesn't wait on the streaming thread.
+///
+/// The decoder is opened by the first pump and closed by the destructor, which the streaming thread runs
+/// once the stream is retired with `AudioSystem::RemoveStream`, so voices never wait on a decoder.
+class AudioStream
+{
+public:
+    /// @brief Length of the ring buffer, in milliseconds.
+    static constexpr UInt32 BufferMs = 500;
+
+    /// @brief Creates a stream, the decoder is opened to this format later on the streaming thread.
+    AudioStream(const String& path, UInt32 channels, UInt32 sampleRate);
+    ~AudioStream();
+
+    /// @brief The data source a sound reads from.
+    ma_data_source* GetDataSource() { return &mSource.Base; }
+
+    /// @brief Gets the stream behind one of its data sources.
+    static AudioStream* FromDataSource(ma_data_source* source) { return ((Source*)source)->Stream; }
+
+    /// @brief Opens the decoder the first time, handles a pending seek and decodes into the free part of the
+    /// ring buffer. Streaming thread only.
+    void Pump();
+private:
+    /// @brief The miniaudio data source, its base has to come first.
+    struct Source
+    {
+        ma_data_source_base Base;
+        AudioStream* Stream;
+    };
+
+    static ma_result OnRead(ma_data_source* source, void* output, ma_uint64 frameCount, ma_uint64* framesRead);
+    static ma_result OnSeek(ma_data_source* source, ma_uint64 frame);
+    static ma_result OnGetDataFormat(ma_data_source* source, ma_format* format, ma_uint32* channels, ma_uint32* sampleRate, ma_channel* channelMap, size_t channelMapCap);
+    static ma_result OnSetLooping(ma_data_source* source, ma_bool32 looping);
+    static ma_data_source_vtable sVTable;
+
+    /// @brief Opens the decoder and the ring buffer. Returns false if the file can't be streamed.
+    bool Open();
+
+    String mPath;
+    UInt32 mChannels;
+    UInt32 mSampleRate;
+
+    // Streaming thread only.
+    bool mOpened = false;
+    Source mSource;
+    ma_decoder mDecoder;
+    ma_pcm_rb mBuffer;
+
+    // Written by the audio thread, handled by the streaming thread. While a seek is pending the audio thread
+    // stays away from the ring buffer and the streaming thread resets it. A new stream starts with a seek to
+    // the start pending, which keeps the audio thread off the ring buffer until the first pump allocated it.
+    std::atomic<Int64> mSeekFrame = 0;
+    std::atomic<bool> mFailed = false;
+    std::atomic<bool> mLooping = false;
+    std::atomic<bool> mDecoderAtEnd = false;
+};
@@ -4,10 +4,18 @@
 //
 
 #include "AudioSystem.hpp"
+#include "AudioStream.hpp"
 #include <iostream>
 
 #include <Core/Logger.hpp>
 #include <Core/Profiler.hpp>
+#include <Core/Metrics.hpp>
+#include <Core/MemoryTracker.hpp>
+#include <Core/Timer.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <random>
 
 AudioSystem::Data AudioSystem::sData;
 
@@ -23,40 +31,147 @@ void DataCallback(ma_device *pDevice, void *output, const void *input, ma_uint32
     ma_engine_read_pcm_frames(engine, output, frameCount, nullptr);
 }
 
-void AudioSystem::Init()
+void AudioSystem::Init(AudioBackend backend)
 {
-    ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
-    deviceConfig.playback.format = ma_format_f32;
-    deviceConfig.playback.channels = 2;
-    deviceConfig.sampleRate = 48000;
-    deviceConfig.dataCallback = DataCallback;
-    deviceConfig.pUserData = &sData.Engine;
+    sData.Backend = backend;
 
-    ma_result result = ma_device_init(nullptr, &deviceConfig, &sData.Device);
-    if (result != MA_SUCCESS) {
-        LOG_CRITICAL("Failed to initialize audio device!");
-    }
+    if (backend == AudioBackend::Device) {
+        ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
+        deviceConfig.playback.format = ma_format_f32;
+        deviceConfig.playback.channels = ChannelCount;
+        deviceConfig.sampleRate = SampleRate;
+        deviceConfig.dataCallback = DataCallback;
+        deviceConfig.pUserData = &sData.Engine;
 
-    char name[512];
-    ma_device_get_name(&sData.Device, ma_device_type_playback, name, 512, nullptr);
-    LOG_INFO("Using audio device {0}", name);
+        ma_result result = ma_device_init(nullptr, &deviceConfig, &sData.Device);
+        if (result == MA_SUCCESS) {
+            char name[512];
+            ma_device_get_name(&sData.Device, ma_device_type_playback, name, 512, nullptr);
+            LOG_INFO("Using audio device {0}", name);
+        } else {
+            LOG_WARN("Failed to initialize audio device, falling back to the null audio backend");
+            sData.Backend = AudioBackend::Null;
+        }
+    }
 
     ma_engine_config engineConfig = ma_engine_config_init();
-    engineConfig.pDevice = &sData.Device;
     engineConfig.listenerCount = 1;
+    if (sData.Backend == AudioBackend::Device) {
+        engineConfig.pDevice = &sData.Device;
+    } else {
+        engineConfig.noDevice = MA_TRUE;
+        engineConfig.channels = ChannelCount;
+        engineConfig.sampleRate = SampleRate;
+    }
 
-    result = ma_engine_init(&engineConfig, &sData.Engine);
+    ma_result result = ma_engine_init(&engineConfig, &sData.Engine);
     if (result != MA_SUCCESS) {
         LOG_CRITICAL("Failed to initialize audio engine!");
     }
 
-    LOG_INFO("Initialized Audio system");
+    // Offline rendering fills the streams itself, in order, so nothing runs in the background.
+    if (sData.Backend != AudioBackend::Offline) {
+        sData.Streaming = true;
+        sData.Streamer = std::thread(StreamThread);
+    }
+    if (sData.Backend == AudioBackend::Null) {
+        sData.Mixing = true;
+        sData.Mixer = std::thread(MixThread);
+    }
+
+    const char* backends[] = { "device", "null", "offline" };
+    LOG_INFO("Initialized Audio system ({0} backend)", backends[(int)sData.Backend]);
 }
 
 void AudioSystem::Exit()
 {
+    for (Int32 i = 0; i < (Int32)MaxVoices; i++)
+        ReleaseVoice(i);
+
+    sData.Mixing = false;
+    if (sData.Mixer.joinable())
+        sData.Mixer.join();
+    StopCapture();
+
+    sData.Streaming = false;
+    if (sData.Streamer.joinable())
+        sData.Streamer.join();
+    // Every voice is released, this only deletes the retired streams.
+    PumpStreams();
+
     ma_engine_uninit(&sData.Engine);
-    ma_device_uninit(&sData.Device);
+    if (sData.Backend == AudioBackend::Device)
+        ma_device_uninit(&sData.Device);
+}
+
+void AudioSystem::Render(UInt32 frameCount, float* output)
+{
+    PROFILE_FUNCTION();
+
+    if (sData.Backend != AudioBackend::Offline) {
+        LOG_WARN("AudioSystem::Render only works with the offline audio backend");
+        return;
+    }
+
+    if (!output) {
+        sData.MixBuffer.resize(frameCount * ChannelCount);
+        output = sData.MixBuffer.data();
+    }
+
+    PumpStreams();
+    Mix(frameCount, output);
+}
+
+bool AudioSystem::StartCapture(const String& path)
+{
+    if (sData.Backend == AudioBackend::Device) {
+        LOG_WARN("Audio capture needs the null or offline audio backend");
+        return false;
+    }
+
+    StopCapture();
+
+    std::lock_guard<std::mutex> lock(sData.CaptureMutex);
+    ma_encoder_config config = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, ChannelCount, SampleRate);
+    if (ma_encoder_init_file(path.c_str(), &config, &sData.Encoder) != MA_SUCCESS) {
+        LOG_ERROR("Failed to create audio capture {0}", path);
+        return false;
+    }
+    sData.Capturing = true;
+    LOG_INFO("Capturing audio to {0}", path);
+    return true;
+}
+
+void AudioSystem::StopCapture()
+{
+    std::lock_guard<std::mutex> lock(sData.CaptureMutex);
+    if (!sData.Capturing)
+        return;
+    ma_encoder_uninit(&sData.Encoder);
+    sData.Capturing = false;
+}
+
+void AudioSystem::Mix(UInt32 frameCount, float* output)
+{
+    ma_engine_read_pcm_frames(&sData.Engine, output, frameCount, nullptr);
+
+    std::lock_guard<std::mutex> lock(sData.CaptureMutex);
+    if (sData.Capturing)
+        ma_encoder_write_pcm_frames(&sData.Encoder, output, frameCount, nullptr);
+}
+
+void AudioSystem::MixThread()
+{
+    // Mix a fixed slice per interval against a steady deadline, so the mix keeps pace with real time.
+    const UInt32 frameCount = SampleRate * NullIntervalMs / 1000;
+    Vector<float> buffer(frameCount * ChannelCount);
+
+    auto deadline = std::chrono::steady_clock::now();
+    while (sData.Mixing) {
+        Mix(frameCount, buffer.data());
+        deadline += std::chrono::milliseconds(NullIntervalMs);
+        std::this_thread::sleep_until(deadline);
+    }
 }
 
 void AudioSystem::Awake(Ref<Scene> scene)
@@ -71,16 +186,110 @@ void AudioSystem::Awake(Ref<Scene> scene)
     }
 }
 
-void AudioSystem::Update(Ref<Scene> scene)
+void AudioSystem::Update(Ref<Scene> scene, float dt)
 {
     PROFILE_FUNCTION();
+    MEMORY_TAG(MemoryTag::Audio);
 
     entt::registry* registry = scene->GetRegistry();
-    auto view = registry->view<AudioSourceComponent>();
+    UpdateListener(registry, dt);
 
+    auto view = registry->view<AudioSourceComponent>();
+    sData.Candidates.clear();
+    sData.Emitters.Clear();
+    sData.EmitterEntities.clear();
     for (auto [id, source] : view.each()) {
-        source.Update();
+        if (source.Voice >= 0) {
+            Voice& voice = sData.Voices[source.Voice];
+            if (ma_sound_at_end(&voice.Sound))
+                source.Playing = false;
+            if (!source.Playing) {
+                ReleaseVoice(source.Voice);
+                source.Voice = -1;
+                source.Cursor = 0.0f;
+                continue;
+            }
+            if (source.Restart)
+                ma_sound_seek_to_pcm_frame(&voice.Sound, 0);
+        }
+        source.Restart = false;
+        if (!source.Playing)
+            continue;
+
+        // Real or virtual, the cursor follows time, so a source that gets its voice back resumes where it would be.
+        float length = source.Handle->Audio->GetLength();
+        source.Cursor += dt;
+        if (length > 0.0f && source.Cursor >= length) {
+            if (source.Looping) {
+                source.Cursor = glm::mod(source.Cursor, length);
+            } else if (source.Voice < 0) {
+                source.Playing = false;
+                source.Cursor = 0.0f;
+                continue;
+            }
+        }
+
+        // Spatial sources get their gain from the emitter batch, the others from their volume alone.
+        TransformComponent* transform = source.Spatial ? registry->try_get<TransformComponent>(id) : nullptr;
+        if (!transform) {
+            AddCandidate(source, id, source.Volume, 1.0f, false);
+            continue;
+        }
+
+        AudioEmitter emitter;
+        emitter.Position = transform->Position;
+        emitter.Velocity = source.HasLastPosition && dt > 0.0f ? (transform->Position - source.LastPosition) / dt : glm::vec3(0.0f);
+        emitter.Forward = transform->Rotation * glm::vec3(0.0f, 0.0f, 1.0f);
+        emitter.Volume = source.Volume;
+        emitter.MinDistance = source.MinDistance;
+        emitter.MaxDistance = source.MaxDistance;
+        emitter.Rolloff = source.Rolloff;
+        emitter.ConeInnerAngle = source.ConeInnerAngle;
+        emitter.ConeOuterAngle = source.ConeOuterAngle;
+        emitter.ConeOuterGain = source.ConeOuterGain;
+        emitter.DopplerFactor = source.DopplerFactor;
+        sData.Emitters.Add(emitter);
+        sData.EmitterEntities.push_back(id);
+
+        source.LastPosition = transform->Position;
+        source.HasLastPosition = true;
     }
+
+    sData.Emitters.Process(sData.Listener);
+    for (UInt32 i = 0; i < sData.Emitters.GetCount(); i++) {
+        AudioSourceComponent& source = view.get<AudioSourceComponent>(sData.EmitterEntities[i]);
+        AddCandidate(source, sData.EmitterEntities[i], sData.Emitters.GetGain(i), sData.Emitters.GetPitch(i), true);
+    }
+
+    // Only the top of the ranking has to be found, not sorted.
+    auto ranking = [](const Candidate& a, const Candidate& b) {
+        if (a.Priority != b.Priority)
+            return a.Priority > b.Priority;
+        return a.Audibility > b.Audibility;
+    };
+    UInt32 realCount = std::min((UInt32)sData.Candidates.size(), MaxVoices);
+    if (sData.Candidates.size() > MaxVoices)
+        std::nth_element(sData.Candidates.begin(), sData.Candidates.begin() + MaxVoices, sData.Candidates.end(), ranking);
+
+    // Losers give their voices back first, so the winners have some to take.
+    for (UInt32 i = realCount; i < sData.Candidates.size(); i++) {
+        AudioSourceComponent& source = view.get<AudioSourceComponent>(sData.Candidates[i].Entity);
+        if (source.Voice >= 0) {
+            ReleaseVoice(source.Voice);
+            source.Voice = -1;
+        }
+    }
+    for (UInt32 i = 0; i < realCount; i++) {
+        const Candidate& candidate = sData.Candidates[i];
+        AudioSourceComponent& source = view.get<AudioSourceComponent>(candidate.Entity);
+        if (source.Voice >= 0)
+            ApplyParameters(source, candidate);
+        else
+            AcquireVoice(source, candidate);
+    }
+
+    GAUGE_SET("Audio Voices", GetRealVoiceCount());
+    GAUGE_SET("Audio Virtual Sources", sData.Candidates.size() - realCount);
 }
 
 void AudioSystem::Quit(Ref<Scene> scene)
@@ -89,6 +298,248 @@ void AudioSystem::Quit(Ref<Scene> scene)
     auto view = registry->view<AudioSourceComponent>();
 
     for (auto [id, source] : view.each()) {
+        if (source.Voice >= 0) {
+            ReleaseVoice(source.Voice);
+            source.Voice = -1;
+        }
         source.Stop();
     }
 }
+
+void AudioSystem::ReleaseVoice(Int32 index)
+{
+    Voice& voice = sData.Voices[index];
+    if (!voice.InUse)
+        return;
+
+    ma_sound_uninit(&voice.Sound);
+    voice.File->FreeSource(voice.Source);
+    voice.Source = nullptr;
+    voice.File.reset();
+    voice.InUse = false;
+}
+
+UInt32 AudioSystem::GetRealVoiceCount()
+{
+    UInt32 count = 0;
+    for (Voice& voice : sData.Voices)
+        count += voice.InUse;
+    return count;
+}
+
+bool AudioSystem::AcquireVoice(AudioSourceComponent& source, const Candidate& candidate)
+{
+    Int32 index = -1;
+    for (Int32 i = 0; i < (Int32)MaxVoices; i++) {
+        if (!sData.Voices[i].InUse) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0)
+        return false;
+
+    Voice& voice = sData.Voices[index];
+    voice.File = source.Handle->Audio;
+    voice.Source = voice.File->CreateSource();
+    if (!voice.Source || ma_sound_init_from_data_source(&sData.Engine, voice.Source, 0, nullptr, &voice.Sound) != MA_SUCCESS) {
+        LOG_ERROR("Failed to create voice for {0}", source.Handle->Path);
+        voice.File->FreeSource(voice.Source);
+        voice.Source = nullptr;
+        voice.File.reset();
+        return false;
+    }
+    voice.InUse = true;
+    source.Voice = index;
+
+    if (source.Cursor > 0.0f)
+        ma_sound_seek_to_pcm_frame(&voice.Sound, (ma_uint64)(source.Cursor * voice.File->GetSampleRate()));
+
+    // Attenuation and doppler come from the emitter batch, miniaudio only pans.
+    ma_sound_set_attenuation_model(&voice.Sound, ma_attenuation_model_none);
+    ma_sound_set_doppler_factor(&voice.Sound, 0.0f);
+
+    // Nothing was applied yet, everything differs.
+    voice.Volume = -1.0f;
+    voice.Pitch = -1.0f;
+    voice.Looping = !source.Looping;
+    voice.Spatial = !candidate.Spatial;
+    voice.Position = glm::vec3(FLT_MAX);
+    ApplyParameters(source, candidate);
+    ma_sound_start(&voice.Sound);
+    return true;
+}
+
+void AudioSystem::ApplyParameters(AudioSourceComponent& source, const Candidate& candidate)
+{
+    Voice& voice = sData.Voices[source.Voice];
+    if (voice.Volume != candidate.Gain) {
+        voice.Volume = candidate.Gain;
+        ma_sound_set_volume(&voice.Sound, voice.Volume);
+    }
+    if (voice.Pitch != candidate.Pitch) {
+        voice.Pitch = candidate.Pitch;
+        ma_sound_set_pitch(&voice.Sound, voice.Pitch);
+    }
+    if (voice.Looping != source.Looping) {
+        voice.Looping = source.Looping;
+        ma_sound_set_looping(&voice.Sound, voice.Looping);
+    }
+    if (voice.Spatial != candidate.Spatial) {
+        voice.Spatial = candidate.Spatial;
+        ma_sound_set_spatialization_enabled(&voice.Sound, voice.Spatial);
+    }
+    if (candidate.Spatial && voice.Position != source.LastPosition) {
+        voice.Position = source.LastPosition;
+        ma_sound_set_position(&voice.Sound, voice.Position.x, voice.Position.y, voice.Position.z);
+    }
+}
+
+void AudioSystem::AddCandidate(AudioSourceComponent& source, entt::entity entity, float gain, float pitch, bool spatial)
+{
+    if (gain < InaudibleVolume) {
+        if (source.Voice >= 0) {
+            ReleaseVoice(source.Voice);
+            source.Voice = -1;
+        }
+        return;
+    }
+    sData.Candidates.push_back({ entity, source.Priority, source.Voice >= 0 ? gain * VoiceHysteresis : gain, gain, pitch, spatial });
+}
+
+void AudioSystem::UpdateListener(entt::registry* registry, float dt)
+{
+    // The listener follows the camera the renderer would pick.
+    TransformComponent* best = nullptr;
+    int bestPrimary = 0;
+    auto view = registry->view<TransformComponent, CameraComponent>();
+    for (auto [entity, transform, camera] : view.each()) {
+        if (camera.Primary > bestPrimary) {
+            best = &transform;
+            bestPrimary = camera.Primary;
+        }
+    }
+    if (!best)
+        return;
+
+    glm::vec3 forward = best->Rotation * glm::vec3(0.0f, 0.0f, 1.0f);
+    glm::vec3 up = best->Rotation * glm::vec3(0.0f, 1.0f, 0.0f);
+    sData.Listener.Velocity = sData.HasListener && dt > 0.0f ? (best->Position - sData.Listener.Position) / dt : glm::vec3(0.0f);
+    sData.Listener.Position = best->Position;
+    sData.HasListener = true;
+
+    ma_engine_listener_set_position(&sData.Engine, 0, best->Position.x, best->Position.y, best->Position.z);
+    ma_engine_listener_set_direction(&sData.Engine, 0, forward.x, forward.y, forward.z);
+    ma_engine_listener_set_world_up(&sData.Engine, 0, up.x, up.y, up.z);
+}
+
+void AudioSystem::AddStream(AudioStream* stream)
+{
+    std::lock_guard<std::mutex> lock(sData.StreamMutex);
+    sData.AddedStreams.push_back(stream);
+}
+
+void AudioSystem::RemoveStream(AudioStream* stream)
+{
+    std::lock_guard<std::mutex> lock(sData.StreamMutex);
+    sData.RetiredStreams.push_back(stream);
+}
+
+void AudioSystem::PumpStreams()
+{
+    // The lock only covers handing streams over, decoding happens outside of it so voices never wait on it.
+    {
+        std::lock_guard<std::mutex> lock(sData.StreamMutex);
+        sData.Streams.insert(sData.Streams.end(), sData.AddedStreams.begin(), sData.AddedStreams.end());
+        sData.AddedStreams.clear();
+        sData.Retiring.swap(sData.RetiredStreams);
+    }
+
+    for (AudioStream* stream : sData.Retiring) {
+        sData.Streams.erase(std::remove(sData.Streams.begin(), sData.Streams.end(), stream), sData.Streams.end());
+        delete stream;
+    }
+    sData.Retiring.clear();
+
+    for (AudioStream* stream : sData.Streams)
+        stream->Pump();
+}
+
+void AudioSystem::StreamThread()
+{
+    MEMORY_TAG(MemoryTag::Audio);
+    while (sData.Streaming) {
+        PumpStreams();
+        std::this_thread::sleep_for(std::chrono::milliseconds(StreamIntervalMs));
+    }
+}
+
+void AudioSystem::RunBenchmark(const String& clipPath, UInt32 emitterCount, UInt32 frameCount)
+{
+    const float frameDuration = 1.0f / 60.0f;
+
+    LOG_INFO("[AUDIO BENCHMARK] {0}, {1} emitters, {2} frames, {3} voices", clipPath, emitterCount, frameCount, MaxVoices);
+
+    // Outside of a project, so the clip is loaded by hand rather than through the asset manager.
+    Asset::Handle clip = MakeRef<Asset>();
+    clip->Path = clipPath;
+    clip->Type = AssetType::Audio;
+    clip->RefCount = 1;
+    clip->Audio = MakeRef<AudioFile>(clipPath);
+    if (!clip->Audio->IsValid())
+        return;
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> volume(0.0f, 1.0f);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_int_distribution<Int32> priority(0, 3);
+
+    Ref<Scene> scene = MakeRef<Scene>();
+    entt::registry* registry = scene->GetRegistry();
+    for (UInt32 i = 0; i < emitterCount; i++) {
+        entt::entity entity = registry->create();
+        TransformComponent& transform = registry->emplace<TransformComponent>(entity);
+        transform.Position = glm::vec3(position(random), position(random) * 0.1f, position(random));
+        AudioSourceComponent& source = registry->emplace<AudioSourceComponent>(entity);
+        source.Handle = clip;
+        source.Looping = true;
+        source.Volume = volume(random);
+        source.Priority = priority(random);
+        source.Play();
+    }
+
+    // Every emitter drifts a little each frame, the listener stays at the origin.
+    auto view = registry->view<AudioSourceComponent>();
+    auto movers = registry->view<TransformComponent, AudioSourceComponent>();
+    float totalMs = 0.0f;
+    float maxMs = 0.0f;
+    float mixMs = 0.0f;
+    for (UInt32 frame = 0; frame < frameCount; frame++) {
+        for (auto [entity, transform, source] : movers.each())
+            transform.Position.x += glm::sin(frame * 0.05f + transform.Position.z) * 0.1f;
+
+        Timer timer;
+        Update(scene, frameDuration);
+        float elapsed = timer.GetElapsed();
+        totalMs += elapsed;
+        maxMs = glm::max(maxMs, elapsed);
+
+        if (sData.Backend == AudioBackend::Offline) {
+            Timer mixTimer;
+            Render((UInt32)(SampleRate * frameDuration));
+            mixMs += mixTimer.GetElapsed();
+        }
+    }
+    LOG_INFO("[AUDIO BENCHMARK] {0}ms average, {1}ms worst update, {2} real voices", totalMs / frameCount, maxMs, GetRealVoiceCount());
+    if (sData.Backend == AudioBackend::Offline) {
+        UInt32 voices = glm::max(GetRealVoiceCount(), 1u);
+        LOG_INFO("[AUDIO BENCHMARK] {0}ms average mix per frame, {1}us per voice", mixMs / frameCount, mixMs / frameCount / voices * 1000.0f);
+    }
+
+    for (auto [entity, source] : view.each()) {
+        if (source.Voice >= 0)
+            ReleaseVoice(source.Voice);
+        source.Voice = -1;
+        source.Handle = nullptr;
+    }
+}
@@ -8,21 +8,186 @@
 #include <miniaudio.h>
 
 #include "World/Scene.hpp"
+#include "AudioEmitterBatch.hpp"
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+class AudioStream;
+
+/// @brief Where the mixed audio goes.
+enum class AudioBackend
+{
+    Device,  ///< The default playback device. Falls back to Null when there is none.
+    Null,    ///< No device: a thread mixes in real time and drops the output, or captures it. For servers.
+    Offline  ///< No device and no threads: audio only moves forward when `Render` is called. Deterministic, for tests and benchmarks.
+};
+
+/// @brief Plays the scene's audio sources through a fixed pool of voices.
+///
+/// Sources don't own a sound. Every update the playing sources are ranked by priority, then audibility,
+/// and only the top `MaxVoices` get a real voice; the others are virtual: their cursor keeps moving with
+/// time but nothing is decoded or mixed, and they pick up from there when they get a voice back.
+///
+/// Spatial sources follow their transform and the listener follows the main camera. Their audibility is
+/// the gain computed for all of them at once by an `AudioEmitterBatch`, so distance, cone and doppler
+/// cost nothing in miniaudio for the thousands of emitters that never get a voice.
 class AudioSystem
 {
 public:
-    static void Init();
+    /// @brief Number of real voices mixed at once.
+    static constexpr UInt32 MaxVoices = 64;
+
+    /// @brief Sources quieter than this are always virtual.
+    static constexpr float InaudibleVolume = 0.001f;
+
+    /// @brief How much louder a virtual source has to be than a real one of the same priority to steal its voice.
+    static constexpr float VoiceHysteresis = 1.25f;
+
+    /// @brief Sample rate of the mix.
+    static constexpr UInt32 SampleRate = 48000;
+
+    /// @brief Channels of the mix, interleaved.
+    static constexpr UInt32 ChannelCount = 2;
+
+    /// @brief How much audio the null backend mixes at once, in milliseconds.
+    static constexpr UInt32 NullIntervalMs = 10;
+
+    /// @brief Starts the audio engine.
+    /// @param backend Where the mix goes.
+    static void Init(AudioBackend backend = AudioBackend::Device);
     static void Exit();
 
+    /// @brief Returns the backend in use, which is Null if a Device was asked for but none could be opened.
+    static AudioBackend GetBackend() { return sData.Backend; }
+
+    /// @brief Mixes the next frames of audio on the calling thread. Offline backend only.
+    ///
+    /// Streams are filled on the calling thread first, so the same calls always give the same output.
+    /// @param frameCount The number of frames to mix.
+    /// @param output Optional, receives `frameCount * ChannelCount` interleaved samples.
+    static void Render(UInt32 frameCount, float* output = nullptr);
+
+    /// @brief Starts writing the mix to a WAV file. Null and Offline backends only, the device's thread can't block on a file.
+    /// @param path The WAV file to write.
+    /// @return False if the file couldn't be created.
+    static bool StartCapture(const String& path);
+
+    /// @brief Finishes the WAV file being captured.
+    static void StopCapture();
+
     static void Awake(Ref<Scene> scene);
-    static void Update(Ref<Scene> scene);
+
+    /// @brief Advances the sources, hands voices to the most important ones and pushes changed parameters to them.
+    /// @param scene The scene to update audio sources in.
+    /// @param dt The frame time in seconds.
+    static void Update(Ref<Scene> scene, float dt);
+
     static void Quit(Ref<Scene> scene);
 
+    /// @brief Stops a voice and gives it back to the pool.
+    static void ReleaseVoice(Int32 voice);
+
+    /// @brief Returns the number of voices in use.
+    static UInt32 GetRealVoiceCount();
+
+    /// @brief Plays a clip from thousands of emitters of random priority and volume and logs the cost of each update.
+    ///
+    /// On the offline backend each update is followed by a frame's worth of mixing, timed separately.
+    /// @param clipPath The audio file every emitter plays.
+    /// @param emitterCount The number of emitters.
+    /// @param frameCount The number of updates to run.
+    static void RunBenchmark(const String& clipPath, UInt32 emitterCount = 10000, UInt32 frameCount = 300);
+
     static ma_engine* GetEngine() { return &sData.Engine; }
+
+    /// @brief Has the streaming thread open a stream and keep its buffer filled.
+    static void AddStream(AudioStream* stream);
+
+    /// @brief Retires a stream, the streaming thread closes and deletes it on its next pass. Its sound must be
+    /// uninitialized already.
+    static void RemoveStream(AudioStream* stream);
+
+    /// @brief How often the streaming thread tops up the streams, in milliseconds.
+    static constexpr UInt32 StreamIntervalMs = 10;
 private:
+    /// @brief A real voice, and the parameters last pushed to its sound.
+    struct Voice
+    {
+        ma_sound Sound;
+        ma_data_source* Source = nullptr;
+        AudioFile::Ref File;
+        bool InUse = false;
+        float Volume = 0.0f;
+        float Pitch = 1.0f;
+        bool Looping = false;
+        bool Spatial = false;
+        glm::vec3 Position = glm::vec3(0.0f);
+    };
+
+    /// @brief A playing source competing for a voice.
+    struct Candidate
+    {
+        entt::entity Entity;
+        Int32 Priority;
+        float Audibility;
+        float Gain;
+        float Pitch;
+        bool Spatial;
+    };
+
+    /// @brief Gives a source a free voice, started at its cursor. Returns false if the pool is empty or the sound can't be created.
+    static bool AcquireVoice(AudioSourceComponent& source, const Candidate& candidate);
+
+    /// @brief Pushes the parameters that changed since last time to a source's voice.
+    static void ApplyParameters(AudioSourceComponent& source, const Candidate& candidate);
+
+    /// @brief Makes a source compete for a voice, or takes its voice away if it can't be heard.
+    static void AddCandidate(AudioSourceComponent& source, entt::entity entity, float gain, float pitch, bool spatial);
+
+    /// @brief Moves the listener to the main camera.
+    static void UpdateListener(entt::registry* registry, float dt);
+
+    /// @brief Takes in the added streams, deletes the retired ones and pumps the rest. Runs on the streaming
+    /// thread, or in `Render` and `Exit` when there is none.
+    static void PumpStreams();
+
+    static void StreamThread();
+
+    /// @brief Mixes frames and captures them if needed. Runs on the null backend's thread or in `Render`.
+    static void Mix(UInt32 frameCount, float* output);
+
+    static void MixThread();
+
     static struct Data {
+        AudioBackend Backend = AudioBackend::Device;
         ma_device Device;
         ma_engine Engine;
+
+        std::thread Mixer;
+        std::atomic<bool> Mixing = false;
+        std::mutex CaptureMutex;
+        ma_encoder Encoder;
+        bool Capturing = false;
+        Vector<float> MixBuffer;
+
+        Array<Voice, MaxVoices> Voices;
+        Vector<Candidate> Candidates;
+
+        AudioEmitterBatch Emitters;
+        Vector<entt::entity> EmitterEntities;
+        AudioListener Listener;
+        bool HasListener = false;
+
+        std::thread Streamer;
+        std::atomic<bool> Streaming = false;
+        std::mutex StreamMutex;
+        Vector<AudioStream*> AddedStreams;
+        Vector<AudioStream*> RetiredStreams;
+
+        // Owned by whichever thread pumps the streams.
+        Vector<AudioStream*> Streams;
+        Vector<AudioStream*> Retiring;
     } sData;
 };
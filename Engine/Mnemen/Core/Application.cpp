@@ -6,7 +6,11 @@
 #include <Core/Application.hpp>
 #include <Core/Logger.hpp>
 #include <Core/Profiler.hpp>
+#include <Core/FrameStats.hpp>
+#include <Core/Metrics.hpp>
+#include <Core/MemoryTracker.hpp>
 #include <Core/Assert.hpp>
+#include <Core/JobSystem.hpp>
 
 #include <Input/Input.hpp>
 #include <Asset/AssetCacher.hpp>
@@ -32,9 +36,10 @@ Application::Application(ApplicationSpecs specs)
     sInstance = this;
 
     Logger::Init();
+    JobSystem::Init();
     Input::Init();
     PhysicsSystem::Init();
-    AudioSystem::Init();
+    AudioSystem::Init(specs.Audio);
     AISystem::Init();
     ScriptSystem::Init();
 
@@ -44,6 +49,15 @@ Application::Application(ApplicationSpecs specs)
     mProject = MakeRef<Project>();
     if (!specs.ProjectPath.empty())
         mProject->Load(specs.ProjectPath);
+    ScriptSystem::SetBudget(mProject->Settings.ScriptBudgetMs);
+
+    ScriptGCSettings gc;
+    gc.Mode = mProject->Settings.ScriptGCIncremental ? ScriptGCMode::Incremental : ScriptGCMode::Generational;
+    gc.Pause = mProject->Settings.ScriptGCPause;
+    gc.StepMultiplier = mProject->Settings.ScriptGCStepMultiplier;
+    gc.StepSizeKb = mProject->Settings.ScriptGCStepSizeKb;
+    gc.BudgetMs = mProject->Settings.ScriptGCBudgetMs;
+    ScriptSystem::SetGCSettings(gc);
 
     Profiler::Init(mRHI);
     AssetManager::Init(mRHI);
@@ -62,19 +76,24 @@ Application::~Application()
 {
     AssetManager::Purge();
     Profiler::Exit();
+    Metrics::Exit();
     ScriptSystem::Exit();
     AISystem::Exit();
     AudioSystem::Exit();
     PhysicsSystem::Exit();
     Input::Exit();
+    JobSystem::Exit();
 
     LOG_INFO("Mnemen is done!");
+    Logger::Exit();
 }
 
 void Application::OnAwake()
 {
     mScenePlaying = true;
 
+    PhysicsSystem::Awake(mScene);
+    AISystem::Awake(mScene);
     ScriptSystem::Awake(mScene);
     AudioSystem::Awake(mScene);
 }
@@ -83,6 +102,8 @@ void Application::OnStop()
 {
     AudioSystem::Quit(mScene);
     ScriptSystem::Quit(mScene);
+    AISystem::Quit(mScene);
+    PhysicsSystem::Quit(mScene);
 
     mScenePlaying = false;
 }
@@ -91,25 +112,40 @@ void Application::Run()
 {
     Uploader::Flush();
     while (mWindow->IsOpen()) {
+        MemoryTracker::Snapshot();
+        Metrics::Snapshot();
         Profiler::BeginFrame();
 
         PROFILE_SCOPE("App Run");
         float time = mTimer.GetElapsed();
         float dt = time - mLastFrame;
         mLastFrame = time;
+        FrameStats::Record(dt);
         dt /= 1000.0f;
 
         // On Physics Update
+        float physicsAlpha = 1.0f;
         {
             PROFILE_SCOPE("Physics Update");
-            float minStepDuration = 1.0f / mProject->Settings.PhysicsRefreshRate;
-            if (TO_SECONDS(mPhysicsTimer.GetElapsed()) > minStepDuration) {
+            float stepDuration = 1.0f / mProject->Settings.PhysicsRefreshRate;
+
+            // Consume the frame time in fixed steps, the remainder carries over to the next frame.
+            mPhysicsAccumulator += dt;
+            int substeps = 0;
+            while (mPhysicsAccumulator >= stepDuration && substeps < mProject->Settings.MaxPhysicsSubsteps) {
                 OnPhysicsTick();
                 if (mScenePlaying && mScene) {
-                    PhysicsSystem::Update(mScene, minStepDuration);
+                    PhysicsSystem::Update(mScene, stepDuration);
                 }
-                mPhysicsTimer.Restart();
+                mPhysicsAccumulator -= stepDuration;
+                substeps++;
+            }
+
+            // After a hitch, drop the time we couldn't simulate instead of trying to catch up and spiraling.
+            if (mPhysicsAccumulator >= stepDuration) {
+                mPhysicsAccumulator = glm::mod(mPhysicsAccumulator, stepDuration);
             }
+            physicsAlpha = mPhysicsAccumulator / stepDuration;
         }
 
         // Engine Update
@@ -119,10 +155,12 @@ void Application::Run()
             mWindow->Update();
             AssetManager::Update();
             if (mScenePlaying && mScene) {
-                AISystem::Update(mScene);
-                AudioSystem::Update(mScene);
+                AISystem::Update(mScene, dt);
+                AudioSystem::Update(mScene, dt);
                 ScriptSystem::Update(mScene, dt);
             }
+            if (mScenePlaying && mScene)
+                PhysicsSystem::Interpolate(mScene, physicsAlpha);
             if (mScene)
                 mScene->Update();
         }
@@ -13,6 +13,7 @@
 #include <RHI/RHI.hpp>
 #include <Renderer/Renderer.hpp>
 #include <World/Scene.hpp>
+#include <Audio/AudioSystem.hpp>
 
 /// @struct ApplicationSpecs
 /// @brief Stores configuration settings for the application.
@@ -25,6 +26,8 @@ struct ApplicationSpecs
     String ProjectPath; ///< The path of the project.
 
     bool CopyToBackBuffer; ///< If set to true, the output color will be copied to the swapchain. Used in Runtime.
+
+    AudioBackend Audio = AudioBackend::Device; ///< Where the audio mix goes. Null for headless machines.
 };
 
 /// @class Application
@@ -95,7 +98,7 @@ protected:
     Timer mTimer; ///< Delta-time tracking timer.
     float mLastFrame = 0.0f; ///< Time of the last frame update.
 
-    Timer mPhysicsTimer; ///< Timer for fixed-step physics updates.
+    float mPhysicsAccumulator = 0.0f; ///< Simulation time (in seconds) not consumed by fixed physics steps yet.
 
     RHI::Ref mRHI = nullptr; ///< Rendering Hardware Interface.
     Renderer::Ref mRenderer = nullptr; ///< Renderer instance.
@@ -0,0 +1,117 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-04 09:48:52
+//
+
+#include "FrameStats.hpp"
+
+#include <Core/File.hpp>
+#include <Core/Logger.hpp>
+#include <Core/Profiler.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <imgui.h>
+
+FrameStats::Data FrameStats::sData;
+
+void FrameStats::Record(float ms)
+{
+    // Percentiles of the frames before this one, so a hitch doesn't raise its own bar.
+    float median = 0.0f;
+    if (sData.Count >= WarmupFrames) {
+        sData.Scratch.assign(sData.Times.begin(), sData.Times.begin() + sData.Count);
+        auto middle = sData.Scratch.begin() + sData.Count / 2;
+        std::nth_element(sData.Scratch.begin(), middle, sData.Scratch.end());
+        median = *middle;
+    }
+
+    if (sData.Count == WindowFrames)
+        sData.Histogram[GetBucket(sData.Times[sData.Next])]--;
+    else
+        sData.Count++;
+    sData.Times[sData.Next] = ms;
+    sData.Next = (sData.Next + 1) % WindowFrames;
+    sData.Histogram[GetBucket(ms)]++;
+    sData.TotalFrames++;
+
+    if (median <= 0.0f || ms < MinHitchMs || ms < median * HitchFactor)
+        return;
+
+    sData.HitchCount++;
+    sData.LastHitchMs = ms;
+    LOG_WARN("Hitch: frame {0} took {1}ms, median is {2}ms", sData.TotalFrames, ms, median);
+
+    if (sData.Dumped && sData.TotalFrames - sData.LastDumpFrame < HitchDumpCooldown)
+        return;
+    if (!File::Exists(HitchDirectory))
+        File::CreateDirectoryFromPath(HitchDirectory);
+
+    String path = String(HitchDirectory) + "/hitch_" + std::to_string(sData.TotalFrames) + ".json";
+    if (Profiler::DumpHistory(path, HitchDumpFrames)) {
+        sData.Dumped = true;
+        sData.LastDumpFrame = sData.TotalFrames;
+        sData.LastDumpPath = path;
+    }
+}
+
+void FrameStats::Reset()
+{
+    sData.Next = 0;
+    sData.Count = 0;
+    sData.Histogram = {};
+    sData.HitchCount = 0;
+}
+
+FrameTimeSummary FrameStats::GetSummary()
+{
+    FrameTimeSummary summary;
+    if (sData.Count == 0)
+        return summary;
+
+    sData.Scratch.assign(sData.Times.begin(), sData.Times.begin() + sData.Count);
+    std::sort(sData.Scratch.begin(), sData.Scratch.end());
+
+    auto percentile = [](float p) { return sData.Scratch[(UInt32)(p * (sData.Scratch.size() - 1))]; };
+    float total = 0.0f;
+    for (float time : sData.Scratch)
+        total += time;
+
+    summary.Average = total / sData.Count;
+    summary.P50 = percentile(0.50f);
+    summary.P95 = percentile(0.95f);
+    summary.P99 = percentile(0.99f);
+    summary.Max = sData.Scratch.back();
+    return summary;
+}
+
+void FrameStats::OnUI()
+{
+    FrameTimeSummary summary = GetSummary();
+    ImGui::Text("Average : %.2fms (%.0f FPS)", summary.Average, summary.Average > 0.0f ? 1000.0f / summary.Average : 0.0f);
+    ImGui::Text("P50 : %.2fms, P95 : %.2fms, P99 : %.2fms, Max : %.2fms", summary.P50, summary.P95, summary.P99, summary.Max);
+
+    // Oldest first, so the graph scrolls left.
+    float times[WindowFrames];
+    for (UInt32 i = 0; i < sData.Count; i++)
+        times[i] = sData.Times[(sData.Next + WindowFrames - sData.Count + i) % WindowFrames];
+    ImGui::PlotLines("Frame Times", times, sData.Count, 0, nullptr, 0.0f, summary.P99 * 1.5f, ImVec2(0, 60));
+
+    float histogram[BucketCount];
+    for (UInt32 i = 0; i < BucketCount; i++)
+        histogram[i] = (float)sData.Histogram[i];
+    ImGui::PlotHistogram("Histogram (1ms)", histogram, BucketCount, 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+
+    ImGui::Text("Hitches : %u", sData.HitchCount);
+    if (sData.HitchCount > 0)
+        ImGui::Text("Last hitch : %.2fms", sData.LastHitchMs);
+    if (!sData.LastDumpPath.empty())
+        ImGui::Text("Last trace : %s", sData.LastDumpPath.c_str());
+    if (ImGui::Button("Reset"))
+        Reset();
+}
+
+UInt32 FrameStats::GetBucket(float ms)
+{
+    return std::min((UInt32)(std::max(ms, 0.0f) / BucketMs), BucketCount - 1);
+}
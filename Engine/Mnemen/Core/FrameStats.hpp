@@ -0,0 +1,91 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-04 09:31:18
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+
+/// @brief Frame time percentiles over the recorded window.
+struct FrameTimeSummary
+{
+    float Average = 0.0f;
+    float P50 = 0.0f;
+    float P95 = 0.0f;
+    float P99 = 0.0f;
+    float Max = 0.0f;
+};
+
+/// @brief Records the distribution of frame times and catches hitches.
+///
+/// Keeps the last `WindowFrames` frame times, a histogram of them and their percentiles. A frame
+/// taking `HitchFactor` times the median or more is a hitch: it's logged, and the last frames of
+/// the profiler's history are dumped to `HitchDirectory` as a Chrome trace, so a stall seen once
+/// in the field comes with what every thread was doing around it.
+class FrameStats
+{
+public:
+    /// @brief Number of frames the statistics cover.
+    static constexpr UInt32 WindowFrames = 600;
+
+    /// @brief Width of a histogram bucket, in milliseconds.
+    static constexpr float BucketMs = 1.0f;
+
+    /// @brief Number of histogram buckets, the last one holds every longer frame.
+    static constexpr UInt32 BucketCount = 100;
+
+    /// @brief How many times the median a frame has to take to be a hitch.
+    static constexpr float HitchFactor = 3.0f;
+
+    /// @brief Frames shorter than this are never hitches, however short the median is.
+    static constexpr float MinHitchMs = 10.0f;
+
+    /// @brief Frames recorded before hitches are detected, so loading doesn't count.
+    static constexpr UInt32 WarmupFrames = 120;
+
+    /// @brief Profiled frames written with a hitch, the hitch itself included.
+    static constexpr UInt32 HitchDumpFrames = 8;
+
+    /// @brief Minimum number of frames between two dumps, so a burst of hitches only writes one.
+    static constexpr UInt32 HitchDumpCooldown = 300;
+
+    /// @brief Where hitch traces are written.
+    static constexpr const char* HitchDirectory = "Hitches";
+
+    /// @brief Records the time of the frame that just ended. Call after `Profiler::BeginFrame`, so a hitch is in its history.
+    /// @param ms The frame time, in milliseconds.
+    static void Record(float ms);
+
+    /// @brief Forgets every recorded frame.
+    static void Reset();
+
+    /// @brief Computes the percentiles of the recorded frames.
+    static FrameTimeSummary GetSummary();
+
+    /// @brief Returns the number of frames in each bucket of the histogram.
+    static const Array<UInt32, BucketCount>& GetHistogram() { return sData.Histogram; }
+
+    /// @brief Returns the number of hitches since the last reset.
+    static UInt32 GetHitchCount() { return sData.HitchCount; }
+
+    /// @brief Draws the statistics, inside the profiler panel.
+    static void OnUI();
+private:
+    static UInt32 GetBucket(float ms);
+
+    static struct Data {
+        Array<float, WindowFrames> Times = {};
+        UInt32 Next = 0;
+        UInt32 Count = 0;
+        UInt64 TotalFrames = 0;
+        Array<UInt32, BucketCount> Histogram = {};
+        Vector<float> Scratch;
+
+        UInt32 HitchCount = 0;
+        UInt64 LastDumpFrame = 0;
+        bool Dumped = false;
+        float LastHitchMs = 0.0f;
+        String LastDumpPath;
+    } sData;
+};
@@ -0,0 +1,152 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-21 10:29:02
+//
+
+#include "JobSystem.hpp"
+
+#include <Core/Logger.hpp>
+#include <Core/Assert.hpp>
+
+JobSystem::Data JobSystem::sData;
+
+static thread_local Int32 sCurrentWorker = -1;
+
+void JobSystem::Init(UInt32 workerCount)
+{
+    if (workerCount == 0) {
+        UInt32 hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    sData.Running = true;
+    for (UInt32 i = 0; i < workerCount; i++) {
+        sData.Workers.emplace_back(&JobSystem::WorkerLoop, i);
+    }
+
+    LOG_INFO("Initialized Job System with {0} workers", workerCount);
+}
+
+void JobSystem::Exit()
+{
+    Wait();
+    {
+        std::lock_guard<std::mutex> lock(sData.Mutex);
+        sData.Running = false;
+    }
+    sData.WakeCondition.notify_all();
+    for (auto& worker : sData.Workers) {
+        worker.join();
+    }
+    sData.Workers.clear();
+}
+
+void JobSystem::Execute(const Job& job, Counter* counter)
+{
+    bool helpers;
+    {
+        std::lock_guard<std::mutex> lock(sData.Mutex);
+        sData.Jobs.push({ job, counter });
+        sData.PendingJobs++;
+        if (counter)
+            counter->Pending++;
+        helpers = sData.HelpingWorkers > 0;
+    }
+    sData.WakeCondition.notify_one();
+    if (helpers)
+        sData.DoneCondition.notify_all();
+}
+
+void JobSystem::Dispatch(UInt32 jobCount, const DispatchJob& job, Counter* counter)
+{
+    if (jobCount == 0)
+        return;
+
+    bool helpers;
+    {
+        std::lock_guard<std::mutex> lock(sData.Mutex);
+        for (UInt32 i = 0; i < jobCount; i++) {
+            sData.Jobs.push({ [job, i](UInt32 workerIndex) { job(i, workerIndex); }, counter });
+        }
+        sData.PendingJobs += jobCount;
+        if (counter)
+            counter->Pending += jobCount;
+        helpers = sData.HelpingWorkers > 0;
+    }
+    sData.WakeCondition.notify_all();
+    if (helpers)
+        sData.DoneCondition.notify_all();
+}
+
+bool JobSystem::IsBusy(Counter* counter)
+{
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    return counter ? counter->Pending > 0 : sData.PendingJobs > 0;
+}
+
+void JobSystem::Wait(Counter* counter)
+{
+    if (sCurrentWorker == -1) {
+        std::unique_lock<std::mutex> lock(sData.Mutex);
+        sData.DoneCondition.wait(lock, [counter]() { return counter ? counter->Pending == 0 : sData.PendingJobs == 0; });
+        return;
+    }
+
+    // The calling job is pending itself, so it can never see every job done.
+    ASSERT(counter != nullptr, "JobSystem::Wait on every job called from a worker thread!");
+
+    // A worker that blocked could deadlock the pool once every worker is waiting, so it runs queued jobs instead.
+    std::unique_lock<std::mutex> lock(sData.Mutex);
+    while (counter->Pending > 0) {
+        if (sData.Jobs.empty()) {
+            sData.HelpingWorkers++;
+            sData.DoneCondition.wait(lock, [counter]() { return counter->Pending == 0 || !sData.Jobs.empty(); });
+            sData.HelpingWorkers--;
+            continue;
+        }
+
+        QueuedJob job = std::move(sData.Jobs.front());
+        sData.Jobs.pop();
+        lock.unlock();
+        RunJob(job, (UInt32)sCurrentWorker);
+        lock.lock();
+    }
+}
+
+Int32 JobSystem::GetCurrentWorker()
+{
+    return sCurrentWorker;
+}
+
+void JobSystem::WorkerLoop(UInt32 workerIndex)
+{
+    sCurrentWorker = (Int32)workerIndex;
+
+    while (true) {
+        QueuedJob job;
+        {
+            std::unique_lock<std::mutex> lock(sData.Mutex);
+            sData.WakeCondition.wait(lock, []() { return !sData.Jobs.empty() || !sData.Running; });
+            if (!sData.Running && sData.Jobs.empty())
+                return;
+
+            job = std::move(sData.Jobs.front());
+            sData.Jobs.pop();
+        }
+
+        RunJob(job, workerIndex);
+    }
+}
+
+void JobSystem::RunJob(QueuedJob& job, UInt32 workerIndex)
+{
+    job.Function(workerIndex);
+
+    {
+        std::lock_guard<std::mutex> lock(sData.Mutex);
+        sData.PendingJobs--;
+        if (job.Group)
+            job.Group->Pending--;
+    }
+    sData.DoneCondition.notify_all();
+}
@@ -0,0 +1,91 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-21 10:14:37
+//
+
+#pragma once
+
+#include "Common.hpp"
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/// @brief A small pool of worker threads shared by the engine systems.
+/// 
+/// Jobs are pushed into a single FIFO queue and picked up by whichever worker is free. Each job
+/// receives the index of the worker running it, so systems can keep per-worker state (Lua states,
+/// navmesh queries...) without any locking of their own.
+class JobSystem
+{
+public:
+    /// @brief A unit of work. The argument is the index of the worker executing it, in [0, GetWorkerCount()).
+    using Job = std::function<void(UInt32 workerIndex)>;
+
+    /// @brief A job executed once per index of a dispatch.
+    using DispatchJob = std::function<void(UInt32 jobIndex, UInt32 workerIndex)>;
+
+    /// @brief Tracks a group of jobs so a system can wait on its own work only.
+    struct Counter
+    {
+        /// @brief The number of jobs of the group that haven't finished yet. Guarded by the job system.
+        UInt64 Pending = 0;
+    };
+
+    /// @brief Spawns the worker threads.
+    /// @param workerCount The number of workers. 0 picks the hardware thread count minus the main thread.
+    static void Init(UInt32 workerCount = 0);
+
+    /// @brief Waits for pending jobs and joins every worker.
+    static void Exit();
+
+    /// @brief Queues a single job.
+    /// @param job The job to execute.
+    /// @param counter Optional counter the job is accounted in.
+    static void Execute(const Job& job, Counter* counter = nullptr);
+
+    /// @brief Queues `jobCount` jobs running the same function with a different job index.
+    /// @param jobCount The number of jobs to queue.
+    /// @param job The function to execute for every index.
+    /// @param counter Optional counter the jobs are accounted in.
+    static void Dispatch(UInt32 jobCount, const DispatchJob& job, Counter* counter = nullptr);
+
+    /// @brief Returns whether or not jobs are still queued or running.
+    /// @param counter The group to check, or every job if null.
+    static bool IsBusy(Counter* counter = nullptr);
+
+    /// @brief Blocks the calling thread until the jobs are done.
+    ///
+    /// From inside a job, the worker runs queued jobs while it waits, and a counter is required.
+    /// @param counter The group to wait for, or every job if null.
+    static void Wait(Counter* counter = nullptr);
+
+    /// @brief Returns the number of worker threads.
+    static UInt32 GetWorkerCount() { return (UInt32)sData.Workers.size(); }
+
+    /// @brief Returns the index of the calling worker, or -1 when called outside of a job.
+    static Int32 GetCurrentWorker();
+private:
+    static void WorkerLoop(UInt32 workerIndex);
+
+    struct QueuedJob {
+        Job Function;
+        Counter* Group;
+    };
+
+    /// @brief Runs a job taken off the queue and accounts it as done.
+    static void RunJob(QueuedJob& job, UInt32 workerIndex);
+
+    static struct Data {
+        Vector<std::thread> Workers;
+        QueueArray<QueuedJob> Jobs;
+        std::mutex Mutex;
+        std::condition_variable WakeCondition;
+        std::condition_variable DoneCondition;
+        UInt64 PendingJobs = 0;
+        // Workers waiting on DoneCondition inside Wait, which also need waking when jobs are queued.
+        UInt32 HelpingWorkers = 0;
+        bool Running = false;
+    } sData;
+};
@@ -4,20 +4,17 @@
 //
 
 #include <Core/Logger.hpp>
+#include <Core/Timer.hpp>
 
-#include <vector>
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
 
-#include <string>
-#include <iostream>
 #include <chrono>
 #include <ctime>
-#include <iomanip>
-#include <sstream>
 
 Ref<spdlog::logger> Logger::sLogger;
-Vector<Logger::LogEntry> Logger::sEntries;
+Logger::Ring Logger::sRing;
 
 ImVec4 LevelToColor(spdlog::level::level_enum level)
 {
@@ -34,33 +31,19 @@ ImVec4 LevelToColor(spdlog::level::level_enum level)
     return ImVec4(1, 1, 1, 1);
 }
 
-/// @class VectorSink
-/// @brief A custom log sink for storing log messages in a vector.
+/// @class RingSink
+/// @brief A custom log sink for storing log messages in the editor's ring of entries.
 ///
 /// This class is derived from the spdlog::sinks::sink and provides custom logging functionality
-/// that formats log messages with timestamps and log levels, then stores them in a vector.
-class VectorSink : public spdlog::sinks::sink
+/// that formats log messages with timestamps and log levels, then stores them in Logger's ring.
+class RingSink : public spdlog::sinks::sink
 {
 public:
     /// @brief Logs a message to the sink.
     ///
-    /// This function converts the timestamp of the log message to a formatted string,
-    /// then constructs a log message with the timestamp, log level, and the payload,
-    /// and stores it in the Logger::sEntries vector.
-    ///
     /// @param msg The log message details including the timestamp, log level, and payload.
     void log(const spdlog::details::log_msg& msg) override {
-        // Convert time_point to time_t for easier formatting
-        auto time_point = std::chrono::system_clock::to_time_t(msg.time);
-        std::tm tm = *std::localtime(&time_point);
-
-        // Format the timestamp
-        std::stringstream time_stream;
-        time_stream << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-
-        // Convert the log message to a string and store it in the vector
-        String log_message = fmt::format("{} [{}] {}", time_stream.str(), spdlog::level::to_string_view(msg.level), msg.payload);
-        Logger::sEntries.push_back({ log_message, LevelToColor(msg.level) });
+        Logger::PushEntry(msg);
     }
 
     /// @brief Flushes the log sink.
@@ -88,19 +71,98 @@ public:
     void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override {}
 };
 
+void Logger::PushEntry(const spdlog::details::log_msg& msg)
+{
+    // The timestamp only changes once a second, no need to convert it for every line.
+    thread_local std::time_t lastSecond = -1;
+    thread_local char timestamp[32] = {};
+    std::time_t second = std::chrono::system_clock::to_time_t(msg.time);
+    if (second != lastSecond) {
+        std::tm tm = spdlog::details::os::localtime(second);
+        std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &tm);
+        lastSecond = second;
+    }
+
+    UInt64 index = sRing.Write.fetch_add(1, std::memory_order_acq_rel);
+    Slot& slot = sRing.Slots[index % EntryCount];
+    slot.Sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto result = fmt::format_to_n(slot.Entry.Message, MaxEntryLength - 1, "{} [{}] {}", timestamp, spdlog::level::to_string_view(msg.level), msg.payload);
+    slot.Entry.Length = (UInt32)result.size < MaxEntryLength - 1 ? (UInt32)result.size : MaxEntryLength - 1;
+    slot.Entry.Message[slot.Entry.Length] = 0;
+    slot.Entry.Color = LevelToColor(msg.level);
+    slot.Sequence.store(index * 2 + 2, std::memory_order_release);
+}
 
 void Logger::Init()
 {
     Vector<spdlog::sink_ptr> logSinks;
     logSinks.emplace_back(MakeRef<spdlog::sinks::stdout_color_sink_mt>());
     logSinks.emplace_back(MakeRef<spdlog::sinks::basic_file_sink_mt>("mnemen.log", true));
-    logSinks.emplace_back(MakeRef<VectorSink>());
+    logSinks.emplace_back(MakeRef<RingSink>());
 
     logSinks[0]->set_pattern("%^[%c] [%l] %v%$");
     logSinks[1]->set_pattern("[%c] [%l] %v");
 
-    sLogger = MakeRef<spdlog::logger>("MNEMEN", begin(logSinks), end(logSinks));
+    // Block rather than drop when the queue is full, mnemen.log has to have every line.
+    spdlog::init_thread_pool(QueueSize, 1);
+    sLogger = MakeRef<spdlog::async_logger>("MNEMEN", begin(logSinks), end(logSinks), spdlog::thread_pool(), spdlog::async_overflow_policy::block);
     spdlog::register_logger(sLogger);
     sLogger->set_level(spdlog::level::trace);
+    sLogger->flush_on(spdlog::level::err);
+    spdlog::flush_every(std::chrono::seconds(1));
+}
+
+void Logger::Exit()
+{
+    if (!sLogger)
+        return;
+
+    // Shutting down drains the queue, then late messages from destructors go straight to the sinks.
+    Vector<spdlog::sink_ptr> logSinks = sLogger->sinks();
+    spdlog::shutdown();
+    sLogger = MakeRef<spdlog::logger>("MNEMEN", begin(logSinks), end(logSinks));
+    sLogger->set_level(spdlog::level::trace);
     sLogger->flush_on(spdlog::level::trace);
-}
\ No newline at end of file
+}
+
+void Logger::RunBenchmark(UInt32 lineCount)
+{
+    LOG_INFO("[LOG BENCHMARK] {0} lines per logger, without the console", lineCount);
+
+    // A burst fits in the queue, like a frame loading a few hundred assets. A sustained run is bound by the background thread.
+    for (UInt32 count : { QueueSize / 2, lineCount })
+    for (bool async : { false, true }) {
+        Vector<spdlog::sink_ptr> logSinks;
+        logSinks.emplace_back(MakeRef<spdlog::sinks::basic_file_sink_mt>("log_benchmark.log", true));
+        logSinks.emplace_back(MakeRef<RingSink>());
+        logSinks[0]->set_pattern("[%c] [%l] %v");
+
+        // The synchronous logger flushes every line, like the engine logger used to.
+        Ref<spdlog::details::thread_pool> pool;
+        Ref<spdlog::logger> logger;
+        if (async) {
+            pool = MakeRef<spdlog::details::thread_pool>(QueueSize, 1);
+            logger = MakeRef<spdlog::async_logger>("BENCHMARK", begin(logSinks), end(logSinks), pool, spdlog::async_overflow_policy::block);
+            logger->flush_on(spdlog::level::err);
+        } else {
+            logger = MakeRef<spdlog::logger>("BENCHMARK", begin(logSinks), end(logSinks));
+            logger->flush_on(spdlog::level::trace);
+        }
+
+        Timer timer;
+        for (UInt32 i = 0; i < count; i++)
+            logger->info("Loaded asset {0} of {1} (Assets/Models/Sponza/Sponza.gltf)", i, count);
+        float callerMs = timer.GetElapsed();
+
+        // Destroying the pool waits for the background thread to write what's left.
+        logger->flush();
+        logger.reset();
+        pool.reset();
+        float totalMs = timer.GetElapsed();
+
+        LOG_INFO("[LOG BENCHMARK] {0}, {1} lines: {2}ms on the caller ({3} lines/s), {4}ms until written",
+                 async ? "Async" : "Sync", count, callerMs, (UInt64)(count / (callerMs / 1000.0f)), totalMs);
+    }
+}
@@ -8,6 +8,9 @@
 #include <spdlog/spdlog.h>
 #include <imgui.h>
 
+#include <atomic>
+#include <cstring>
+
 #include "Common.hpp"
 
 /// @brief A Logger class for logging messages at various levels of severity.
@@ -15,34 +18,103 @@
 /// This class provides static methods to log messages using the spdlog library. 
 /// It supports different log levels, including trace, info, warn, error, and critical. 
 /// Additionally, the class allows for conditional debug logging in debug builds.
+///
+/// The logger is asynchronous: a log call formats the message and queues it, and a background
+/// thread writes it to the console, `mnemen.log` and the editor's ring of entries. The file is
+/// flushed every second and on every error, so a hard crash can lose the last second of lines.
 class Logger
 {
 public:
+    /// @brief Number of entries the editor log keeps. Older entries are overwritten.
+    static constexpr UInt32 EntryCount = 4096;
+    /// @brief Maximum length of an entry, longer messages are cut.
+    static constexpr UInt32 MaxEntryLength = 256;
+    /// @brief Number of messages the background thread can fall behind before log calls block.
+    static constexpr UInt32 QueueSize = 8192;
+
     /// @brief An entry in the logger
     struct LogEntry
     {
-        /// @brief The contents of the entry
-        String Message;
+        /// @brief The contents of the entry, null-terminated
+        char Message[MaxEntryLength];
+        /// @brief The length of the contents
+        UInt32 Length;
         /// @brief The color of the entry
         ImVec4 Color;
     };
 
     /// @brief Initializes the logger.
     /// 
-    /// This method sets up the logger instance and prepares it for use.
+    /// This method sets up the logger instance and starts the background thread.
     static void Init();
 
+    /// @brief Writes every queued message and stops the background thread.
+    ///
+    /// Messages logged afterwards are written synchronously.
+    static void Exit();
+
     /// @brief Retrieves the logger instance.
     /// 
     /// This method returns a shared pointer to the logger instance, which can be used to log messages.
     /// @return A shared pointer to the logger instance.
     static Ref<spdlog::logger> GetLogger() { return sLogger; }
 
-    /// @brief The vector containing the log data. Make sure to clear it every once in a while! ;)
-    static Vector<LogEntry> sEntries;
+    /// @brief Hides every entry logged so far from `ForEachEntry`. Main thread only.
+    static void Clear() { sRing.Start = sRing.Write.load(std::memory_order_acquire); }
+
+    /// @brief Calls a function on every entry still in the ring, oldest first. Main thread only.
+    ///
+    /// Entries are copied out before the call, entries being overwritten while read are skipped.
+    /// @param function The function, taking a `const LogEntry&`.
+    template<typename F>
+    static void ForEachEntry(F&& function)
+    {
+        UInt64 end = sRing.Write.load(std::memory_order_acquire);
+        UInt64 begin = end > EntryCount ? end - EntryCount : 0;
+        if (begin < sRing.Start)
+            begin = sRing.Start;
+
+        LogEntry entry;
+        for (UInt64 i = begin; i < end; i++) {
+            const Slot& slot = sRing.Slots[i % EntryCount];
+            UInt64 sequence = slot.Sequence.load(std::memory_order_acquire);
+            if (sequence != i * 2 + 2)
+                continue;
+            entry.Length = slot.Entry.Length < MaxEntryLength ? slot.Entry.Length : MaxEntryLength - 1;
+            entry.Color = slot.Entry.Color;
+            memcpy(entry.Message, slot.Entry.Message, entry.Length);
+            entry.Message[entry.Length] = 0;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.Sequence.load(std::memory_order_relaxed) != sequence)
+                continue;
+            function(entry);
+        }
+    }
+
+    /// @brief Measures the cost of a log call with a synchronous and an asynchronous logger.
+    /// @param lineCount The number of lines each logger writes.
+    static void RunBenchmark(UInt32 lineCount);
 private:
+    friend class RingSink;
+
+    /// @brief A slot of the ring. The sequence is odd while the entry is written, and `index * 2 + 2` once it holds entry `index`.
+    struct Slot
+    {
+        std::atomic<UInt64> Sequence = 0;
+        LogEntry Entry;
+    };
+
+    /// @brief Claims the next slot of the ring and writes an entry into it. Thread-safe and lock-free.
+    static void PushEntry(const spdlog::details::log_msg& msg);
+
     /// @brief The shared pointer to the logger instance.
     static Ref<spdlog::logger> sLogger;
+
+    static struct Ring {
+        Array<Slot, EntryCount> Slots;
+        std::atomic<UInt64> Write = 0; ///< Index of the next entry, slots are claimed by incrementing it.
+        UInt64 Start = 0; ///< First entry shown, moved by `Clear`.
+    } sRing;
 };
 
 /// @brief Macro for logging trace-level messages.
@@ -0,0 +1,196 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-05 10:26:51
+//
+
+#include "MemoryTracker.hpp"
+
+#include <Core/Metrics.hpp>
+
+#include <cstdlib>
+#include <new>
+#include <imgui.h>
+
+Array<MemoryTracker::TagCounters, (size_t)MemoryTag::Count> MemoryTracker::sCounters;
+thread_local MemoryTag MemoryTracker::sTag = MemoryTag::General;
+
+static const char* sTagNames[] = { "General", "Asset", "Mesh Import", "Script", "Audio", "Renderer", "Editor" };
+
+// Metric names have to be string literals.
+static const char* sLiveNames[] = { "Heap General (KB)", "Heap Asset (KB)", "Heap Mesh Import (KB)", "Heap Script (KB)", "Heap Audio (KB)", "Heap Renderer (KB)", "Heap Editor (KB)" };
+static const char* sAllocationNames[] = { "Allocations General", "Allocations Asset", "Allocations Mesh Import", "Allocations Script", "Allocations Audio", "Allocations Renderer", "Allocations Editor" };
+static_assert(sizeof(sTagNames) / sizeof(sTagNames[0]) == (size_t)MemoryTag::Count, "Every memory tag needs a name");
+
+void MemoryTracker::RecordAllocation(MemoryTag tag, UInt64 size)
+{
+    TagCounters& counters = sCounters[(size_t)tag];
+    counters.LiveBytes.fetch_add(size, std::memory_order_relaxed);
+    counters.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    counters.AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void MemoryTracker::RecordFree(MemoryTag tag, UInt64 size)
+{
+    sCounters[(size_t)tag].LiveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+MemoryTracker::TagStats MemoryTracker::GetStats(MemoryTag tag)
+{
+    const TagCounters& counters = sCounters[(size_t)tag];
+    TagStats stats;
+    stats.LiveBytes = counters.LiveBytes.load(std::memory_order_relaxed);
+    stats.AllocationCount = counters.AllocationCount.load(std::memory_order_relaxed);
+    stats.AllocatedBytes = counters.AllocatedBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag)
+{
+    return sTagNames[(size_t)tag];
+}
+
+void MemoryTracker::Snapshot()
+{
+    if constexpr (!Enabled)
+        return;
+
+    static UInt16 liveIDs[(size_t)MemoryTag::Count];
+    static UInt16 allocationIDs[(size_t)MemoryTag::Count];
+    static UInt64 lastCounts[(size_t)MemoryTag::Count] = {};
+    static UInt64 lastBytes = 0;
+    static bool registered = false;
+    if (!registered) {
+        for (size_t i = 0; i < (size_t)MemoryTag::Count; i++) {
+            liveIDs[i] = Metrics::Register(sLiveNames[i], MetricType::Gauge);
+            allocationIDs[i] = Metrics::Register(sAllocationNames[i], MetricType::Gauge);
+        }
+        registered = true;
+    }
+
+    // Totals only grow, this frame's share is the difference with the last snapshot.
+    UInt64 totalCount = 0;
+    UInt64 totalBytes = 0;
+    for (size_t i = 0; i < (size_t)MemoryTag::Count; i++) {
+        TagStats stats = GetStats((MemoryTag)i);
+        Metrics::Set(liveIDs[i], stats.LiveBytes / 1024);
+        Metrics::Set(allocationIDs[i], stats.AllocationCount - lastCounts[i]);
+        totalCount += stats.AllocationCount - lastCounts[i];
+        totalBytes += stats.AllocatedBytes;
+        lastCounts[i] = stats.AllocationCount;
+    }
+    GAUGE_SET("Allocations", totalCount);
+    GAUGE_SET("Allocated Bytes", totalBytes - lastBytes);
+    lastBytes = totalBytes;
+}
+
+void MemoryTracker::OnUI()
+{
+    if constexpr (!Enabled) {
+        ImGui::TextUnformatted("Build with --track_allocations=y to track allocations.");
+        return;
+    }
+
+    if (!ImGui::BeginTable("Memory", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+        return;
+    ImGui::TableSetupColumn("Tag");
+    ImGui::TableSetupColumn("Live");
+    ImGui::TableSetupColumn("Allocations");
+    ImGui::TableSetupColumn("Allocated");
+    ImGui::TableHeadersRow();
+    for (size_t i = 0; i < (size_t)MemoryTag::Count; i++) {
+        TagStats stats = GetStats((MemoryTag)i);
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(sTagNames[i]);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.2fmb", stats.LiveBytes / 1024.0f / 1024.0f);
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", stats.AllocationCount);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.2fmb", stats.AllocatedBytes / 1024.0f / 1024.0f);
+    }
+    ImGui::EndTable();
+}
+
+#ifdef MNEMEN_TRACK_ALLOCATIONS
+
+/// @brief Stored right before every tracked block, so a delete knows what to give back.
+struct AllocationHeader
+{
+    UInt64 Size;
+    UInt32 Offset;
+    MemoryTag Tag;
+};
+
+/// @brief Room for the header that keeps the default new alignment.
+static constexpr size_t HeaderSpace = 16;
+static_assert(sizeof(AllocationHeader) <= HeaderSpace, "Allocation header doesn't fit");
+
+static void* TrackedAllocate(size_t size, size_t alignment)
+{
+    // The header sits in its own aligned slot, so the block keeps the alignment it asked for.
+    alignment = alignment < HeaderSpace ? HeaderSpace : alignment;
+    size_t total = size + alignment;
+#ifdef _WIN32
+    UInt8* raw = (UInt8*)_aligned_malloc(total, alignment);
+#else
+    UInt8* raw = (UInt8*)aligned_alloc(alignment, (total + alignment - 1) / alignment * alignment);
+#endif
+    if (!raw)
+        return nullptr;
+
+    UInt8* block = raw + alignment;
+    AllocationHeader* header = (AllocationHeader*)(block - HeaderSpace);
+    header->Size = size;
+    header->Offset = (UInt32)alignment;
+    header->Tag = MemoryTracker::GetTag();
+    MemoryTracker::RecordAllocation(header->Tag, size);
+    return block;
+}
+
+static void TrackedFree(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    UInt8* block = (UInt8*)ptr;
+    AllocationHeader* header = (AllocationHeader*)(block - HeaderSpace);
+    MemoryTracker::RecordFree(header->Tag, header->Size);
+#ifdef _WIN32
+    _aligned_free(block - header->Offset);
+#else
+    free(block - header->Offset);
+#endif
+}
+
+static void* TrackedNew(size_t size, size_t alignment)
+{
+    void* block = TrackedAllocate(size ? size : 1, alignment);
+    if (!block)
+        throw std::bad_alloc();
+    return block;
+}
+
+void* operator new(size_t size) { return TrackedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size) { return TrackedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment) { return TrackedNew(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return TrackedNew(size, (size_t)alignment); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size ? size : 1, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size ? size : 1, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size ? size : 1, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size ? size : 1, (size_t)alignment); }
+
+void operator delete(void* ptr) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+
+#endif
@@ -0,0 +1,105 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-05 10:04:27
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+
+#include <atomic>
+
+/// @brief The subsystem an allocation is accounted to.
+enum class MemoryTag : UInt8
+{
+    General,
+    Asset,
+    MeshImport,
+    Script,
+    Audio,
+    Renderer,
+    Editor,
+    Count
+};
+
+/// @brief Accounts heap allocations to the subsystem that made them.
+///
+/// Opt-in: built with `MNEMEN_TRACK_ALLOCATIONS` (`xmake f --track_allocations=y`), the engine replaces
+/// the global operator new and delete, which `Vector` and every other standard container go through,
+/// and each allocation is accounted to the tag of the calling thread. The Lua allocator reports its own
+/// blocks to the Script tag. Without the option, tags cost a thread-local byte and nothing is tracked.
+class MemoryTracker
+{
+public:
+#ifdef MNEMEN_TRACK_ALLOCATIONS
+    static constexpr bool Enabled = true;
+#else
+    static constexpr bool Enabled = false;
+#endif
+
+    /// @brief Live bytes and allocation totals of a tag.
+    struct TagStats
+    {
+        UInt64 LiveBytes = 0;
+        UInt64 AllocationCount = 0;
+        UInt64 AllocatedBytes = 0;
+    };
+
+    /// @brief Returns the tag allocations of the calling thread are accounted to.
+    static MemoryTag GetTag() { return sTag; }
+
+    /// @brief Sets the tag allocations of the calling thread are accounted to. Prefer `MEMORY_TAG`.
+    static void SetTag(MemoryTag tag) { sTag = tag; }
+
+    /// @brief Accounts an allocation made outside of operator new, like the Lua allocator's.
+    static void RecordAllocation(MemoryTag tag, UInt64 size);
+
+    /// @brief Accounts a free made outside of operator delete.
+    static void RecordFree(MemoryTag tag, UInt64 size);
+
+    /// @brief Returns the totals of a tag since startup.
+    static TagStats GetStats(MemoryTag tag);
+
+    /// @brief Returns the display name of a tag.
+    static const char* GetTagName(MemoryTag tag);
+
+    /// @brief Publishes live bytes and this frame's allocations of every tag to the metrics. Call once per frame, before `Metrics::Snapshot`.
+    static void Snapshot();
+
+    /// @brief Draws every tag, inside the profiler panel.
+    static void OnUI();
+private:
+    /// @brief Counters of a tag. Atomics, any thread can allocate.
+    struct TagCounters
+    {
+        std::atomic<UInt64> LiveBytes = 0;
+        std::atomic<UInt64> AllocationCount = 0;
+        std::atomic<UInt64> AllocatedBytes = 0;
+    };
+
+    static Array<TagCounters, (size_t)MemoryTag::Count> sCounters;
+    static thread_local MemoryTag sTag;
+};
+
+/// @brief Accounts the allocations of the calling thread to a tag until the end of the scope.
+class MemoryTagScope
+{
+public:
+    MemoryTagScope(MemoryTag tag)
+        : mPrevious(MemoryTracker::GetTag())
+    {
+        MemoryTracker::SetTag(tag);
+    }
+
+    ~MemoryTagScope()
+    {
+        MemoryTracker::SetTag(mPrevious);
+    }
+private:
+    MemoryTag mPrevious;
+};
+
+/// @def MEMORY_TAG(tag)
+/// @brief Accounts the allocations of the rest of the scope to a tag.
+/// @param tag The MemoryTag.
+#define MEMORY_TAG(tag) MemoryTagScope memoryTagScope(tag)
@@ -0,0 +1,179 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-04 15:30:44
+//
+
+#include "Metrics.hpp"
+
+#include <Core/Logger.hpp>
+#include <Core/Statistics.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <imgui.h>
+
+Metrics::Data Metrics::sData;
+thread_local Metrics::ThreadSlots* Metrics::sThreadSlots = nullptr;
+
+void Metrics::Exit()
+{
+    StopCSV();
+}
+
+UInt16 Metrics::Register(const char* name, MetricType type)
+{
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    auto it = sData.IDs.find(name);
+    if (it != sData.IDs.end())
+        return it->second;
+
+    UInt16 id = (UInt16)sData.Names.size();
+    if (id == MaxMetrics)
+        LOG_WARN("Too many metrics, {0} and any after it will be ignored", name);
+    sData.Names.push_back(name);
+    sData.Types.push_back(type);
+    sData.IDs[name] = id;
+    return id;
+}
+
+void Metrics::Add(UInt16 id, Int64 value)
+{
+    if (id >= MaxMetrics)
+        return;
+    ThreadSlots* slots = sThreadSlots ? sThreadSlots : GetThreadSlots();
+    slots->Values[id].fetch_add(value, std::memory_order_relaxed);
+}
+
+void Metrics::Set(UInt16 id, Int64 value)
+{
+    if (id >= MaxMetrics)
+        return;
+    sData.Gauges[id].store(value, std::memory_order_relaxed);
+}
+
+void Metrics::Snapshot()
+{
+    if (sData.Frame % MemorySampleFrames == 0)
+        Statistics::Update();
+    SampleStatistics();
+
+    Vector<ThreadSlots*> threads;
+    UInt32 count;
+    {
+        std::lock_guard<std::mutex> lock(sData.Mutex);
+        count = std::min((UInt32)sData.Names.size(), MaxMetrics);
+        for (auto& thread : sData.Threads)
+            threads.push_back(thread.get());
+        sData.Values.resize(count);
+        for (UInt32 i = 0; i < count; i++) {
+            if (sData.Types[i] == MetricType::Gauge) {
+                sData.Values[i] = sData.Gauges[i].load(std::memory_order_relaxed);
+                continue;
+            }
+
+            // Whatever a thread adds while this runs lands in the next frame.
+            Int64 total = 0;
+            for (ThreadSlots* slots : threads)
+                total += slots->Values[i].exchange(0, std::memory_order_relaxed);
+            sData.Values[i] = total;
+        }
+    }
+
+    if (sData.RecordingCSV)
+        sData.Rows.push_back({ sData.Frame, sData.Values });
+    sData.Frame++;
+}
+
+UInt32 Metrics::GetCount()
+{
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    return std::min((UInt32)sData.Names.size(), MaxMetrics);
+}
+
+const char* Metrics::GetName(UInt16 id)
+{
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    return id < sData.Names.size() ? sData.Names[id] : "";
+}
+
+void Metrics::StartCSV(const String& path)
+{
+    StopCSV();
+    sData.RecordingCSV = true;
+    sData.CSVPath = path;
+    LOG_INFO("Recording metrics to {0}", path);
+}
+
+void Metrics::StopCSV()
+{
+    if (!sData.RecordingCSV)
+        return;
+    sData.RecordingCSV = false;
+
+    std::ofstream stream(sData.CSVPath);
+    if (!stream.is_open()) {
+        LOG_ERROR("Failed to open metrics export {0}", sData.CSVPath);
+        sData.Rows.clear();
+        return;
+    }
+
+    // Metrics registered during the recording only have values in the later rows, the others are left empty.
+    UInt32 count = GetCount();
+    stream << "Frame";
+    for (UInt32 i = 0; i < count; i++)
+        stream << ",\"" << GetName(i) << "\"";
+    stream << "\n";
+    for (auto& [frame, values] : sData.Rows) {
+        stream << frame;
+        for (UInt32 i = 0; i < count; i++) {
+            stream << ",";
+            if (i < values.size())
+                stream << values[i];
+        }
+        stream << "\n";
+    }
+
+    LOG_INFO("Wrote {0} frames of metrics to {1}", sData.Rows.size(), sData.CSVPath);
+    sData.Rows.clear();
+}
+
+void Metrics::OnUI()
+{
+    if (!ImGui::BeginTable("Metrics", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+        return;
+    ImGui::TableSetupColumn("Name");
+    ImGui::TableSetupColumn("Value");
+    ImGui::TableHeadersRow();
+    for (UInt32 i = 0; i < sData.Values.size(); i++) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(GetName(i));
+        ImGui::TableNextColumn();
+        ImGui::Text("%lld", sData.Values[i]);
+    }
+    ImGui::EndTable();
+}
+
+Metrics::ThreadSlots* Metrics::GetThreadSlots()
+{
+    if (sThreadSlots)
+        return sThreadSlots;
+
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    sData.Threads.push_back(std::make_unique<ThreadSlots>());
+    sThreadSlots = sData.Threads.back().get();
+    return sThreadSlots;
+}
+
+void Metrics::SampleStatistics()
+{
+    // The renderer resets its counts when it begins a frame, they still hold the last one here.
+    const Statistics& stats = Statistics::Get();
+    GAUGE_SET("Draw Calls", stats.DrawCallCount);
+    GAUGE_SET("Dispatches", stats.DispatchCount);
+    GAUGE_SET("Instances", stats.InstanceCount);
+    GAUGE_SET("Triangles", stats.TriangleCount);
+    GAUGE_SET("Meshlets", stats.MeshletCount);
+    GAUGE_SET("RAM Used (MB)", stats.UsedRAM / (1024 * 1024));
+    GAUGE_SET("VRAM Used (MB)", stats.UsedVRAM / (1024 * 1024));
+}
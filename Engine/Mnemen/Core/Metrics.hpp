@@ -0,0 +1,111 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-03-04 15:12:06
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+
+#include <atomic>
+#include <mutex>
+
+/// @brief How a metric's value is gathered.
+enum class MetricType
+{
+    Counter, ///< Summed over a frame from every thread, then starts over from 0.
+    Gauge    ///< Holds the last value set.
+};
+
+/// @brief A registry of named counters and gauges any system can publish to.
+///
+/// Counters are accumulated in per-thread slots, so adding to one from a worker takes no lock and
+/// never contends with another thread. `Snapshot` sums and clears the slots once per frame, and the
+/// snapshot is what the profiler panel, the profiler captures and the CSV export read.
+class Metrics
+{
+public:
+    /// @brief Maximum number of metrics. Updates to metrics registered past it are ignored.
+    static constexpr UInt32 MaxMetrics = 256;
+
+    /// @brief How often the process memory gauges are sampled, in frames. Reading them is a system call.
+    static constexpr UInt32 MemorySampleFrames = 30;
+
+    /// @brief Writes the CSV export, if any.
+    static void Exit();
+
+    /// @brief Registers a metric. Metrics with the same name share their ID.
+    /// @param name The name, which has to outlive the registry, like a string literal.
+    /// @param type How the values are gathered.
+    /// @return The metric ID.
+    static UInt16 Register(const char* name, MetricType type);
+
+    /// @brief Adds to a counter for this frame. Thread-safe and lock-free.
+    static void Add(UInt16 id, Int64 value);
+
+    /// @brief Sets a gauge. Thread-safe and lock-free.
+    static void Set(UInt16 id, Int64 value);
+
+    /// @brief Gathers this frame's values and starts the next frame. Main thread only.
+    static void Snapshot();
+
+    /// @brief Returns the number of registered metrics.
+    static UInt32 GetCount();
+
+    /// @brief Gets the name of a metric.
+    static const char* GetName(UInt16 id);
+
+    /// @brief Gets the values of the last snapshot, by metric ID. Main thread only.
+    static const Vector<Int64>& GetValues() { return sData.Values; }
+
+    /// @brief Starts recording every snapshot for a CSV export, one row per frame.
+    /// @param path The CSV file, written by `StopCSV`.
+    static void StartCSV(const String& path);
+
+    /// @brief Writes the recorded snapshots to the CSV file.
+    static void StopCSV();
+
+    /// @brief Draws the last snapshot, inside the profiler panel.
+    static void OnUI();
+private:
+    /// @brief One thread's share of every counter. Only written by its thread, drained by `Snapshot`.
+    struct ThreadSlots {
+        Array<std::atomic<Int64>, MaxMetrics> Values = {};
+    };
+
+    /// @brief Gets the calling thread's slots, creating them on first use.
+    static ThreadSlots* GetThreadSlots();
+
+    /// @brief Publishes the engine statistics as gauges.
+    static void SampleStatistics();
+
+    static struct Data {
+        std::mutex Mutex; ///< Guards Names, Types, IDs and Threads.
+        Vector<const char*> Names;
+        Vector<MetricType> Types;
+        UnorderedMap<String, UInt16> IDs;
+        Vector<Unique<ThreadSlots>> Threads; ///< Never freed, threads may still write to them.
+        Array<std::atomic<Int64>, MaxMetrics> Gauges = {};
+
+        Vector<Int64> Values;
+        UInt64 Frame = 0;
+
+        bool RecordingCSV = false;
+        String CSVPath;
+        Vector<Pair<UInt64, Vector<Int64>>> Rows;
+    } sData;
+
+    static thread_local ThreadSlots* sThreadSlots; ///< The calling thread's slots, set on its first update.
+};
+
+/// @def COUNTER_ADD(name, value)
+/// @brief Adds to a named counter for this frame, registering it on the first pass.
+/// @param name The name of the counter, a string literal.
+#define COUNTER_ADD(name, value) \
+    do { static const UInt16 sMetricID = Metrics::Register(name, MetricType::Counter); Metrics::Add(sMetricID, (Int64)(value)); } while (0)
+
+/// @def GAUGE_SET(name, value)
+/// @brief Sets a named gauge, registering it on the first pass.
+/// @param name The name of the gauge, a string literal.
+#define GAUGE_SET(name, value) \
+    do { static const UInt16 sMetricID = Metrics::Register(name, MetricType::Gauge); Metrics::Set(sMetricID, (Int64)(value)); } while (0)
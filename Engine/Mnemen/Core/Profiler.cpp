@@ -5,78 +5,240 @@
 
 #include "Profiler.hpp"
 
+#include <Core/FrameStats.hpp>
+#include <Core/JobSystem.hpp>
+#include <Core/Logger.hpp>
+#include <Core/MemoryTracker.hpp>
+#include <Core/Metrics.hpp>
 #include <RHI/Uploader.hpp>
 #include <Core/Statistics.hpp>
+#include <Script/ScriptProfiler.hpp>
 
+#include <algorithm>
+#include <fstream>
 #include <sstream>
 #include <imgui.h>
 #include <FontAwesome/FontAwesome.hpp>
 
-Profiler::Data Profiler::sData = {};
+Profiler::Data Profiler::sData;
 
-// ProfilerEntry constructor
-ProfilerEntry::ProfilerEntry(const String& name)
-    : mName(name), mFrame(Profiler::sData.CurrentFrame)
+/// @brief Milliseconds per tick of the performance counter.
+static const double sMsPerTick = [] {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    return 1000.0 / frequency.QuadPart;
+}();
+
+thread_local Profiler::ThreadBuffer* Profiler::sThreadBuffer = nullptr;
+
+ProfilerScope::ProfilerScope(UInt16 name)
+    : mName(name)
 {
-    mTimer.Restart();
+    Profiler::ThreadBuffer* buffer = Profiler::sThreadBuffer ? Profiler::sThreadBuffer : Profiler::GetThreadBuffer();
+    mDepth = buffer->Depth++;
+    mStart = Profiler::GetTicks();
 }
 
-ProfilerEntry::ProfilerEntry(const String& name, CommandBuffer::Ref commandBuffer)
-    : mName(name), mFrame(Profiler::sData.CurrentFrame)
+ProfilerScope::~ProfilerScope()
 {
-    mGPU = true;
+    UInt64 end = Profiler::GetTicks();
+
+    Profiler::ThreadBuffer* buffer = Profiler::sThreadBuffer;
+    buffer->Depth--;
+
+    // Single writer: only this thread moves Write, the main thread only ever moves Read forward.
+    UInt64 write = buffer->Write.load(std::memory_order_relaxed);
+    if (write - buffer->Read.load(std::memory_order_acquire) >= Profiler::EventsPerThread) {
+        buffer->Dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->Events[write % Profiler::EventsPerThread] = { mStart, end, mName, mDepth, buffer->Index };
+    buffer->Write.store(write + 1, std::memory_order_release);
+}
+
+ProfilerGPUScope::ProfilerGPUScope(UInt16 name, CommandBuffer::Ref commandBuffer)
+    : mScope(name), mCommandBuffer(commandBuffer), mName(name)
+{
+    mDepth = Profiler::sData.GPUDepth++;
     mTimerIndex = Profiler::StartGPUTimer(commandBuffer);
-    mCommandBuffer = commandBuffer;
 }
 
-// Destructor automatically records elapsed time and pushes the entry
-ProfilerEntry::~ProfilerEntry()
+ProfilerGPUScope::~ProfilerGPUScope()
 {
-    mCPUTime = mTimer.GetElapsed();
-    if (mGPU) {
-        Profiler::StopGPUTimer(mCommandBuffer, mTimerIndex);
-    }
-    Profiler::PushEntry(*this);
+    Profiler::StopGPUTimer(mCommandBuffer, mTimerIndex);
+    Profiler::sData.GPUDepth--;
+
+    // Command buffers are recorded on the main thread, and so are readbacks.
+    Profiler::sData.GPUScopes.push_back({ mName, mTimerIndex | ((UInt32)mDepth << 16) });
 }
 
 void Profiler::Init(RHI::Ref rhi)
 {
     GPUTimer::Init(rhi);
+    MeasureOverhead();
+    sData.FrameStart = GetTicks();
 }
 
 void Profiler::Exit()
 {
-    sData.EntryCount = 0;
+    StopCapture();
+    for (ProfilerFrame& frame : sData.Frames)
+        frame = {};
     sData.Resources.clear();
     GPUTimer::Exit();
 }
 
-// BeginFrame: Move to next frame
 void Profiler::BeginFrame()
 {
-    sData.CurrentFrame++;
-}
+    UInt64 now = GetTicks();
 
-// PushEntry: Reuse existing entries if possible
-void Profiler::PushEntry(const ProfilerEntry& entry)
-{
-    // Find an existing inactive entry (from an old frame)
-    for (UInt64 i = 0; i < sData.EntryCount; ++i) {
-        if (sData.Entries[i].GetFrame() != sData.CurrentFrame) {
-            sData.Entries[i] = entry;
-            return;
+    ProfilerFrame& frame = sData.Frames[sData.CurrentFrame % HistoryFrames];
+    if (!sData.Paused) {
+        frame.Index = sData.CurrentFrame;
+        frame.Start = sData.FrameStart;
+        frame.End = now;
+        frame.Events.clear();
+    }
+    bool keep = !sData.Paused || (sData.Capturing && sData.CaptureDelay == 0);
+    Vector<ProfilerEvent> paused;
+    Vector<ProfilerEvent>& events = sData.Paused ? paused : frame.Events;
+    events.insert(events.end(), sData.GPUEvents.begin(), sData.GPUEvents.end());
+    sData.GPUEvents.clear();
+
+    Vector<ThreadBuffer*> threads;
+    {
+        std::lock_guard<std::mutex> lock(sData.Mutex);
+        for (auto& thread : sData.Threads)
+            threads.push_back(thread.get());
+    }
+
+    // Scopes still open on other threads land in the frame they end in.
+    for (ThreadBuffer* thread : threads) {
+        UInt64 read = thread->Read.load(std::memory_order_relaxed);
+        UInt64 write = thread->Write.load(std::memory_order_acquire);
+        if (keep) {
+            for (UInt64 i = read; i < write; i++)
+                events.push_back(thread->Events[i % EventsPerThread]);
         }
+        thread->Read.store(write, std::memory_order_release);
+        sData.Dropped += thread->Dropped.exchange(0, std::memory_order_relaxed);
     }
 
-    // If no reusable entry, add a new one
-    if (sData.EntryCount < MAX_PROFILER_ENTRIES) {
-        sData.Entries[sData.EntryCount++] = entry;
-        return;
+    if (keep) {
+        std::sort(events.begin(), events.end(), [](const ProfilerEvent& a, const ProfilerEvent& b) {
+            return a.Thread != b.Thread ? a.Thread < b.Thread : a.Start < b.Start;
+        });
+    }
+
+    if (sData.Capturing) {
+        if (sData.CaptureDelay > 0) {
+            if (--sData.CaptureDelay == 0)
+                sData.CapturingAssets = true;
+        } else {
+            ProfilerFrame& captured = sData.CaptureFrames.emplace_back();
+            captured.Index = sData.CurrentFrame;
+            captured.Start = sData.FrameStart;
+            captured.End = now;
+            captured.Events = events;
+
+            // Metrics::Snapshot runs right before, its values are this frame's.
+            sData.CaptureCounters.push_back({ now, Metrics::GetValues() });
+
+            if (--sData.CaptureLeft == 0)
+                StopCapture();
+        }
     }
 
-    // If the buffer is full, overwrite the oldest entry (ring buffer behavior)
-    UInt64 index = sData.EntryCount % MAX_PROFILER_ENTRIES;
-    sData.Entries[index] = entry;
+    if (!sData.Paused)
+        sData.CurrentFrame++;
+    sData.FrameStart = now;
+}
+
+UInt16 Profiler::RegisterName(const char* name)
+{
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    auto it = sData.NameIDs.find(name);
+    if (it != sData.NameIDs.end())
+        return it->second;
+
+    UInt16 id = (UInt16)sData.Names.size();
+    sData.Names.push_back(name);
+    sData.NameIDs[name] = id;
+    return id;
+}
+
+const char* Profiler::GetName(UInt16 id)
+{
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    return id < sData.Names.size() ? sData.Names[id] : "";
+}
+
+const String& Profiler::GetThreadName(UInt16 id)
+{
+    static const String gpu = "GPU";
+    if (id == GPUThread)
+        return gpu;
+
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    return sData.Threads[id]->Name;
+}
+
+const ProfilerFrame* Profiler::GetFrame(UInt32 framesAgo)
+{
+    if (framesAgo >= HistoryFrames || framesAgo >= sData.CurrentFrame)
+        return nullptr;
+    return &sData.Frames[(sData.CurrentFrame - 1 - framesAgo) % HistoryFrames];
+}
+
+UInt64 Profiler::GetTicks()
+{
+    LARGE_INTEGER ticks;
+    QueryPerformanceCounter(&ticks);
+    return ticks.QuadPart;
+}
+
+double Profiler::TicksToMs(UInt64 ticks)
+{
+    return ticks * sMsPerTick;
+}
+
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer()
+{
+    if (sThreadBuffer)
+        return sThreadBuffer;
+
+    std::lock_guard<std::mutex> lock(sData.Mutex);
+    Unique<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+    buffer->Index = (UInt16)sData.Threads.size();
+
+    Int32 worker = JobSystem::GetCurrentWorker();
+    if (sData.Threads.empty())
+        buffer->Name = "Main Thread";
+    else if (worker >= 0)
+        buffer->Name = "Worker " + std::to_string(worker);
+    else
+        buffer->Name = "Thread " + std::to_string(buffer->Index);
+
+    sThreadBuffer = buffer.get();
+    sData.Threads.push_back(std::move(buffer));
+    return sThreadBuffer;
+}
+
+void Profiler::MeasureOverhead()
+{
+    constexpr UInt32 iterations = EventsPerThread / 2;
+
+    // Main thread only, so the events can be thrown away right after.
+    ThreadBuffer* buffer = GetThreadBuffer();
+    UInt64 start = GetTicks();
+    for (UInt32 i = 0; i < iterations; i++) {
+        PROFILE_SCOPE("Profiler Overhead");
+    }
+    UInt64 end = GetTicks();
+    buffer->Read.store(buffer->Write.load(std::memory_order_relaxed), std::memory_order_release);
+
+    sData.ScopeOverheadNs = TicksToMs(end - start) * 1000000.0 / iterations;
+    LOG_INFO("Profiler scope overhead: {0}ns", sData.ScopeOverheadNs);
 }
 
 UInt32 Profiler::StartGPUTimer(CommandBuffer::Ref cmdList)
@@ -100,6 +262,145 @@ void Profiler::ResolveGPUQueries(CommandBuffer::Ref cmdList)
 void Profiler::ReadbackGPUResults()
 {
     GPUTimer::Readback();
+
+    for (auto& [name, packed] : sData.GPUScopes) {
+        ProfilerEvent event = {};
+        GPUTimer::GetRange(packed & 0xFFFF, event.Start, event.End);
+        event.Name = name;
+        event.Depth = (UInt16)(packed >> 16);
+        event.Thread = GPUThread;
+        sData.GPUEvents.push_back(event);
+    }
+    sData.GPUScopes.clear();
+}
+
+void Profiler::StartCapture(const String& path, UInt32 frameCount, UInt32 delayFrames)
+{
+    StopCapture();
+    if (frameCount == 0)
+        return;
+
+    sData.Capturing = true;
+    sData.CapturePath = path;
+    sData.CaptureDelay = delayFrames;
+    sData.CaptureLeft = frameCount;
+    sData.CapturingAssets = delayFrames == 0;
+    LOG_INFO("Capturing {0} frames to {1}", frameCount, path);
+}
+
+void Profiler::StopCapture()
+{
+    if (!sData.Capturing)
+        return;
+
+    sData.Capturing = false;
+    sData.CapturingAssets = false;
+
+    std::lock_guard<std::mutex> lock(sData.AssetMutex);
+    if (sData.CaptureFrames.empty())
+        LOG_WARN("Profiler capture {0} has no frames, nothing written", sData.CapturePath);
+    else
+        WriteTrace(sData.CapturePath, sData.CaptureFrames, sData.CaptureCounters, sData.AssetLoads);
+
+    sData.CaptureFrames.clear();
+    sData.CaptureCounters.clear();
+    sData.AssetLoads.clear();
+}
+
+bool Profiler::DumpHistory(const String& path, UInt32 frameCount)
+{
+    Vector<ProfilerFrame> frames;
+    for (UInt32 i = std::min(frameCount, HistoryFrames); i-- > 0;) {
+        const ProfilerFrame* frame = GetFrame(i);
+        if (frame)
+            frames.push_back(*frame);
+    }
+    if (frames.empty())
+        return false;
+    return WriteTrace(path, frames, {}, {});
+}
+
+void Profiler::RecordAssetLoad(const String& path, UInt64 start)
+{
+    if (!sData.CapturingAssets)
+        return;
+
+    UInt64 end = GetTicks();
+    UInt16 thread = GetThreadBuffer()->Index;
+    std::lock_guard<std::mutex> lock(sData.AssetMutex);
+    sData.AssetLoads.push_back({ path, start, end, thread });
+}
+
+/// @brief Escapes a string for a JSON string literal.
+static String EscapeJSON(const String& string)
+{
+    String result;
+    result.reserve(string.size());
+    for (char c : string) {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        if ((unsigned char)c < 0x20)
+            continue;
+        result += c;
+    }
+    return result;
+}
+
+bool Profiler::WriteTrace(const String& path, const Vector<ProfilerFrame>& frames, const Vector<CounterSample>& counters, const Vector<AssetLoad>& assetLoads)
+{
+    std::ofstream stream(path);
+    if (!stream.is_open()) {
+        LOG_ERROR("Failed to open profiler trace {0}", path);
+        return false;
+    }
+
+    // Timestamps are microseconds from the start of the first frame.
+    UInt64 base = frames.front().Start;
+    auto time = [base](UInt64 ticks) { return ((Int64)ticks - (Int64)base) * sMsPerTick * 1000.0; };
+
+    char line[1024];
+    bool first = true;
+    auto write = [&](const String& event) {
+        stream << (first ? "\n" : ",\n") << event;
+        first = false;
+    };
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    Set<UInt16> threads;
+    for (const ProfilerFrame& frame : frames) {
+        snprintf(line, sizeof(line), "{\"name\":\"Frame %llu\",\"cat\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":%.3f}", frame.Index, time(frame.Start));
+        write(line);
+
+        for (const ProfilerEvent& event : frame.Events) {
+            threads.insert(event.Thread);
+            snprintf(line, sizeof(line), "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                     EscapeJSON(GetName(event.Name)).c_str(), event.Thread == GPUThread ? "gpu" : "cpu", event.Thread, time(event.Start), TicksToMs(event.End - event.Start) * 1000.0);
+            write(line);
+        }
+    }
+
+    for (const CounterSample& sample : counters) {
+        for (UInt32 i = 0; i < sample.Values.size(); i++) {
+            snprintf(line, sizeof(line), "{\"name\":\"%s\",\"cat\":\"metric\",\"ph\":\"C\",\"pid\":0,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                     EscapeJSON(Metrics::GetName(i)).c_str(), time(sample.Time), sample.Values[i]);
+            write(line);
+        }
+    }
+
+    for (const AssetLoad& load : assetLoads) {
+        threads.insert(load.Thread);
+        write("{\"name\":\"Load Asset\",\"cat\":\"asset\",\"ph\":\"X\",\"pid\":0,\"tid\":" + std::to_string(load.Thread) +
+              ",\"ts\":" + std::to_string(time(load.Start)) + ",\"dur\":" + std::to_string(TicksToMs(load.End - load.Start) * 1000.0) +
+              ",\"args\":{\"path\":\"" + EscapeJSON(load.Path) + "\"}}");
+    }
+
+    for (UInt16 thread : threads)
+        write("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" + std::to_string(thread) + ",\"args\":{\"name\":\"" + EscapeJSON(GetThreadName(thread)) + "\"}}");
+
+    stream << "\n]}\n";
+    LOG_INFO("Wrote {0} profiled frames to {1}", frames.size(), path);
+    return true;
 }
 
 Util::UUID Profiler::PushResource(UInt64 size, String Name)
@@ -191,14 +492,51 @@ void Profiler::OnUI()
         ImGui::TreePop();
     }
     if (ImGui::TreeNodeEx("CPU Profiler", ImGuiTreeNodeFlags_Framed)) {
-        for (UInt64 i = 0; i < sData.EntryCount; ++i) {
-            const ProfilerEntry& entry = sData.Entries[i];
-            if (!entry.IsGPU()) {
-                ImGui::Text("%s : %fms", entry.GetName().c_str(), entry.GetCPUTime());
+        static int framesAgo = 0;
+        ImGui::Checkbox("Pause", &sData.Paused);
+        ImGui::SameLine();
+        ImGui::SliderInt("Frames Ago", &framesAgo, 0, HistoryFrames - 1);
+        ImGui::Text("Scope overhead: %.1fns, %llu events dropped", sData.ScopeOverheadNs, sData.Dropped);
+
+        const ProfilerFrame* frame = GetFrame(framesAgo);
+        if (frame) {
+            ImGui::Text("Frame %llu : %.3fms", frame->Index, TicksToMs(frame->End - frame->Start));
+            ImGui::Separator();
+
+            // Events are sorted by thread then start, so parents come right before their children.
+            Int32 thread = -1;
+            bool open = false;
+            for (const ProfilerEvent& event : frame->Events) {
+                if (event.Thread != thread) {
+                    if (open)
+                        ImGui::TreePop();
+                    thread = event.Thread;
+                    open = ImGui::TreeNodeEx(GetThreadName(event.Thread).c_str(), ImGuiTreeNodeFlags_DefaultOpen);
+                }
+                if (open)
+                    ImGui::Text("%*s%s : %.3fms", event.Depth * 2, "", GetName(event.Name), TicksToMs(event.End - event.Start));
             }
+            if (open)
+                ImGui::TreePop();
         }
         ImGui::TreePop();
     }
+    if (ImGui::TreeNodeEx("Memory", ImGuiTreeNodeFlags_Framed)) {
+        MemoryTracker::OnUI();
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNodeEx("Metrics", ImGuiTreeNodeFlags_Framed)) {
+        Metrics::OnUI();
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNodeEx("Frame Times", ImGuiTreeNodeFlags_Framed)) {
+        FrameStats::OnUI();
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNodeEx("Script Profiler", ImGuiTreeNodeFlags_Framed)) {
+        ScriptProfiler::OnUI();
+        ImGui::TreePop();
+    }
     if (ImGui::TreeNodeEx("GPU Resource Tree", ImGuiTreeNodeFlags_Framed)) {
         const char* tags[] = {
             ICON_FA_CUBE " Model Geometry",
@@ -12,59 +12,64 @@
 #include <RHI/CommandBuffer.hpp>
 #include <RHI/GPUTimer.hpp>
 
-constexpr size_t MAX_PROFILER_ENTRIES = 1024;
+#include <atomic>
+#include <mutex>
 
-/// @struct ProfilerEntry
-/// @brief Represents a single profiling entry for CPU and GPU execution times.
-struct ProfilerEntry
+/// @brief A timed scope, as recorded by the profiler.
+struct ProfilerEvent
 {
-public:
-    /// @brief Default constructor.
-    ProfilerEntry() = default;
-
-    /// @brief Constructs a CPU profiler entry.
-    /// @param name The name of the profiler entry.
-    ProfilerEntry(const String& name);
-
-    /// @brief Constructs a GPU profiler entry.
-    /// @param name The name of the profiler entry.
-    /// @param commandBuffer The command buffer associated with the GPU query.
-    ProfilerEntry(const String& name, CommandBuffer::Ref commandBuffer);
-
-    /// @brief Destructor.
-    ~ProfilerEntry();
-
-    /// @brief Gets the CPU execution time.
-    /// @return CPU execution time in milliseconds.
-    float GetCPUTime() const { return mCPUTime; }
-
-    /// @brief Gets the GPU execution time.
-    /// @return GPU execution time in milliseconds.
-    float GetGPUTime() const { return mGPUTime; }
-
-    /// @brief Gets the name of the profiling entry.
-    /// @return The name of the entry.
-    const String& GetName() const { return mName; }
+    /// @brief Start of the scope, in profiler ticks.
+    UInt64 Start;
+    /// @brief End of the scope, in profiler ticks.
+    UInt64 End;
+    /// @brief The name ID of the scope, see `Profiler::GetName`.
+    UInt16 Name;
+    /// @brief How many scopes of the same thread the scope is nested in.
+    UInt16 Depth;
+    /// @brief The thread ID of the scope, see `Profiler::GetThreadName`.
+    UInt16 Thread;
+};
 
-    /// @brief Gets the frame index for this entry.
-    /// @return The frame index.
-    UInt64 GetFrame() const { return mFrame; }
+/// @brief Every scope that ended during one frame.
+struct ProfilerFrame
+{
+    /// @brief The frame index.
+    UInt64 Index = 0;
+    /// @brief Start of the frame, in profiler ticks.
+    UInt64 Start = 0;
+    /// @brief End of the frame, in profiler ticks.
+    UInt64 End = 0;
+    /// @brief The events of the frame, sorted by thread then start.
+    Vector<ProfilerEvent> Events;
+};
 
-    /// @brief Checks if this is a GPU profiling entry.
-    /// @return True if it's a GPU entry, false otherwise.
-    const bool IsGPU() const { return mGPU; }
+/// @brief Times a CPU scope, from construction to destruction.
+class ProfilerScope
+{
+public:
+    /// @param name The name ID of the scope, from `Profiler::RegisterName`.
+    ProfilerScope(UInt16 name);
+    ~ProfilerScope();
+private:
+    UInt64 mStart;
+    UInt16 mName;
+    UInt16 mDepth;
+};
 
+/// @brief Times a scope on both the CPU and the GPU.
+class ProfilerGPUScope
+{
+public:
+    /// @param name The name ID of the scope, from `Profiler::RegisterName`.
+    /// @param commandBuffer The command buffer the GPU query is recorded in.
+    ProfilerGPUScope(UInt16 name, CommandBuffer::Ref commandBuffer);
+    ~ProfilerGPUScope();
 private:
-    friend class Profiler;
-
-    Timer mTimer;                 ///< Timer object to measure CPU time.
-    String mName;                 ///< Name of the profiler entry.
-    float mCPUTime = 0.0f;        ///< CPU execution time in milliseconds.
-    float mGPUTime = 0.0f;        ///< GPU execution time in milliseconds.
-    bool mGPU = false;            ///< Flag to determine if it's a GPU entry.
-    UInt32 mTimerIndex = 0;       ///< Index for the GPU timer.
-    UInt64 mFrame = 0;            ///< Frame index.
-    CommandBuffer::Ref mCommandBuffer; ///< Associated command buffer for GPU profiling.
+    ProfilerScope mScope;
+    CommandBuffer::Ref mCommandBuffer;
+    UInt32 mTimerIndex;
+    UInt16 mName;
+    UInt16 mDepth;
 };
 
 /// @brief A resource displayed by the profiler
@@ -87,10 +92,24 @@ struct ProfiledResource
 };
 
 /// @class Profiler
-/// @brief Manages CPU and GPU profiling entries, including GPU timing queries.
+/// @brief Records CPU scopes from every thread, GPU timing queries and GPU resources.
+///
+/// Each thread writes its scopes to its own ring buffer, which only the main thread reads, so
+/// recording a scope takes no lock. Scope names are registered once per call site and events
+/// only carry their ID. `BeginFrame` gathers what every thread recorded into a history of the
+/// last `HistoryFrames` frames.
 class Profiler
 {
 public:
+    /// @brief Number of frames kept in the history.
+    static constexpr UInt32 HistoryFrames = 128;
+
+    /// @brief Events each thread can record before the main thread gathers them. More are dropped.
+    static constexpr UInt32 EventsPerThread = 16384;
+
+    /// @brief The thread ID of GPU events.
+    static constexpr UInt16 GPUThread = 0xFFFF;
+
     /// @brief Initializes the profiler system.
     /// @param rhi The rendering hardware interface (RHI) reference.
     static void Init(RHI::Ref rhi);
@@ -98,12 +117,59 @@ public:
     /// @brief Shuts down the profiler system.
     static void Exit();
 
-    /// @brief Marks the beginning of a new frame for profiling.
+    /// @brief Gathers the events of the frame that ended into the history and starts a new one. Main thread only.
     static void BeginFrame();
 
-    /// @brief Pushes a new profiling entry into the profiler.
-    /// @param entry The profiling entry to be recorded.
-    static void PushEntry(const ProfilerEntry& entry);
+    /// @brief Registers a scope name. Scopes with the same name share their ID.
+    /// @param name The name, which has to outlive the profiler, like a string literal.
+    /// @return The name ID.
+    static UInt16 RegisterName(const char* name);
+
+    /// @brief Gets a registered name.
+    static const char* GetName(UInt16 id);
+
+    /// @brief Gets the name of a thread that recorded events.
+    static const String& GetThreadName(UInt16 id);
+
+    /// @brief Gets a frame of the history. Main thread only.
+    /// @param framesAgo 0 for the last complete frame, up to `HistoryFrames - 1`.
+    /// @return The frame, or null if it wasn't recorded.
+    static const ProfilerFrame* GetFrame(UInt32 framesAgo);
+
+    /// @brief Gets the current time in profiler ticks.
+    static UInt64 GetTicks();
+
+    /// @brief Converts profiler ticks to milliseconds.
+    static double TicksToMs(UInt64 ticks);
+
+    /// @brief Returns what recording a scope costs, in nanoseconds, as measured by `Init`.
+    static double GetScopeOverhead() { return sData.ScopeOverheadNs; }
+
+    /// @brief Starts recording frames to a Chrome trace file, viewable in chrome://tracing or Perfetto.
+    ///
+    /// The trace holds the CPU scopes of every thread, the GPU scopes once read back, the metrics
+    /// of every frame and the assets loaded during the capture.
+    /// @param path The JSON file to write.
+    /// @param frameCount How many frames to record before the file is written.
+    /// @param delayFrames How many frames to skip first, to leave loading out.
+    static void StartCapture(const String& path, UInt32 frameCount, UInt32 delayFrames = 0);
+
+    /// @brief Writes the frames recorded so far and stops the capture.
+    static void StopCapture();
+
+    /// @brief Returns whether a capture is in progress.
+    static bool IsCapturing() { return sData.Capturing; }
+
+    /// @brief Writes the last frames of the history as a Chrome trace file. Main thread only.
+    /// @param path The JSON file to write.
+    /// @param frameCount How many frames, from the last complete one back.
+    /// @return False if there was nothing to write or the file couldn't be opened.
+    static bool DumpHistory(const String& path, UInt32 frameCount);
+
+    /// @brief Records an asset load in the capture, if any. Thread-safe.
+    /// @param path The path of the asset.
+    /// @param start When the load started, in profiler ticks. It ends now.
+    static void RecordAssetLoad(const String& path, UInt64 start);
 
     /// @brief Displays profiling data in a UI panel.
     static void OnUI();
@@ -137,31 +203,97 @@ public:
     /// @brief Pops a resource in the render list
     static void PopResource(Util::UUID id);
 private:
-    friend class ProfilerEntry;
+    friend class ProfilerScope;
+    friend class ProfilerGPUScope;
+
+    /// @brief The events of one thread. Written by its thread only, read by the main thread only.
+    struct ThreadBuffer {
+        Array<ProfilerEvent, EventsPerThread> Events; ///< Ring of recorded events.
+        std::atomic<UInt64> Write = 0; ///< Events written so far, by the thread.
+        std::atomic<UInt64> Read = 0; ///< Events gathered so far, by the main thread.
+        std::atomic<UInt64> Dropped = 0; ///< Events lost because the ring was full.
+        UInt16 Depth = 0; ///< Number of open scopes.
+        UInt16 Index = 0; ///< The thread ID.
+        String Name; ///< The thread name.
+    };
+
+    /// @brief Gets the calling thread's buffer, creating it on first use.
+    static ThreadBuffer* GetThreadBuffer();
+
+    /// @brief Times empty scopes to fill in ScopeOverheadNs.
+    static void MeasureOverhead();
+
+    /// @brief An asset load, for captures.
+    struct AssetLoad {
+        String Path;
+        UInt64 Start;
+        UInt64 End;
+        UInt16 Thread;
+    };
+
+    /// @brief The metrics of a captured frame.
+    struct CounterSample {
+        UInt64 Time;
+        Vector<Int64> Values;
+    };
+
+    /// @brief Writes frames as Chrome trace events.
+    static bool WriteTrace(const String& path, const Vector<ProfilerFrame>& frames, const Vector<CounterSample>& counters, const Vector<AssetLoad>& assetLoads);
 
     /// @brief Internal profiler data structure.
     struct Data {
-        ProfilerEntry Entries[MAX_PROFILER_ENTRIES]; ///< Array of profiling entries.
-        UInt64 EntryCount = 0; ///< Number of active profiling entries.
+        std::mutex Mutex; ///< Guards Names, NameIDs and Threads.
+        Vector<const char*> Names; ///< Registered names, by ID.
+        UnorderedMap<String, UInt16> NameIDs; ///< Registered IDs, by name.
+        Vector<Unique<ThreadBuffer>> Threads; ///< Every thread that recorded an event. Never freed, threads may still write to them.
+
+        Array<ProfilerFrame, HistoryFrames> Frames; ///< Ring of the last frames.
         UInt64 CurrentFrame = 0; ///< Current frame index.
+        UInt64 FrameStart = 0; ///< Start of the current frame, in ticks.
+        bool Paused = false; ///< Whether the history is frozen for inspection.
+        double ScopeOverheadNs = 0.0; ///< Measured cost of a scope.
+        UInt64 Dropped = 0; ///< Events dropped so far, every thread included.
+
+        Vector<Pair<UInt16, UInt32>> GPUScopes; ///< Name and timer index of the GPU scopes waiting on a readback.
+        Vector<ProfilerEvent> GPUEvents; ///< Read back GPU scopes, gathered with the next frame.
+        UInt16 GPUDepth = 0; ///< Number of open GPU scopes.
+
+        bool Capturing = false; ///< Whether a capture is in progress.
+        std::atomic<bool> CapturingAssets = false; ///< Whether asset loads are being recorded, once the capture delay is over.
+        String CapturePath; ///< Where the capture goes.
+        UInt32 CaptureDelay = 0; ///< Frames left to skip.
+        UInt32 CaptureLeft = 0; ///< Frames left to record.
+        Vector<ProfilerFrame> CaptureFrames; ///< Recorded frames.
+        Vector<CounterSample> CaptureCounters; ///< Recorded metrics, one sample per frame.
+        std::mutex AssetMutex; ///< Guards AssetLoads.
+        Vector<AssetLoad> AssetLoads; ///< Recorded asset loads.
+
         UnorderedMap<Util::UUID, ProfiledResource> Resources; ///< List of profiled resources
     };
 
     static Data sData; ///< Static instance of profiler data.
+    static thread_local ThreadBuffer* sThreadBuffer; ///< The calling thread's buffer, set on its first scope.
 };
 
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
 /// @def PROFILE_FUNCTION()
-/// @brief Creates a profiler entry for the current function.
-/// @note Uses the function name as the profiling entry name.
-#define PROFILE_FUNCTION() ProfilerEntry entry(__FUNCTION__)
+/// @brief Profiles the rest of the current function.
+/// @note Uses the function name as the scope name.
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
 
 /// @def PROFILE_SCOPE(name)
-/// @brief Creates a profiler entry for a custom named scope.
-/// @param name The name of the profiling entry.
-#define PROFILE_SCOPE(name) ProfilerEntry entry(name)
+/// @brief Profiles the rest of the current scope.
+/// @param name The name of the scope. Registered on the first pass only, so it has to be a string literal.
+#define PROFILE_SCOPE(name) \
+    static const UInt16 PROFILE_CONCAT(sProfileName, __LINE__) = Profiler::RegisterName(name); \
+    ProfilerScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(sProfileName, __LINE__))
 
 /// @def PROFILE_SCOPE_GPU(name, list)
-/// @brief Creates a profiler entry for GPU profiling within a named scope.
-/// @param name The name of the profiling entry.
+/// @brief Profiles the rest of the current scope on the CPU and the GPU.
+/// @param name The name of the scope. Registered on the first pass only, so it has to be a string literal.
 /// @param list The command buffer associated with the GPU execution.
-#define PROFILE_SCOPE_GPU(name, list) ProfilerEntry entry(name, list)
+#define PROFILE_SCOPE_GPU(name, list) \
+    static const UInt16 PROFILE_CONCAT(sProfileName, __LINE__) = Profiler::RegisterName(name); \
+    ProfilerGPUScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(sProfileName, __LINE__), list)
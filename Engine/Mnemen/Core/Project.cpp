@@ -29,6 +29,13 @@ void Project::Load(const String& path)
         auto& settings = root["settings"];
 
         Settings.PhysicsRefreshRate = settings.value("physicsRefreshRate", 90.0f);
+        Settings.MaxPhysicsSubsteps = settings.value("maxPhysicsSubsteps", 4);
+        Settings.ScriptBudgetMs = settings.value("scriptBudgetMs", 0.0f);
+        Settings.ScriptGCIncremental = settings.value("scriptGCMode", "generational") == "incremental";
+        Settings.ScriptGCPause = settings.value("scriptGCPause", 200);
+        Settings.ScriptGCStepMultiplier = settings.value("scriptGCStepMultiplier", 100);
+        Settings.ScriptGCStepSizeKb = settings.value("scriptGCStepSizeKb", 8);
+        Settings.ScriptGCBudgetMs = settings.value("scriptGCBudgetMs", 0.0f);
 
         String compressionFormat = settings.value("compressionFormat", "bc3");
         if (compressionFormat == "bc3")
@@ -56,6 +63,13 @@ void Project::Save(const String& path)
     
     // Save settings
     root["settings"]["physicsRefreshRate"] = Settings.PhysicsRefreshRate;
+    root["settings"]["maxPhysicsSubsteps"] = Settings.MaxPhysicsSubsteps;
+    root["settings"]["scriptBudgetMs"] = Settings.ScriptBudgetMs;
+    root["settings"]["scriptGCMode"] = Settings.ScriptGCIncremental ? "incremental" : "generational";
+    root["settings"]["scriptGCPause"] = Settings.ScriptGCPause;
+    root["settings"]["scriptGCStepMultiplier"] = Settings.ScriptGCStepMultiplier;
+    root["settings"]["scriptGCStepSizeKb"] = Settings.ScriptGCStepSizeKb;
+    root["settings"]["scriptGCBudgetMs"] = Settings.ScriptGCBudgetMs;
     root["settings"]["compressionFormat"] = (Settings.Format == CompressionFormat::BC7) ? "bc7" : "bc3";
     
     // Write to file
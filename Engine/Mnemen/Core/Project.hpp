@@ -17,6 +17,13 @@ struct ProjectSettings
 {
     CompressionFormat Format;
     float PhysicsRefreshRate;
+    int MaxPhysicsSubsteps = 4;
+    float ScriptBudgetMs = 0.0f;
+    bool ScriptGCIncremental = false;
+    int ScriptGCPause = 200;
+    int ScriptGCStepMultiplier = 100;
+    int ScriptGCStepSizeKb = 8;
+    float ScriptGCBudgetMs = 0.0f;
 };
 
 struct Project
@@ -4,9 +4,16 @@
 //
 
 #include "Statistics.hpp"
-#include <Windows.h>
-#include <Psapi.h>
 
+#if defined(_WIN32)
+    #include <Windows.h>
+    #include <Psapi.h>
+#elif defined(__linux__)
+    #include <fstream>
+    #include <unistd.h>
+#endif
+
+#if defined(_WIN32)
 void Statistics::Update()
 {
     Statistics& stats = Get();
@@ -33,3 +40,35 @@ void Statistics::Update()
         stats.Battery = status.BatteryLifePercent;
     }
 }
+#elif defined(__linux__)
+void Statistics::Update()
+{
+    Statistics& stats = Get();
+    UInt64 pageSize = sysconf(_SC_PAGESIZE);
+
+    // Ram: statm holds the process size then its resident size, in pages.
+    {
+        UInt64 size = 0;
+        UInt64 resident = 0;
+        std::ifstream statm("/proc/self/statm");
+        statm >> size >> resident;
+
+        stats.UsedRAM = resident * pageSize;
+        stats.MaxRAM = sysconf(_SC_PHYS_PAGES) * pageSize;
+    }
+
+    // Battery, desktops have none.
+    {
+        int capacity = 100;
+        std::ifstream battery("/sys/class/power_supply/BAT0/capacity");
+        if (battery.is_open())
+            battery >> capacity;
+
+        stats.Battery = capacity;
+    }
+}
+#else
+void Statistics::Update()
+{
+}
+#endif
@@ -0,0 +1,65 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-24 10:21:37
+//
+
+#include "PhysicsJobSystem.hpp"
+
+#include <Core/JobSystem.hpp>
+
+#include <thread>
+
+PhysicsJobSystem::PhysicsJobSystem(UInt32 maxJobs, UInt32 maxBarriers, UInt32 maxConcurrency)
+    : JPH::JobSystemWithBarrier(maxBarriers), mMaxConcurrency(maxConcurrency)
+{
+    mJobs.Init(maxJobs, maxJobs);
+}
+
+int PhysicsJobSystem::GetMaxConcurrency() const
+{
+    UInt32 concurrency = ::JobSystem::GetWorkerCount() + 1;
+    if (mMaxConcurrency > 0 && mMaxConcurrency < concurrency)
+        concurrency = mMaxConcurrency;
+    return (int)concurrency;
+}
+
+PhysicsJobSystem::JobHandle PhysicsJobSystem::CreateJob(const char* name, JPH::ColorArg color, const JobFunction& function, JPH::uint32 numDependencies)
+{
+    JPH::uint32 index;
+    for (;;) {
+        index = mJobs.ConstructObject(name, color, this, function, numDependencies);
+        if (index != AvailableJobs::cInvalidObjectIndex)
+            break;
+        // Out of jobs, give the workers some time to retire a few.
+        JPH_ASSERT(false, "No physics jobs available!");
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    Job* job = &mJobs.Get(index);
+
+    JobHandle handle(job);
+    if (numDependencies == 0)
+        QueueJob(job);
+    return handle;
+}
+
+void PhysicsJobSystem::QueueJob(Job* job)
+{
+    // The reference keeps the job alive until a worker is done with it.
+    job->AddRef();
+    ::JobSystem::Execute([job](UInt32) {
+        job->Execute();
+        job->Release();
+    });
+}
+
+void PhysicsJobSystem::QueueJobs(Job** jobs, JPH::uint numJobs)
+{
+    for (JPH::uint i = 0; i < numJobs; i++) {
+        QueueJob(jobs[i]);
+    }
+}
+
+void PhysicsJobSystem::FreeJob(Job* job)
+{
+    mJobs.DestructObject(job);
+}
@@ -0,0 +1,43 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-24 10:14:52
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+
+/// @brief Runs Jolt's jobs on the engine job system instead of a second thread pool.
+///
+/// Jolt splits the broadphase update, narrowphase and island solving into jobs with dependencies.
+/// Jobs whose dependencies are met are pushed to the engine workers, and the thread waiting on a
+/// barrier (the main thread) helps executing them, hence a concurrency of workers + 1.
+class PhysicsJobSystem : public JPH::JobSystemWithBarrier
+{
+public:
+    /// @brief Creates the adapter.
+    /// @param maxJobs The maximum number of jobs alive at once.
+    /// @param maxBarriers The maximum number of barriers alive at once.
+    /// @param maxConcurrency Caps the concurrency Jolt plans for. 0 uses every worker.
+    PhysicsJobSystem(UInt32 maxJobs, UInt32 maxBarriers, UInt32 maxConcurrency = 0);
+    virtual ~PhysicsJobSystem() override = default;
+
+    /// @brief Returns how many threads can execute jobs at once.
+    virtual int GetMaxConcurrency() const override;
+
+    /// @brief Creates a job, and queues it right away if it has no dependency.
+    virtual JobHandle CreateJob(const char* name, JPH::ColorArg color, const JobFunction& function, JPH::uint32 numDependencies = 0) override;
+protected:
+    virtual void QueueJob(Job* job) override;
+    virtual void QueueJobs(Job** jobs, JPH::uint numJobs) override;
+    virtual void FreeJob(Job* job) override;
+private:
+    using AvailableJobs = JPH::FixedSizeFreeList<Job>;
+
+    AvailableJobs mJobs;
+    UInt32 mMaxConcurrency;
+};
@@ -0,0 +1,58 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-24 10:02:11
+//
+
+#pragma once
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/ObjectLayer.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseLayer.h>
+
+/// @brief The object layers bodies are sorted in. Static bodies never collide with each other.
+namespace PhysicsLayers
+{
+    /// @brief Static geometry.
+    constexpr JPH::ObjectLayer Static = 0;
+    /// @brief Dynamic and kinematic bodies.
+    constexpr JPH::ObjectLayer Moving = 1;
+    /// @brief The number of object layers.
+    constexpr JPH::ObjectLayer Count = 2;
+}
+
+/// @brief Maps every object layer to its own broadphase tree, so the static tree is only rebuilt when static geometry changes.
+class PhysicsBroadPhaseLayers : public JPH::BroadPhaseLayerInterface
+{
+public:
+    virtual JPH::uint GetNumBroadPhaseLayers() const override { return PhysicsLayers::Count; }
+    virtual JPH::BroadPhaseLayer GetBroadPhaseLayer(JPH::ObjectLayer layer) const override { return JPH::BroadPhaseLayer((JPH::BroadPhaseLayer::Type)layer); }
+
+#if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
+    virtual const char* GetBroadPhaseLayerName(JPH::BroadPhaseLayer layer) const override
+    {
+        return (JPH::BroadPhaseLayer::Type)layer == PhysicsLayers::Static ? "Static" : "Moving";
+    }
+#endif
+};
+
+/// @brief Decides whether an object layer should be tested against a broadphase tree.
+class PhysicsObjectVsBroadPhaseFilter : public JPH::ObjectVsBroadPhaseLayerFilter
+{
+public:
+    virtual bool ShouldCollide(JPH::ObjectLayer layer, JPH::BroadPhaseLayer broadPhaseLayer) const override
+    {
+        if (layer == PhysicsLayers::Static)
+            return (JPH::BroadPhaseLayer::Type)broadPhaseLayer == PhysicsLayers::Moving;
+        return true;
+    }
+};
+
+/// @brief Decides whether two object layers should collide.
+class PhysicsObjectLayerFilter : public JPH::ObjectLayerPairFilter
+{
+public:
+    virtual bool ShouldCollide(JPH::ObjectLayer a, JPH::ObjectLayer b) const override
+    {
+        return a == PhysicsLayers::Moving || b == PhysicsLayers::Moving;
+    }
+};
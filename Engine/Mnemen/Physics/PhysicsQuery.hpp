@@ -0,0 +1,59 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-26 09:48:15
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+/// @brief The kind of scene query.
+enum class PhysicsQueryType
+{
+    Ray,           ///< Closest hit along a ray.
+    SphereCast,    ///< Closest hit of a sphere swept along a direction.
+    BoxCast,       ///< Closest hit of a box swept along a direction.
+    SphereOverlap, ///< Bodies overlapping a sphere.
+    BoxOverlap     ///< Bodies overlapping a box.
+};
+
+/// @brief A single scene query of a batch.
+struct PhysicsQuery
+{
+    /// @brief The kind of query.
+    PhysicsQueryType Type = PhysicsQueryType::Ray;
+    /// @brief Start of the ray or cast, center of the overlap.
+    glm::vec3 Origin = glm::vec3(0.0f);
+    /// @brief Direction of the ray or cast. Doesn't need to be normalized.
+    glm::vec3 Direction = glm::vec3(0.0f, 0.0f, 1.0f);
+    /// @brief How far the ray or cast goes.
+    float MaxDistance = 100.0f;
+    /// @brief Radius of the sphere.
+    float Radius = 0.5f;
+    /// @brief Half extents of the box.
+    glm::vec3 HalfExtents = glm::vec3(0.5f);
+    /// @brief Rotation of the box.
+    glm::quat Rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    /// @brief An entity whose body is ignored, usually the one asking. -1 for none.
+    int IgnoreEntity = -1;
+};
+
+/// @brief The result of a scene query.
+struct PhysicsHit
+{
+    /// @brief Whether anything was hit.
+    bool Hit = false;
+    /// @brief The entity that was hit (the first one for overlaps), -1 if none.
+    int Entity = -1;
+    /// @brief Distance from the origin to the hit along the direction. 0 for overlaps.
+    float Distance = 0.0f;
+    /// @brief The hit point in world space.
+    glm::vec3 Point = glm::vec3(0.0f);
+    /// @brief The surface normal at the hit point.
+    glm::vec3 Normal = glm::vec3(0.0f);
+    /// @brief The number of bodies overlapping, for overlap queries.
+    UInt32 OverlapCount = 0;
+};
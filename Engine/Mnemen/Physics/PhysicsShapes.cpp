@@ -0,0 +1,144 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-25 14:52:43
+//
+
+#include "PhysicsShapes.hpp"
+
+#include <Core/Logger.hpp>
+
+#include <Jolt/Core/StreamIn.h>
+#include <Jolt/Core/StreamOut.h>
+#include <Jolt/Geometry/IndexedTriangle.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+#include <Jolt/Physics/Collision/Shape/ConvexHullShape.h>
+#include <Jolt/Physics/Collision/Shape/StaticCompoundShape.h>
+
+/// @brief Writes a Jolt stream straight into a byte vector.
+class ByteStreamOut : public JPH::StreamOut
+{
+public:
+    ByteStreamOut(Vector<UInt8>& bytes)
+        : mBytes(bytes) {}
+
+    virtual void WriteBytes(const void* data, size_t size) override
+    {
+        const UInt8* bytes = reinterpret_cast<const UInt8*>(data);
+        mBytes.insert(mBytes.end(), bytes, bytes + size);
+    }
+
+    virtual bool IsFailed() const override { return false; }
+private:
+    Vector<UInt8>& mBytes;
+};
+
+/// @brief Reads a Jolt stream from memory, without copying it.
+class ByteStreamIn : public JPH::StreamIn
+{
+public:
+    ByteStreamIn(const UInt8* data, UInt64 size)
+        : mData(data), mSize(size) {}
+
+    virtual void ReadBytes(void* data, size_t size) override
+    {
+        if (mOffset + size > mSize) {
+            mFailed = true;
+            memset(data, 0, size);
+            return;
+        }
+        memcpy(data, mData + mOffset, size);
+        mOffset += size;
+    }
+
+    virtual bool IsEOF() const override { return mOffset >= mSize; }
+    virtual bool IsFailed() const override { return mFailed; }
+private:
+    const UInt8* mData;
+    UInt64 mSize;
+    UInt64 mOffset = 0;
+    bool mFailed = false;
+};
+
+JPH::ShapeRefC PhysicsShapes::Cook(const PointCloud& cloud, BakedShapeType type)
+{
+    switch (type) {
+        case BakedShapeType::TriangleMesh: {
+            JPH::VertexList vertices;
+            vertices.reserve(cloud.Points.size() / 3);
+            for (UInt64 i = 0; i + 2 < cloud.Points.size(); i += 3) {
+                vertices.push_back(JPH::Float3(cloud.Points[i], cloud.Points[i + 1], cloud.Points[i + 2]));
+            }
+
+            JPH::IndexedTriangleList triangles;
+            triangles.reserve(cloud.Indices.size() / 3);
+            for (UInt64 i = 0; i + 2 < cloud.Indices.size(); i += 3) {
+                triangles.push_back(JPH::IndexedTriangle(cloud.Indices[i], cloud.Indices[i + 1], cloud.Indices[i + 2], 0));
+            }
+
+            JPH::MeshShapeSettings settings(vertices, triangles);
+            JPH::Shape::ShapeResult result = settings.Create();
+            if (result.HasError()) {
+                LOG_ERROR("Failed to cook mesh collider: {0}", result.GetError().c_str());
+                return nullptr;
+            }
+            return result.Get();
+        }
+        case BakedShapeType::ConvexHulls: {
+            // The authored sub-meshes are used as the decomposition: level geometry is usually split in convex-ish parts already.
+            JPH::StaticCompoundShapeSettings compound;
+            JPH::ShapeRefC lastHull;
+            UInt32 hullCount = 0;
+            for (const PointCloud::Submesh& submesh : cloud.Submeshes) {
+                JPH::Array<JPH::Vec3> points;
+                points.reserve(submesh.VertexCount);
+                for (UInt32 i = submesh.FirstVertex; i < submesh.FirstVertex + submesh.VertexCount; i++) {
+                    points.push_back(JPH::Vec3(cloud.Points[i * 3], cloud.Points[i * 3 + 1], cloud.Points[i * 3 + 2]));
+                }
+
+                JPH::ConvexHullShapeSettings hull(points);
+                JPH::Shape::ShapeResult result = hull.Create();
+                if (result.HasError()) {
+                    LOG_WARN("Skipping degenerate convex hull: {0}", result.GetError().c_str());
+                    continue;
+                }
+                lastHull = result.Get();
+                compound.AddShape(JPH::Vec3::sZero(), JPH::Quat::sIdentity(), lastHull);
+                hullCount++;
+            }
+
+            if (hullCount == 0)
+                return nullptr;
+            if (hullCount == 1)
+                return lastHull;
+
+            JPH::Shape::ShapeResult result = compound.Create();
+            if (result.HasError()) {
+                LOG_ERROR("Failed to cook convex hull collider: {0}", result.GetError().c_str());
+                return nullptr;
+            }
+            return result.Get();
+        }
+    }
+    return nullptr;
+}
+
+void PhysicsShapes::Serialize(const JPH::Shape* shape, Vector<UInt8>& bytes)
+{
+    ByteStreamOut stream(bytes);
+    JPH::Shape::ShapeToIDMap shapeMap;
+    JPH::Shape::MaterialToIDMap materialMap;
+    shape->SaveWithChildren(stream, shapeMap, materialMap);
+}
+
+JPH::ShapeRefC PhysicsShapes::Deserialize(const UInt8* data, UInt64 size)
+{
+    ByteStreamIn stream(data, size);
+    JPH::Shape::IDToShapeMap shapeMap;
+    JPH::Shape::IDToMaterialMap materialMap;
+    JPH::Shape::ShapeResult result = JPH::Shape::sRestoreWithChildren(stream, shapeMap, materialMap);
+    if (result.HasError() || stream.IsFailed()) {
+        LOG_ERROR("Failed to restore baked collider: {0}", result.HasError() ? result.GetError().c_str() : "truncated data");
+        return nullptr;
+    }
+    return result.Get();
+}
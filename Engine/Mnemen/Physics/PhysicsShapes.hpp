@@ -0,0 +1,44 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-25 14:37:06
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+#include <Utility/PointCloud.hpp>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+
+/// @brief The collision representations that can be baked from a mesh.
+enum class BakedShapeType
+{
+    TriangleMesh, ///< The exact triangles of the mesh. Static and kinematic bodies only.
+    ConvexHulls   ///< One convex hull per sub-mesh, compounded. Usable by dynamic bodies.
+};
+
+/// @brief Cooks Jolt shapes from mesh geometry and converts them to and from their binary form.
+///
+/// Cooking (building the mesh BVH, computing hulls) is the expensive part, which is why the
+/// results are baked in the asset cache by `AssetCacher::ReadCollider` and only restored at load time.
+class PhysicsShapes
+{
+public:
+    /// @brief Builds a shape from the given geometry.
+    /// @param cloud The geometry, as loaded from the mesh file.
+    /// @param type The kind of shape to build.
+    /// @return The shape, or null if the geometry can't make one.
+    static JPH::ShapeRefC Cook(const PointCloud& cloud, BakedShapeType type);
+
+    /// @brief Serializes a shape and its children.
+    /// @param shape The shape to serialize.
+    /// @param bytes Receives the binary form of the shape.
+    static void Serialize(const JPH::Shape* shape, Vector<UInt8>& bytes);
+
+    /// @brief Restores a shape serialized with `Serialize`.
+    /// @param data The binary form of the shape.
+    /// @param size The size of the data in bytes.
+    /// @return The shape, or null if the data is invalid.
+    static JPH::ShapeRefC Deserialize(const UInt8* data, UInt64 size);
+};
@@ -6,18 +6,478 @@
 #include "PhysicsSystem.hpp"
 
 #include <Core/Logger.hpp>
+#include <Core/Profiler.hpp>
+#include <Core/Metrics.hpp>
+#include <Core/Timer.hpp>
+#include <Core/JobSystem.hpp>
+
+#include <Asset/AssetCacher.hpp>
+#include <Core/Application.hpp>
+
+#include <Jolt/RegisterTypes.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/Physics/PhysicsSettings.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Collision/Shape/CapsuleShape.h>
+#include <Jolt/Physics/Collision/Shape/ScaledShape.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Body/BodyLock.h>
+#include <Jolt/Physics/Body/BodyFilter.h>
+
+#include <algorithm>
+
+PhysicsSystem::Data PhysicsSystem::sData;
 
 void PhysicsSystem::Init()
 {
-    LOG_INFO("Initialized Physics System");
+    JPH::RegisterDefaultAllocator();
+    JPH::Factory::sInstance = new JPH::Factory();
+    JPH::RegisterTypes();
+
+    sData.TempAllocator = MakeUnique<JPH::TempAllocatorImpl>(TempAllocatorSize);
+    sData.Jobs = MakeUnique<PhysicsJobSystem>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
+    sData.System = MakeUnique<JPH::PhysicsSystem>();
+    sData.System->Init(MaxBodies, 0, MaxBodyPairs, MaxContactConstraints, sData.BroadPhaseLayers, sData.ObjectVsBroadPhaseFilter, sData.ObjectLayerFilter);
+
+    LOG_INFO("Initialized Physics System ({0} threads)", sData.Jobs->GetMaxConcurrency());
 }
 
 void PhysicsSystem::Exit()
 {
+    sData.BakedShapes.clear();
+    sData.System.reset();
+    sData.Jobs.reset();
+    sData.TempAllocator.reset();
+
+    JPH::UnregisterTypes();
+    delete JPH::Factory::sInstance;
+    JPH::Factory::sInstance = nullptr;
+}
+
+void PhysicsSystem::Awake(Ref<Scene> scene)
+{
+    entt::registry* reg = scene->GetRegistry();
+    reg->on_destroy<RigidBodyComponent>().connect<&PhysicsSystem::OnRigidBodyDestroyed>();
+
+    CreateBodies(reg);
+    sData.System->OptimizeBroadPhase();
+}
+
+void PhysicsSystem::Quit(Ref<Scene> scene)
+{
+    entt::registry* reg = scene->GetRegistry();
+    reg->on_destroy<RigidBodyComponent>().disconnect<&PhysicsSystem::OnRigidBodyDestroyed>();
 
+    sData.MovedEntities.clear();
+
+    JPH::BodyIDVector bodies;
+    auto view = reg->view<RigidBodyComponent>();
+    for (auto [entity, rigidBody] : view.each()) {
+        if (rigidBody.BodyID != JPH::BodyID::cInvalidBodyID) {
+            bodies.push_back(JPH::BodyID(rigidBody.BodyID));
+            rigidBody.BodyID = JPH::BodyID::cInvalidBodyID;
+        }
+    }
+    if (bodies.empty())
+        return;
+
+    JPH::BodyInterface& bodyInterface = sData.System->GetBodyInterfaceNoLock();
+    bodyInterface.RemoveBodies(bodies.data(), (int)bodies.size());
+    bodyInterface.DestroyBodies(bodies.data(), (int)bodies.size());
 }
 
 void PhysicsSystem::Update(Ref<Scene> scene, float minStepDuration)
 {
-    
+    PROFILE_FUNCTION();
+
+    entt::registry* reg = scene->GetRegistry();
+    JPH::BodyInterface& bodyInterface = sData.System->GetBodyInterfaceNoLock();
+
+    // Bodies for entities created while playing
+    CreateBodies(reg);
+
+    // Kinematic bodies follow their transform
+    {
+        auto view = reg->view<TransformComponent, RigidBodyComponent>();
+        for (auto [entity, transform, rigidBody] : view.each()) {
+            if (rigidBody.Type != RigidBodyType::Kinematic || rigidBody.BodyID == JPH::BodyID::cInvalidBodyID)
+                continue;
+
+            bodyInterface.MoveKinematic(JPH::BodyID(rigidBody.BodyID),
+                                        JPH::RVec3(transform.Position.x, transform.Position.y, transform.Position.z),
+                                        JPH::Quat(transform.Rotation.x, transform.Rotation.y, transform.Rotation.z, transform.Rotation.w),
+                                        minStepDuration);
+        }
+    }
+
+    // Step
+    {
+        PROFILE_SCOPE("Jolt Step");
+        JPH::EPhysicsUpdateError error = sData.System->Update(minStepDuration, 1, sData.TempAllocator.get(), sData.Jobs.get());
+        if (error != JPH::EPhysicsUpdateError::None) {
+            LOG_WARN("Physics step overflowed its buffers (error {0}), raise the body pair or contact limits", (UInt32)error);
+        }
+    }
+
+    // Write back the bodies that moved. Sleeping bodies didn't, so they're skipped entirely.
+    // Scene::Update interpolates the transforms between the previous and current states.
+    {
+        PROFILE_SCOPE("Physics Write Back");
+
+        // Whatever moved last step now starts from where it ended. Bodies that fell asleep leave the set,
+        // so their transform is snapped to their final state here, they won't be interpolated again.
+        for (entt::entity entity : sData.MovedEntities) {
+            RigidBodyComponent* rigidBody = reg->try_get<RigidBodyComponent>(entity);
+            if (!rigidBody)
+                continue;
+            rigidBody->PreviousPosition = rigidBody->CurrentPosition;
+            rigidBody->PreviousRotation = rigidBody->CurrentRotation;
+            if (TransformComponent* transform = reg->try_get<TransformComponent>(entity)) {
+                transform->Position = rigidBody->CurrentPosition;
+                transform->Rotation = rigidBody->CurrentRotation;
+            }
+        }
+        sData.MovedEntities.clear();
+
+        sData.ActiveBodies.clear();
+        sData.System->GetActiveBodies(JPH::EBodyType::RigidBody, sData.ActiveBodies);
+        GAUGE_SET("Physics Bodies Awake", sData.ActiveBodies.size());
+
+        const JPH::BodyLockInterfaceNoLock& locks = sData.System->GetBodyLockInterfaceNoLock();
+        for (JPH::BodyID id : sData.ActiveBodies) {
+            const JPH::Body* body = locks.TryGetBody(id);
+            if (!body || !body->IsDynamic())
+                continue;
+
+            entt::entity entity = (entt::entity)body->GetUserData();
+            RigidBodyComponent* rigidBody = reg->try_get<RigidBodyComponent>(entity);
+            if (!rigidBody)
+                continue;
+
+            JPH::RVec3 position = body->GetPosition();
+            JPH::Quat rotation = body->GetRotation();
+            rigidBody->CurrentPosition = glm::vec3(position.GetX(), position.GetY(), position.GetZ());
+            rigidBody->CurrentRotation = glm::quat(rotation.GetW(), rotation.GetX(), rotation.GetY(), rotation.GetZ());
+            sData.MovedEntities.push_back(entity);
+        }
+    }
+}
+
+void PhysicsSystem::Interpolate(Ref<Scene> scene, float alpha)
+{
+    PROFILE_FUNCTION();
+
+    entt::registry* reg = scene->GetRegistry();
+    for (entt::entity entity : sData.MovedEntities) {
+        RigidBodyComponent* rigidBody = reg->try_get<RigidBodyComponent>(entity);
+        TransformComponent* transform = reg->try_get<TransformComponent>(entity);
+        if (!rigidBody || !transform || rigidBody->BodyID == JPH::BodyID::cInvalidBodyID)
+            continue;
+        if (rigidBody->PreviousPosition == rigidBody->CurrentPosition && rigidBody->PreviousRotation == rigidBody->CurrentRotation)
+            continue;
+
+        transform->Position = glm::mix(rigidBody->PreviousPosition, rigidBody->CurrentPosition, alpha);
+        transform->Rotation = glm::slerp(rigidBody->PreviousRotation, rigidBody->CurrentRotation, alpha);
+    }
+}
+
+void PhysicsSystem::CreateBodies(entt::registry* registry)
+{
+    JPH::BodyInterface& bodyInterface = sData.System->GetBodyInterfaceNoLock();
+    sData.NewBodies.clear();
+
+    auto view = registry->view<TransformComponent, RigidBodyComponent, ColliderComponent>();
+    for (auto [entity, transform, rigidBody, collider] : view.each()) {
+        if (rigidBody.BodyID != JPH::BodyID::cInvalidBodyID)
+            continue;
+
+        JPH::ShapeRefC shape = CreateShape(collider, transform.Scale);
+        if (!shape)
+            continue;
+
+        JPH::EMotionType motionType = JPH::EMotionType::Dynamic;
+        if (rigidBody.Type == RigidBodyType::Static)
+            motionType = JPH::EMotionType::Static;
+        else if (rigidBody.Type == RigidBodyType::Kinematic)
+            motionType = JPH::EMotionType::Kinematic;
+        if (collider.Shape == ColliderShape::Mesh && motionType == JPH::EMotionType::Dynamic) {
+            LOG_WARN("Mesh colliders can't be dynamic ({0}), making the body static. Use a convex hull collider instead.", collider.MeshPath);
+            motionType = JPH::EMotionType::Static;
+        }
+
+        JPH::BodyCreationSettings settings(shape,
+                                           JPH::RVec3(transform.Position.x, transform.Position.y, transform.Position.z),
+                                           JPH::Quat(transform.Rotation.x, transform.Rotation.y, transform.Rotation.z, transform.Rotation.w),
+                                           motionType,
+                                           motionType == JPH::EMotionType::Static ? PhysicsLayers::Static : PhysicsLayers::Moving);
+        settings.mFriction = rigidBody.Friction;
+        settings.mRestitution = rigidBody.Restitution;
+        settings.mLinearDamping = rigidBody.LinearDamping;
+        settings.mAngularDamping = rigidBody.AngularDamping;
+        settings.mGravityFactor = rigidBody.GravityFactor;
+        settings.mOverrideMassProperties = JPH::EOverrideMassProperties::CalculateInertia;
+        settings.mMassPropertiesOverride.mMass = rigidBody.Mass;
+        settings.mUserData = (JPH::uint64)entity;
+
+        JPH::Body* body = bodyInterface.CreateBody(settings);
+        if (!body) {
+            LOG_ERROR("Out of physics bodies ({0} max)", MaxBodies);
+            break;
+        }
+        rigidBody.BodyID = body->GetID().GetIndexAndSequenceNumber();
+        rigidBody.PreviousPosition = rigidBody.CurrentPosition = transform.Position;
+        rigidBody.PreviousRotation = rigidBody.CurrentRotation = transform.Rotation;
+        sData.NewBodies.push_back(body->GetID());
+    }
+
+    if (sData.NewBodies.empty())
+        return;
+
+    // Adding every new body at once only touches the broadphase once.
+    JPH::BodyInterface::AddState state = bodyInterface.AddBodiesPrepare(sData.NewBodies.data(), (int)sData.NewBodies.size());
+    bodyInterface.AddBodiesFinalize(sData.NewBodies.data(), (int)sData.NewBodies.size(), state, JPH::EActivation::Activate);
+}
+
+JPH::ShapeRefC PhysicsSystem::CreateShape(const ColliderComponent& collider, const glm::vec3& scale)
+{
+    float maxScale = glm::max(glm::abs(scale.x), glm::max(glm::abs(scale.y), glm::abs(scale.z)));
+
+    switch (collider.Shape) {
+        case ColliderShape::Box: {
+            glm::vec3 halfExtents = glm::max(collider.HalfExtents * glm::abs(scale), glm::vec3(0.001f));
+            float convexRadius = glm::min(JPH::cDefaultConvexRadius, glm::min(halfExtents.x, glm::min(halfExtents.y, halfExtents.z)));
+            return new JPH::BoxShape(JPH::Vec3(halfExtents.x, halfExtents.y, halfExtents.z), convexRadius);
+        }
+        case ColliderShape::Sphere: {
+            return new JPH::SphereShape(glm::max(collider.Radius * maxScale, 0.001f));
+        }
+        case ColliderShape::Capsule: {
+            return new JPH::CapsuleShape(glm::max(collider.HalfHeight * glm::abs(scale.y), 0.001f), glm::max(collider.Radius * maxScale, 0.001f));
+        }
+        case ColliderShape::Mesh:
+        case ColliderShape::ConvexHull: {
+            if (collider.MeshPath.empty())
+                return nullptr;
+
+            JPH::ShapeRefC shape = GetBakedShape(collider.MeshPath, collider.Shape == ColliderShape::Mesh ? BakedShapeType::TriangleMesh : BakedShapeType::ConvexHulls);
+            if (!shape || scale == glm::vec3(1.0f))
+                return shape;
+            return new JPH::ScaledShape(shape, JPH::Vec3(scale.x, scale.y, scale.z));
+        }
+    }
+    return nullptr;
+}
+
+JPH::ShapeRefC PhysicsSystem::GetBakedShape(const String& meshPath, BakedShapeType type)
+{
+    String key = meshPath + (type == BakedShapeType::TriangleMesh ? "#mesh" : "#hulls");
+    auto it = sData.BakedShapes.find(key);
+    if (it != sData.BakedShapes.end())
+        return it->second;
+
+    JPH::ShapeRefC shape = nullptr;
+    Vector<UInt8> bytes;
+    if (AssetCacher::ReadCollider(meshPath, type, bytes))
+        shape = PhysicsShapes::Deserialize(bytes.data(), bytes.size());
+
+    // Failures are remembered too, so a broken mesh isn't cooked again for every body.
+    sData.BakedShapes[key] = shape;
+    return shape;
+}
+
+void PhysicsSystem::OnRigidBodyDestroyed(entt::registry& registry, entt::entity entity)
+{
+    RigidBodyComponent& rigidBody = registry.get<RigidBodyComponent>(entity);
+    if (rigidBody.BodyID == JPH::BodyID::cInvalidBodyID)
+        return;
+
+    JPH::BodyInterface& bodyInterface = sData.System->GetBodyInterfaceNoLock();
+    bodyInterface.RemoveBody(JPH::BodyID(rigidBody.BodyID));
+    bodyInterface.DestroyBody(JPH::BodyID(rigidBody.BodyID));
+    rigidBody.BodyID = JPH::BodyID::cInvalidBodyID;
+}
+
+UInt32 PhysicsSystem::QueryBatch(const PhysicsQuery* queries, PhysicsHit* hits, UInt32 count)
+{
+    PROFILE_FUNCTION();
+
+    if (count <= QueriesPerJob || JobSystem::GetCurrentWorker() >= 0) {
+        for (UInt32 i = 0; i < count; i++) {
+            RunQuery(queries[i], hits[i]);
+        }
+    } else {
+        UInt32 jobCount = (count + QueriesPerJob - 1) / QueriesPerJob;
+        JobSystem::Counter counter;
+        JobSystem::Dispatch(jobCount, [&](UInt32 jobIndex, UInt32) {
+            UInt32 begin = jobIndex * QueriesPerJob;
+            UInt32 end = glm::min(begin + QueriesPerJob, count);
+            for (UInt32 i = begin; i < end; i++) {
+                RunQuery(queries[i], hits[i]);
+            }
+        }, &counter);
+        JobSystem::Wait(&counter);
+    }
+
+    UInt32 hitCount = 0;
+    for (UInt32 i = 0; i < count; i++) {
+        hitCount += hits[i].Hit ? 1 : 0;
+    }
+    return hitCount;
+}
+
+void PhysicsSystem::RunQuery(const PhysicsQuery& query, PhysicsHit& hit)
+{
+    hit = PhysicsHit();
+
+    const JPH::NarrowPhaseQuery& narrowPhase = sData.System->GetNarrowPhaseQuery();
+    const JPH::BodyLockInterfaceLocking& locks = sData.System->GetBodyLockInterface();
+    JPH::BodyInterface& bodyInterface = sData.System->GetBodyInterface();
+
+    JPH::RVec3 origin(query.Origin.x, query.Origin.y, query.Origin.z);
+    JPH::Vec3 direction = JPH::Vec3::sZero();
+    if (glm::length(query.Direction) > 0.0f) {
+        glm::vec3 d = glm::normalize(query.Direction) * query.MaxDistance;
+        direction = JPH::Vec3(d.x, d.y, d.z);
+    }
+    JPH::Quat rotation(query.Rotation.x, query.Rotation.y, query.Rotation.z, query.Rotation.w);
+
+    JPH::BodyID ignoredBody;
+    if (query.IgnoreEntity != -1) {
+        entt::registry* reg = Application::Get()->GetScene()->GetRegistry();
+        RigidBodyComponent* rigidBody = reg->try_get<RigidBodyComponent>((entt::entity)query.IgnoreEntity);
+        if (rigidBody)
+            ignoredBody = JPH::BodyID(rigidBody->BodyID);
+    }
+    JPH::IgnoreSingleBodyFilter bodyFilter(ignoredBody);
+
+    // Query shapes live on the stack, they're never shared.
+    JPH::SphereShape sphere(glm::max(query.Radius, 0.001f));
+    sphere.SetEmbedded();
+    glm::vec3 halfExtents = glm::max(query.HalfExtents, glm::vec3(0.001f));
+    JPH::BoxShape box(JPH::Vec3(halfExtents.x, halfExtents.y, halfExtents.z), glm::min(JPH::cDefaultConvexRadius, glm::min(halfExtents.x, glm::min(halfExtents.y, halfExtents.z))));
+    box.SetEmbedded();
+    const JPH::Shape* shape = (query.Type == PhysicsQueryType::SphereCast || query.Type == PhysicsQueryType::SphereOverlap) ? (const JPH::Shape*)&sphere : (const JPH::Shape*)&box;
+
+    switch (query.Type) {
+        case PhysicsQueryType::Ray: {
+            JPH::RRayCast ray(origin, direction);
+            JPH::RayCastResult result;
+            if (!narrowPhase.CastRay(ray, result, {}, {}, bodyFilter))
+                return;
+
+            JPH::RVec3 point = ray.GetPointOnRay(result.mFraction);
+            hit.Hit = true;
+            hit.Distance = result.mFraction * query.MaxDistance;
+            hit.Point = glm::vec3(point.GetX(), point.GetY(), point.GetZ());
+
+            JPH::BodyLockRead lock(locks, result.mBodyID);
+            if (lock.Succeeded()) {
+                const JPH::Body& body = lock.GetBody();
+                JPH::Vec3 normal = body.GetWorldSpaceSurfaceNormal(result.mSubShapeID2, point);
+                hit.Normal = glm::vec3(normal.GetX(), normal.GetY(), normal.GetZ());
+                hit.Entity = (int)body.GetUserData();
+            }
+            break;
+        }
+        case PhysicsQueryType::SphereCast:
+        case PhysicsQueryType::BoxCast: {
+            JPH::RShapeCast cast(shape, JPH::Vec3::sReplicate(1.0f), JPH::RMat44::sRotationTranslation(rotation, origin), direction);
+            JPH::ShapeCastSettings settings;
+            JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+            narrowPhase.CastShape(cast, settings, JPH::RVec3::sZero(), collector, {}, {}, bodyFilter);
+            if (!collector.HadHit())
+                return;
+
+            const JPH::ShapeCastResult& result = collector.mHit;
+            JPH::Vec3 normal = -result.mPenetrationAxis.NormalizedOr(JPH::Vec3::sZero());
+            hit.Hit = true;
+            hit.Distance = result.mFraction * query.MaxDistance;
+            hit.Point = glm::vec3(result.mContactPointOn2.GetX(), result.mContactPointOn2.GetY(), result.mContactPointOn2.GetZ());
+            hit.Normal = glm::vec3(normal.GetX(), normal.GetY(), normal.GetZ());
+            hit.Entity = (int)bodyInterface.GetUserData(result.mBodyID2);
+            break;
+        }
+        case PhysicsQueryType::SphereOverlap:
+        case PhysicsQueryType::BoxOverlap: {
+            JPH::CollideShapeSettings settings;
+            JPH::AllHitCollisionCollector<JPH::CollideShapeCollector> collector;
+            narrowPhase.CollideShape(shape, JPH::Vec3::sReplicate(1.0f), JPH::RMat44::sRotationTranslation(rotation, origin), settings, JPH::RVec3::sZero(), collector, {}, {}, bodyFilter);
+            if (!collector.HadHit())
+                return;
+
+            // A body can report several contacts, count each one once.
+            JPH::Array<JPH::BodyID> bodies;
+            for (const JPH::CollideShapeResult& result : collector.mHits) {
+                bodies.push_back(result.mBodyID2);
+            }
+            std::sort(bodies.begin(), bodies.end());
+            bodies.erase(std::unique(bodies.begin(), bodies.end()), bodies.end());
+
+            const JPH::CollideShapeResult& first = collector.mHits.front();
+            hit.Hit = true;
+            hit.OverlapCount = (UInt32)bodies.size();
+            hit.Point = glm::vec3(first.mContactPointOn2.GetX(), first.mContactPointOn2.GetY(), first.mContactPointOn2.GetZ());
+            hit.Entity = (int)bodyInterface.GetUserData(first.mBodyID2);
+            break;
+        }
+    }
+}
+
+void PhysicsSystem::RunBenchmark(UInt32 bodyCount, UInt32 stepCount)
+{
+    const float stepDuration = 1.0f / 60.0f;
+    const UInt32 maxThreads = JobSystem::GetWorkerCount() + 1;
+
+    LOG_INFO("[PHYSICS BENCHMARK] {0} boxes, {1} steps, up to {2} threads", bodyCount, stepCount, maxThreads);
+
+    JPH::ShapeRefC floorShape = new JPH::BoxShape(JPH::Vec3(500.0f, 1.0f, 500.0f));
+    JPH::ShapeRefC boxShape = new JPH::BoxShape(JPH::Vec3::sReplicate(0.5f));
+    UInt32 side = (UInt32)glm::ceil(glm::sqrt(bodyCount / 10.0f));
+
+    for (UInt32 threads = 1;; threads = glm::min(threads * 2, maxThreads)) {
+        JPH::TempAllocatorImpl tempAllocator(TempAllocatorSize);
+        PhysicsJobSystem jobs(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, threads);
+        JPH::PhysicsSystem system;
+        system.Init(bodyCount + 1, 0, MaxBodyPairs, MaxContactConstraints, sData.BroadPhaseLayers, sData.ObjectVsBroadPhaseFilter, sData.ObjectLayerFilter);
+
+        JPH::BodyInterface& bodyInterface = system.GetBodyInterfaceNoLock();
+        bodyInterface.CreateAndAddBody(JPH::BodyCreationSettings(floorShape, JPH::RVec3(0.0f, -1.0f, 0.0f), JPH::Quat::sIdentity(), JPH::EMotionType::Static, PhysicsLayers::Static), JPH::EActivation::DontActivate);
+
+        // Columns of ten boxes, slightly offset so the stacks topple
+        JPH::BodyIDVector boxes;
+        boxes.reserve(bodyCount);
+        for (UInt32 i = 0; i < bodyCount; i++) {
+            UInt32 column = i / 10;
+            JPH::RVec3 position((column % side) * 1.5f - side * 0.75f, 1.0f + (i % 10) * 1.1f, (column / side) * 1.5f - side * 0.75f + (i % 10) * 0.05f);
+
+            JPH::BodyCreationSettings settings(boxShape, position, JPH::Quat::sIdentity(), JPH::EMotionType::Dynamic, PhysicsLayers::Moving);
+            boxes.push_back(bodyInterface.CreateBody(settings)->GetID());
+        }
+        JPH::BodyInterface::AddState state = bodyInterface.AddBodiesPrepare(boxes.data(), (int)boxes.size());
+        bodyInterface.AddBodiesFinalize(boxes.data(), (int)boxes.size(), state, JPH::EActivation::Activate);
+        system.OptimizeBroadPhase();
+
+        float totalMs = 0.0f;
+        float maxMs = 0.0f;
+        for (UInt32 step = 0; step < stepCount; step++) {
+            Timer timer;
+            system.Update(stepDuration, 1, &tempAllocator, &jobs);
+            float elapsed = timer.GetElapsed();
+            totalMs += elapsed;
+            maxMs = glm::max(maxMs, elapsed);
+        }
+        LOG_INFO("[PHYSICS BENCHMARK] {0} threads: {1}ms average, {2}ms worst step ({3} bodies still awake)", threads, totalMs / stepCount, maxMs, system.GetNumActiveBodies(JPH::EBodyType::RigidBody));
+
+        bodyInterface.RemoveBodies(boxes.data(), (int)boxes.size());
+        bodyInterface.DestroyBodies(boxes.data(), (int)boxes.size());
+
+        if (threads == maxThreads)
+            break;
+    }
 }
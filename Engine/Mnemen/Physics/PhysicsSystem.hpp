@@ -7,32 +7,123 @@
 
 #include "World/Scene.hpp"
 
+#include "PhysicsLayers.hpp"
+#include "PhysicsJobSystem.hpp"
+#include "PhysicsShapes.hpp"
+#include "PhysicsQuery.hpp"
+
+#include <Jolt/Core/TempAllocator.h>
+#include <Jolt/Physics/PhysicsSystem.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+
 /// @brief A system for handling physics simulation in the application.
-/// 
-/// The `PhysicsSystem` class provides static methods for initializing, updating, and exiting 
+///
+/// The `PhysicsSystem` class provides static methods for initializing, updating, and exiting
 /// the physics system. It processes physics updates based on the current state of the scene.
+/// The simulation runs on Jolt, with its jobs spread over the engine job system.
 class PhysicsSystem
 {
 public:
     /// @brief Initializes the physics system.
-    /// 
+    ///
     /// This method sets up the necessary resources and configurations for the physics system.
     /// It must be called before any physics operations can take place.
     static void Init();
 
     /// @brief Exits the physics system and cleans up resources.
-    /// 
-    /// This method shuts down the physics system and releases any resources used during its 
+    ///
+    /// This method shuts down the physics system and releases any resources used during its
     /// operation. It should be called when the system is no longer needed.
     static void Exit();
 
+    /// @brief Creates the bodies of the scene when it starts playing.
+    ///
+    /// Every entity with a `RigidBodyComponent` and a `ColliderComponent` gets a body, after which
+    /// the broadphase is optimized once for the whole scene.
+    ///
+    /// @param scene The scene that starts playing.
+    static void Awake(Ref<Scene> scene);
+
+    /// @brief Destroys the bodies of the scene when it stops playing.
+    /// @param scene The scene that stops playing.
+    static void Quit(Ref<Scene> scene);
+
     /// @brief Updates the physics system based on the given scene and minimum step duration.
-    /// 
-    /// This method performs the physics simulation for the current frame, including collisions, 
-    /// movement, and other physics-related operations. It ensures that the system progresses in 
+    ///
+    /// This method performs the physics simulation for the current frame, including collisions,
+    /// movement, and other physics-related operations. It ensures that the system progresses in
     /// a consistent manner based on the scene's current state.
-    /// 
+    ///
+    /// Kinematic bodies are moved to their transform before the step, and only the bodies that are
+    /// still awake after it are written back into their `RigidBodyComponent`, as the current state
+    /// `Interpolate` moves their transform towards. Meant to be called with a fixed step duration.
+    ///
     /// @param scene The scene object that provides the current state of entities for physics processing.
     /// @param minStepDuration The minimum duration (in seconds) of a physics simulation step.
     static void Update(Ref<Scene> scene, float minStepDuration);
+
+    /// @brief Places the bodies that moved during the last step between their two last physics states.
+    ///
+    /// Only the bodies written back by the last `Update` are touched, sleeping bodies keep their transform.
+    ///
+    /// @param scene The scene being simulated.
+    /// @param alpha How far the frame is between the previous and the current physics step, in [0, 1].
+    static void Interpolate(Ref<Scene> scene, float alpha);
+
+    /// @brief Runs a batch of scene queries against the current world.
+    ///
+    /// Queries are split in chunks executed in parallel on the job system, each one writing its own
+    /// slot of `hits`, so the caller can keep both arrays around from frame to frame. Batches issued from
+    /// a job (parallel scripts) or too small to be worth splitting run on the calling thread.
+    ///
+    /// @param queries The queries to run.
+    /// @param hits Receives one result per query. Must hold at least `count` elements.
+    /// @param count The number of queries.
+    /// @return The number of queries that hit something.
+    static UInt32 QueryBatch(const PhysicsQuery* queries, PhysicsHit* hits, UInt32 count);
+
+    /// @brief Runs a headless stress test and logs the step time for each thread count.
+    ///
+    /// A pile of boxes is dropped on a static floor in a standalone Jolt world, once per thread count
+    /// (1, 2, 4... up to every worker).
+    ///
+    /// @param bodyCount The number of falling boxes.
+    /// @param stepCount The number of 60Hz steps simulated for each thread count.
+    static void RunBenchmark(UInt32 bodyCount = 10000, UInt32 stepCount = 300);
+private:
+    static constexpr UInt32 MaxBodies = 65536;
+    static constexpr UInt32 MaxBodyPairs = 65536;
+    static constexpr UInt32 MaxContactConstraints = 65536;
+    static constexpr UInt32 TempAllocatorSize = 32 * 1024 * 1024;
+    static constexpr UInt32 QueriesPerJob = 32;
+
+    /// @brief Runs a single query. Thread safe, it only goes through the locking query interfaces.
+    static void RunQuery(const PhysicsQuery& query, PhysicsHit& hit);
+
+    /// @brief Creates the bodies of the entities that don't have one yet, adding them to the world in a single batch.
+    static void CreateBodies(entt::registry* registry);
+
+    /// @brief Builds the Jolt shape of a collider, scaled by the entity's transform.
+    static JPH::ShapeRefC CreateShape(const ColliderComponent& collider, const glm::vec3& scale);
+
+    /// @brief Returns the baked shape of a mesh, restored from the asset cache once and shared by every body using it.
+    static JPH::ShapeRefC GetBakedShape(const String& meshPath, BakedShapeType type);
+
+    /// @brief Removes the body of a rigid body component destroyed while playing.
+    static void OnRigidBodyDestroyed(entt::registry& registry, entt::entity entity);
+
+    static struct Data {
+        Unique<JPH::TempAllocatorImpl> TempAllocator;
+        Unique<PhysicsJobSystem> Jobs;
+        Unique<JPH::PhysicsSystem> System;
+
+        PhysicsBroadPhaseLayers BroadPhaseLayers;
+        PhysicsObjectVsBroadPhaseFilter ObjectVsBroadPhaseFilter;
+        PhysicsObjectLayerFilter ObjectLayerFilter;
+
+        JPH::BodyIDVector ActiveBodies;
+        JPH::BodyIDVector NewBodies;
+        Vector<entt::entity> MovedEntities;
+        UnorderedMap<String, JPH::ShapeRefC> BakedShapes;
+    } sData;
 };
@@ -42,6 +42,10 @@ void GPUTimer::Init(RHI::Ref rhi)
 
     rhi->mGraphicsQueue->GetQueue()->GetTimestampFrequency(&sData.Frequency);
 
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    sData.CPUFrequency = frequency.QuadPart;
+
     sData.Timestamps.resize(sData.MaxTimers * 2, 0);
 }
 
@@ -75,6 +79,9 @@ void GPUTimer::Readback()
         std::copy(data, data + sData.MaxTimers * 2, sData.Timestamps.begin());
         sData.ReadbackBuffer->Unmap(0, nullptr);
     }
+
+    // The clocks drift apart, so recalibrate along every readback.
+    sData.RHI->mGraphicsQueue->GetQueue()->GetClockCalibration(&sData.CalibrationGPU, &sData.CalibrationCPU);
 }
 
 double GPUTimer::GetTime(UInt32 timerIndex)
@@ -83,3 +90,10 @@ double GPUTimer::GetTime(UInt32 timerIndex)
     UInt64 end = sData.Timestamps[timerIndex * 2 + 1];
     return (end - start) * 1000.0 / sData.Frequency; // Convert to milliseconds
 }
+
+void GPUTimer::GetRange(UInt32 timerIndex, UInt64& start, UInt64& end)
+{
+    double scale = (double)sData.CPUFrequency / sData.Frequency;
+    start = sData.CalibrationCPU + (Int64)(((Int64)sData.Timestamps[timerIndex * 2] - (Int64)sData.CalibrationGPU) * scale);
+    end = sData.CalibrationCPU + (Int64)(((Int64)sData.Timestamps[timerIndex * 2 + 1] - (Int64)sData.CalibrationGPU) * scale);
+}
@@ -42,6 +42,12 @@ public:
     /// @return Elapsed time in milliseconds.
     static double GetTime(UInt32 timerIndex);
 
+    /// @brief Retrieves when a timer started and stopped, on the CPU's performance counter.
+    /// @param timerIndex Index of the timer.
+    /// @param start Receives the start, in performance counter ticks.
+    /// @param end Receives the end, in performance counter ticks.
+    static void GetRange(UInt32 timerIndex, UInt64& start, UInt64& end);
+
 private:
     /// @struct Data
     /// @brief Internal data structure for managing GPU timer resources.
@@ -53,6 +59,9 @@ private:
         Vector<UInt64> Timestamps; ///< Vector storing timestamp values.
         UInt32 MaxTimers = 0; ///< Maximum number of timers supported.
         UInt64 Frequency = 0; ///< GPU timestamp frequency.
+        UInt64 CPUFrequency = 0; ///< CPU performance counter frequency.
+        UInt64 CalibrationGPU = 0; ///< GPU timestamp sampled along CalibrationCPU.
+        UInt64 CalibrationCPU = 0; ///< CPU performance counter sampled along CalibrationGPU.
     };
 
     static Data sData; ///< Static instance of the internal data structure.
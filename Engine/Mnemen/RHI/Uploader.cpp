@@ -6,6 +6,7 @@
 #include <RHI/Uploader.hpp>
 #include <Core/Logger.hpp>
 #include <Core/Timer.hpp>
+#include <Core/Metrics.hpp>
 
 Uploader::Data Uploader::sData;
 
@@ -139,6 +140,7 @@ bool Uploader::Flush()
     sData.CmdBuffer = MakeRef<CommandBuffer>(sData.Device, sData.UploadQueue, sData.Heaps, true);
     sData.CmdBuffer->Begin();
 
+    COUNTER_ADD("Uploads Flushed", sData.Requests.size());
     LOG_INFO("Flushing {0} upload requests ({1} buffer uploads, {2} texture uploads, {3} acceleration structure builds)", sData.Requests.size(), sData.BufferRequests, sData.TextureRequests, sData.ASRequests);
     for (auto request : sData.Requests) {        
         switch (request.Type) {
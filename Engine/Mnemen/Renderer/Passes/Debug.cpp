@@ -52,8 +52,9 @@ void Debug::Render(const Frame& frame, ::Ref<Scene> scene)
 
     if (!sData.Lines.empty()) {
         mLineCount = sData.Lines.size();
-        Vector<LineVertex> vertices;
-        for (Line line : sData.Lines) {
+        Vector<LineVertex>& vertices = sData.Vertices;
+        vertices.clear();
+        for (const Line& line : sData.Lines) {
             vertices.push_back({ line.From, line.Color });
             vertices.push_back({ line.To, line.Color });
         }
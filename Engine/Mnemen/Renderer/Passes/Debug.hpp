@@ -190,6 +190,7 @@ private:
     static struct Data
     {
         Vector<Line> Lines; ///< A vector holding the lines to be drawn.
+        Vector<LineVertex> Vertices; ///< The vertices of the lines, kept between frames so they're not reallocated every frame.
         GraphicsPipeline::Ref Pipeline; ///< The graphics pipeline used for rendering.
         Array<Buffer::Ref, FRAMES_IN_FLIGHT> TransferBuffer; ///< Transfer buffers for each frame.
         Array<Buffer::Ref, FRAMES_IN_FLIGHT> VertexBuffer; ///< Vertex buffers for each frame.
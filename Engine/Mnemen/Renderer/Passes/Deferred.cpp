@@ -153,7 +153,8 @@ void Deferred::Render(const Frame& frame, ::Ref<Scene> scene)
         frame.CommandBuffer->SetMeshPipeline(mPipeline);
 
         // Draw function for each model
-        std::function<void(Frame frame, MeshNode*, Mesh* model, glm::mat4 transform)> drawNode = [&](Frame frame, MeshNode* node, Mesh* model, glm::mat4 transform) {
+        // Recursive through its own argument rather than a std::function, which would allocate every frame.
+        auto drawNode = [&](auto& self, Frame frame, MeshNode* node, Mesh* model, glm::mat4 transform) -> void {
             if (!node) {
                 return;
             }
@@ -197,7 +198,7 @@ void Deferred::Render(const Frame& frame, ::Ref<Scene> scene)
             }
             if (!node->Children.empty()) {
                 for (MeshNode* child : node->Children) {
-                    drawNode(frame, child, model, globalTransform);
+                    self(self, frame, child, model, globalTransform);
                 }
             }
         };
@@ -211,7 +212,7 @@ void Deferred::Render(const Frame& frame, ::Ref<Scene> scene)
                 entity.ID = id;
 
                 if (mesh.Loaded) {
-                    drawNode(frame, mesh.MeshAsset->Mesh.Root, &mesh.MeshAsset->Mesh, entity.GetWorldTransform());
+                    drawNode(drawNode, frame, mesh.MeshAsset->Mesh.Root, &mesh.MeshAsset->Mesh, entity.GetWorldTransform());
                 }
             }
         }
@@ -5,6 +5,7 @@
 
 #include "Renderer.hpp"
 #include "RendererTools.hpp"
+#include <Core/MemoryTracker.hpp>
 
 #include "Passes/Deferred.hpp"
 #include "Passes/Composite.hpp"
@@ -43,6 +44,7 @@ Renderer::~Renderer()
 void Renderer::Render(const Frame& frame, ::Ref<Scene> scene)
 {
     PROFILE_FUNCTION();
+    MEMORY_TAG(MemoryTag::Renderer);
     for (auto& pass : mPasses) {
         pass->Render(frame, scene);
     }
@@ -4,6 +4,7 @@
 //
 
 #include <Core/Logger.hpp>
+#include <Asset/AssetCacher.hpp>
 
 #include "Script.hpp"
 #include "ScriptSystem.hpp"
@@ -16,22 +17,28 @@ Script::Script(const String& path)
 
 Script::~Script()
 {
-    if (mValid) {
-        ScriptSystem::GetState()->collect_garbage();
-        mValid = false;
-    }
+    // Whatever the script left behind is reclaimed by the regular generational collections.
+    mValid = false;
 }
 
 void Script::Reload()
 {
-    if (mValid) {
-        ScriptSystem::GetState()->collect_garbage();
-        mValid = false;
-    }
+    mValid = false;
 
     sol::state* state = ScriptSystem::GetState();   
+    mVersion++;
     
-    mHandle = state->load_file(mPath);
+    mBytecode.clear();
+    if (AssetCacher::ReadScriptBytecode(mPath, mBytecode)) {
+        mHandle = state->load_buffer(reinterpret_cast<const char*>(mBytecode.data()), mBytecode.size(), "@" + mPath, sol::load_mode::binary);
+        if (!mHandle.valid()) {
+            sol::error err = mHandle;
+            LOG_WARN("Cached bytecode for {0} was rejected ({1}), loading from source", mPath, err.what());
+            mBytecode.clear();
+        }
+    }
+    if (mBytecode.empty())
+        mHandle = state->load_file(mPath);
     if (!mHandle.valid()) {
         mValid = false;
 
@@ -40,4 +47,36 @@ void Script::Reload()
         return;
     }
     mValid = true;
+
+    DetectBatched();
+}
+
+void Script::DetectBatched()
+{
+    mBatched = false;
+    mParallel = false;
+    mModule = sol::lua_nil;
+    mUpdateAll = sol::lua_nil;
+
+    sol::protected_function chunk = mHandle.get<sol::protected_function>();
+    sol::protected_function_result result = chunk();
+    if (!result.valid()) {
+        sol::error err = result;
+        LOG_ERROR("[LUA::ERROR::LOAD] {0}: {1}", mPath, err.what());
+        return;
+    }
+    if (result.get_type() != sol::type::table)
+        return;
+
+    sol::table module = result;
+    sol::object updateAll = module["updateAll"];
+    if (updateAll.get_type() != sol::type::function) {
+        LOG_WARN("Script {0} returned a table without updateAll, ignoring it", mPath);
+        return;
+    }
+
+    mModule = module;
+    mUpdateAll = updateAll.as<sol::protected_function>();
+    mBatched = true;
+    mParallel = module["parallel"].get_or(false);
 }
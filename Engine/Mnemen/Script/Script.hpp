@@ -20,8 +20,30 @@ public:
 
     bool IsValid() { return mValid; }
     sol::load_result* GetHandle() { return &mHandle; }
+    const String& GetPath() { return mPath; }
+    UInt64 GetVersion() { return mVersion; }
+
+    // Bytecode from the asset cache, empty if the script had to be loaded from source.
+    const Vector<UInt8>& GetBytecode() { return mBytecode; }
+
+    // A batched script returns a module table exporting updateAll(entities, dt) instead of a per-entity constructor.
+    bool IsBatched() { return mBatched; }
+    sol::table& GetModule() { return mModule; }
+    sol::protected_function& GetUpdateAll() { return mUpdateAll; }
+
+    // Batched scripts setting `parallel = true` are run by ScriptSystem on its worker Lua states.
+    bool IsParallel() { return mParallel; }
 private:
+    void DetectBatched();
+
     String mPath;
+    UInt64 mVersion = 0;
     bool mValid = false;
     sol::load_result mHandle;
+    Vector<UInt8> mBytecode;
+
+    bool mBatched = false;
+    bool mParallel = false;
+    sol::table mModule;
+    sol::protected_function mUpdateAll;
 };
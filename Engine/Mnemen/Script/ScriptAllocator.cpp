@@ -0,0 +1,124 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-23 13:55:12
+//
+
+#include "ScriptAllocator.hpp"
+
+#include <Core/MemoryTracker.hpp>
+
+#include <cstdlib>
+#include <cstring>
+
+ScriptAllocator::~ScriptAllocator()
+{
+    for (void* page : mPages) {
+        free(page);
+    }
+    mPages.clear();
+    for (void* block : mShrunkBlocks) {
+        free(block);
+    }
+    mShrunkBlocks.clear();
+}
+
+void ScriptAllocator::RefillClass(UInt64 sizeClass)
+{
+    UInt64 blockSize = (sizeClass + 1) * Granularity;
+
+    UInt8* page = (UInt8*)malloc(PageSize);
+    if (!page)
+        return;
+    mPages.push_back(page);
+    mStats.ReservedPoolBytes += PageSize;
+
+    for (UInt64 offset = 0; offset + blockSize <= PageSize; offset += blockSize) {
+        FreeBlock* block = (FreeBlock*)(page + offset);
+        block->Next = mFreeLists[sizeClass];
+        mFreeLists[sizeClass] = block;
+    }
+}
+
+void* ScriptAllocator::AllocateBlock(size_t size)
+{
+    if (size > MaxPooledSize)
+        return malloc(size);
+
+    UInt64 sizeClass = GetSizeClass(size);
+    if (!mFreeLists[sizeClass]) {
+        RefillClass(sizeClass);
+        if (!mFreeLists[sizeClass])
+            return nullptr;
+    }
+
+    FreeBlock* block = mFreeLists[sizeClass];
+    mFreeLists[sizeClass] = block->Next;
+    mStats.PooledAllocationCount++;
+    return block;
+}
+
+void ScriptAllocator::FreeBlock(void* ptr, size_t size)
+{
+    if (size > MaxPooledSize || (!mShrunkBlocks.empty() && mShrunkBlocks.erase(ptr))) {
+        free(ptr);
+        return;
+    }
+
+    UInt64 sizeClass = GetSizeClass(size);
+    FreeBlock* block = (FreeBlock*)ptr;
+    block->Next = mFreeLists[sizeClass];
+    mFreeLists[sizeClass] = block;
+}
+
+void* ScriptAllocator::Allocate(void* userData, void* ptr, size_t oldSize, size_t newSize)
+{
+    ScriptAllocator* allocator = (ScriptAllocator*)userData;
+    ScriptMemoryStats& stats = allocator->mStats;
+
+    // When ptr is null, oldSize encodes the type of the object being allocated rather than a size
+    size_t previousSize = ptr ? oldSize : 0;
+
+    if (newSize == 0) {
+        if (ptr)
+            allocator->FreeBlock(ptr, previousSize);
+        stats.LiveBytes -= previousSize;
+        stats.FreedBytes += previousSize;
+        if constexpr (MemoryTracker::Enabled)
+            MemoryTracker::RecordFree(MemoryTag::Script, previousSize);
+        return nullptr;
+    }
+
+    void* result = nullptr;
+    if (!ptr) {
+        result = allocator->AllocateBlock(newSize);
+    } else if (previousSize > MaxPooledSize && newSize > MaxPooledSize) {
+        result = realloc(ptr, newSize);
+    } else if (previousSize <= MaxPooledSize && newSize <= MaxPooledSize && GetSizeClass(previousSize) == GetSizeClass(newSize)) {
+        result = ptr;
+    } else {
+        result = allocator->AllocateBlock(newSize);
+        if (result) {
+            memcpy(result, ptr, std::min(previousSize, newSize));
+            allocator->FreeBlock(ptr, previousSize);
+        } else if (newSize <= previousSize) {
+            // Lua expects shrinking to never fail: keep the bigger block, it is still large enough for its new class.
+            // A system block now carries a pooled size, remember it so it isn't freed into a free list.
+            result = ptr;
+            if (previousSize > MaxPooledSize)
+                allocator->mShrunkBlocks.insert(ptr);
+        }
+    }
+    if (!result)
+        return nullptr;
+
+    stats.LiveBytes = stats.LiveBytes - previousSize + newSize;
+    stats.PeakBytes = std::max(stats.PeakBytes, stats.LiveBytes);
+    stats.AllocatedBytes += newSize;
+    stats.FreedBytes += previousSize;
+    stats.AllocationCount++;
+    if constexpr (MemoryTracker::Enabled) {
+        MemoryTracker::RecordFree(MemoryTag::Script, previousSize);
+        MemoryTracker::RecordAllocation(MemoryTag::Script, newSize);
+    }
+    return result;
+}
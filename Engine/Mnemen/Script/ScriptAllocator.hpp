@@ -0,0 +1,58 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-23 13:48:30
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+
+#include <sol/sol.hpp>
+
+// Memory counters of a single Lua state. Every state owns its own, so no synchronization is needed.
+struct ScriptMemoryStats
+{
+    UInt64 LiveBytes = 0;
+    UInt64 PeakBytes = 0;
+    UInt64 AllocatedBytes = 0;
+    UInt64 FreedBytes = 0;
+    UInt64 AllocationCount = 0;
+    UInt64 PooledAllocationCount = 0;
+    UInt64 ReservedPoolBytes = 0;
+};
+
+// lua_Alloc backing a single Lua state. Small blocks (strings, tables, closures...) come from size-class
+// free lists carved out of 64kb pages, bigger ones fall back to the system allocator.
+// Pages are only released when the allocator dies, so it must outlive the state it is plugged into.
+class ScriptAllocator
+{
+public:
+    ScriptAllocator() = default;
+    ~ScriptAllocator();
+
+    // The user data must be the ScriptAllocator of the state.
+    static void* Allocate(void* userData, void* ptr, size_t oldSize, size_t newSize);
+
+    const ScriptMemoryStats& GetStats() const { return mStats; }
+private:
+    static constexpr UInt64 Granularity = 16;
+    static constexpr UInt64 MaxPooledSize = 512;
+    static constexpr UInt64 ClassCount = MaxPooledSize / Granularity;
+    static constexpr UInt64 PageSize = 64 * 1024;
+
+    struct FreeBlock {
+        FreeBlock* Next;
+    };
+
+    static UInt64 GetSizeClass(size_t size) { return (size + Granularity - 1) / Granularity - 1; }
+
+    void* AllocateBlock(size_t size);
+    void FreeBlock(void* ptr, size_t size);
+    void RefillClass(UInt64 sizeClass);
+
+    Array<FreeBlock*, ClassCount> mFreeLists = {};
+    Vector<void*> mPages;
+    // System blocks shrunk to a pooled size when the pool couldn't serve them, they go back to the system.
+    Set<void*> mShrunkBlocks;
+    ScriptMemoryStats mStats;
+};
@@ -14,6 +14,9 @@ void ScriptBinding::InitBindings(sol::state& state)
     InitVec(state);
     InitQuat(state);
     InitTransform(state);
+    InitTransformArrays(state);
+    InitPhysics(state);
+    InitNavigation(state);
     InitCameraComponent(state);
     InitAudioSourceComponent(state);
     InitKeycode(state);
@@ -104,6 +107,35 @@ void ScriptBinding::InitTransform(sol::state& state)
     );
 }
 
+void ScriptBinding::InitTransformArrays(sol::state& state)
+{
+    auto transforms = state.create_table("Transforms");
+    transforms["ReadPositions"] = &LuaWrapper::LuaTransformArrays::ReadPositions;
+    transforms["WritePositions"] = &LuaWrapper::LuaTransformArrays::WritePositions;
+    transforms["ReadRotations"] = &LuaWrapper::LuaTransformArrays::ReadRotations;
+    transforms["WriteRotations"] = &LuaWrapper::LuaTransformArrays::WriteRotations;
+    transforms["ReadScales"] = &LuaWrapper::LuaTransformArrays::ReadScales;
+    transforms["WriteScales"] = &LuaWrapper::LuaTransformArrays::WriteScales;
+}
+
+void ScriptBinding::InitPhysics(sol::state& state)
+{
+    auto physics = state.create_table("Physics");
+    physics["Raycast"] = &LuaWrapper::LuaPhysics::Raycast;
+    physics["SphereCast"] = &LuaWrapper::LuaPhysics::SphereCast;
+    physics["BoxCast"] = &LuaWrapper::LuaPhysics::BoxCast;
+    physics["OverlapSphere"] = &LuaWrapper::LuaPhysics::OverlapSphere;
+    physics["OverlapBox"] = &LuaWrapper::LuaPhysics::OverlapBox;
+}
+
+void ScriptBinding::InitNavigation(sol::state& state)
+{
+    auto navigation = state.create_table("Navigation");
+    navigation["RequestPath"] = &LuaWrapper::LuaNavigation::RequestPath;
+    navigation["GetPath"] = &LuaWrapper::LuaNavigation::GetPath;
+    navigation["CancelPath"] = &LuaWrapper::LuaNavigation::CancelPath;
+}
+
 void ScriptBinding::InitCameraComponent(sol::state& state)
 {
     state.new_usertype<CameraComponent>(
@@ -124,6 +156,11 @@ void ScriptBinding::InitAudioSourceComponent(sol::state& state)
         "Looping", &AudioSourceComponent::Looping,
         "PlayOnAwake", &AudioSourceComponent::PlayOnAwake,
         "Volume", &AudioSourceComponent::Volume,
+        "Priority", &AudioSourceComponent::Priority,
+        "Spatial", &AudioSourceComponent::Spatial,
+        "MinDistance", &AudioSourceComponent::MinDistance,
+        "MaxDistance", &AudioSourceComponent::MaxDistance,
+        "DopplerFactor", &AudioSourceComponent::DopplerFactor,
         "Play", &AudioSourceComponent::Play,
         "Stop", &AudioSourceComponent::Stop
     );
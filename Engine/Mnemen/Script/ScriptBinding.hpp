@@ -19,6 +19,9 @@ private:
     static void InitQuat(sol::state& state);
     static void InitInput(sol::state& state);
     static void InitTransform(sol::state& state);
+    static void InitTransformArrays(sol::state& state);
+    static void InitPhysics(sol::state& state);
+    static void InitNavigation(sol::state& state);
     static void InitCameraComponent(sol::state& state);
     static void InitAudioSourceComponent(sol::state& state);
 };
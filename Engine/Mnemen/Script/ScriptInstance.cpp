@@ -6,16 +6,63 @@
 #include <Core/Logger.hpp>
 
 #include "ScriptInstance.hpp"
+#include "ScriptScheduler.hpp"
 
-ScriptInstance::ScriptInstance(sol::load_result* script)
+ScriptInstance::ScriptInstance(Script* script)
     : mParent(script)
 {
     
 }
 
+ScriptInstance::~ScriptInstance()
+{
+    StopRun();
+}
+
+void ScriptInstance::StopRun()
+{
+    if (mRunCoroutine != 0) {
+        ScriptScheduler::Stop(mRunCoroutine);
+        mRunCoroutine = 0;
+    }
+}
+
 void ScriptInstance::Reset(int entityID)
 {
-    sol::protected_function scriptConstructor = mParent->get<sol::protected_function>();
+    StopRun();
+    mAwoken = false;
+    mTable = sol::lua_nil;
+    mAwake = sol::lua_nil;
+    mUpdate = sol::lua_nil;
+    mQuit = sol::lua_nil;
+    mRun = sol::lua_nil;
+    mEntity = entityID;
+    mLowPriority = false;
+    mPendingTime = 0.0f;
+
+    if (mParent->IsBatched()) {
+        // Per-entity state is optional for batched scripts: module.new(entity) may return a table with awake/quit.
+        sol::object constructor = mParent->GetModule()["new"];
+        if (constructor.get_type() != sol::type::function)
+            return;
+
+        sol::protected_function_result result = constructor.as<sol::protected_function>()(entityID);
+        if (!result.valid()) {
+            sol::error err = result;
+            LOG_ERROR("[LUA::ERROR::NEW] Error: {0}", err.what());
+            return;
+        }
+        if (result.get_type() != sol::type::table)
+            return;
+
+        mTable = result;
+        mAwake = mTable["awake"];
+        mQuit = mTable["quit"];
+        mRun = mTable["run"];
+        return;
+    }
+
+    sol::protected_function scriptConstructor = mParent->GetHandle()->get<sol::protected_function>();
     if (!scriptConstructor.valid()) {
         LOG_ERROR("ScriptConstructor is not valid!");
         return;
@@ -40,10 +87,13 @@ void ScriptInstance::Reset(int entityID)
     mAwake = mTable["awake"];
     mUpdate = mTable["update"];
     mQuit = mTable["quit"];
+    mRun = mTable["run"];
+    mLowPriority = mTable["lowPriority"].get_or(false);
 }
 
 void ScriptInstance::Awake()
 {
+    mAwoken = true;
     if (mAwake.valid()) {
         sol::protected_function_result result = mAwake();
         if (!result.valid()) {
@@ -51,6 +101,8 @@ void ScriptInstance::Awake()
             LOG_ERROR("[LUA::ERROR::AWAKE] Error: {0}", err.what());
         }
     }
+    if (mRun.valid())
+        mRunCoroutine = ScriptScheduler::Start(mRun);
 }
 
 void ScriptInstance::Update(float dt)
@@ -66,6 +118,7 @@ void ScriptInstance::Update(float dt)
 
 void ScriptInstance::Quit()
 {
+    StopRun();
     if (mQuit.valid()) {
         sol::protected_function_result result = mQuit();
         if (!result.valid()) {
@@ -10,18 +10,44 @@
 class ScriptInstance
 {
 public:
-    ScriptInstance(sol::load_result* script);
-    ~ScriptInstance() = default;
+    ScriptInstance(Script* script);
+    ~ScriptInstance();
 
     void Reset(int entityID);
     void Awake();
     void Update(float dt);
     void Quit();
+
+    // Batched instances are skipped by Update, ScriptSystem dispatches them through their script's updateAll.
+    bool IsBatched() { return mParent->IsBatched(); }
+    Script* GetScript() { return mParent; }
+
+    // Optional `run` function of the instance, started as a coroutine when the instance awakes and stopped with it.
+    sol::function& GetRun() { return mRun; }
+
+    // Whether Awake ran since the last Reset. Instances added while the scene plays are awoken on their first update.
+    bool IsAwake() { return mAwoken; }
+
+    int GetEntity() { return mEntity; }
+
+    // Low priority instances (`lowPriority = true` in their table) get time-sliced when ScriptSystem's budget is exceeded.
+    // Time they missed is accumulated and handed to their next update.
+    bool IsLowPriority() { return mLowPriority; }
+    void AddPendingTime(float dt) { mPendingTime += dt; }
+    float ConsumePendingTime() { float time = mPendingTime; mPendingTime = 0.0f; return time; }
 private:
-    sol::load_result* mParent;
+    Script* mParent;
+    int mEntity = -1;
+    bool mLowPriority = false;
+    float mPendingTime = 0.0f;
+    bool mAwoken = false;
+    UInt64 mRunCoroutine = 0;
+
+    void StopRun();
 
     sol::table mTable;
     sol::protected_function mAwake;
     sol::protected_function mUpdate;
     sol::protected_function mQuit;
+    sol::function mRun;
 };
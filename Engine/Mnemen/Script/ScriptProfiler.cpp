@@ -0,0 +1,154 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-23 14:26:57
+//
+
+#include "ScriptProfiler.hpp"
+#include "Script.hpp"
+
+#include <Core/File.hpp>
+#include <Core/Logger.hpp>
+
+#include <imgui.h>
+
+ScriptProfiler::Data ScriptProfiler::sData;
+
+void ScriptProfiler::Accumulate(ScriptProfile& profile, double ms, UInt64 allocatedBytes)
+{
+    profile.Calls++;
+    profile.TotalMs += ms;
+    profile.MaxMs = std::max(profile.MaxMs, ms);
+    profile.FrameMs += ms;
+    profile.AllocatedBytes += allocatedBytes;
+}
+
+void ScriptProfiler::BeginFrame()
+{
+    sData.FrameMs = 0.0;
+    sData.SkippedInstances = 0;
+    sData.GC.FrameMs = 0.0;
+    for (auto& [path, entry] : sData.Scripts) {
+        entry.Total.FrameMs = 0.0;
+        for (auto& [entity, instance] : entry.Instances) {
+            instance.FrameMs = 0.0;
+        }
+    }
+}
+
+void ScriptProfiler::Reset()
+{
+    sData.Scripts.clear();
+    sData.GC = {};
+    sData.FrameMs = 0.0;
+    sData.SkippedInstances = 0;
+}
+
+void ScriptProfiler::Record(Script* script, int entity, double ms, UInt64 allocatedBytes)
+{
+    ScriptEntry& entry = sData.Scripts[script->GetPath()];
+    Accumulate(entry.Total, ms, allocatedBytes);
+    Accumulate(entry.Instances[entity], ms, allocatedBytes);
+    sData.FrameMs += ms;
+}
+
+void ScriptProfiler::RecordGC(double ms)
+{
+    Accumulate(sData.GC, ms, 0);
+}
+
+void ScriptProfiler::OnUI()
+{
+    ImGui::Text("Frame : %fms (%llu instances time-sliced)", sData.FrameMs, sData.SkippedInstances);
+    ImGui::Text("GC : %fms this frame, %fms total over %llu collections (max %fms)", sData.GC.FrameMs, sData.GC.TotalMs, sData.GC.Calls, sData.GC.MaxMs);
+    if (sData.Memory) {
+        ImGui::Text("Lua Memory : %.2fkb live, %.2fkb peak, %llu allocations", sData.Memory->LiveBytes / 1024.0f, sData.Memory->PeakBytes / 1024.0f, sData.Memory->AllocationCount);
+        ImGui::Text("Lua Pools : %.2fkb reserved, %llu pooled allocations", sData.Memory->ReservedPoolBytes / 1024.0f, sData.Memory->PooledAllocationCount);
+    }
+
+    if (ImGui::BeginTable("Scripts", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Script");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Frame (ms)");
+        ImGui::TableSetupColumn("Total (ms)");
+        ImGui::TableSetupColumn("Max (ms)");
+        ImGui::TableSetupColumn("Allocated (kb)");
+        ImGui::TableHeadersRow();
+
+        for (auto& [path, entry] : sData.Scripts) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            bool open = ImGui::TreeNode(path.c_str());
+            ImGui::TableNextColumn(); ImGui::Text("%llu", entry.Total.Calls);
+            ImGui::TableNextColumn(); ImGui::Text("%f", entry.Total.FrameMs);
+            ImGui::TableNextColumn(); ImGui::Text("%f", entry.Total.TotalMs);
+            ImGui::TableNextColumn(); ImGui::Text("%f", entry.Total.MaxMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", entry.Total.AllocatedBytes / 1024.0f);
+            if (open) {
+                for (auto& [entity, instance] : entry.Instances) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    if (entity == -1)
+                        ImGui::Text("Batch");
+                    else
+                        ImGui::Text("Entity %d", entity);
+                    ImGui::TableNextColumn(); ImGui::Text("%llu", instance.Calls);
+                    ImGui::TableNextColumn(); ImGui::Text("%f", instance.FrameMs);
+                    ImGui::TableNextColumn(); ImGui::Text("%f", instance.TotalMs);
+                    ImGui::TableNextColumn(); ImGui::Text("%f", instance.MaxMs);
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f", instance.AllocatedBytes / 1024.0f);
+                }
+                ImGui::TreePop();
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Dump to script_profile.json")) {
+        Dump("script_profile.json");
+    }
+}
+
+void ScriptProfiler::Dump(const String& path)
+{
+    auto profileToJson = [](const ScriptProfile& profile) {
+        return nlohmann::json {
+            { "calls", profile.Calls },
+            { "frameMs", profile.FrameMs },
+            { "totalMs", profile.TotalMs },
+            { "maxMs", profile.MaxMs },
+            { "allocatedBytes", profile.AllocatedBytes }
+        };
+    };
+
+    nlohmann::json root;
+    root["frameMs"] = sData.FrameMs;
+    root["skippedInstances"] = sData.SkippedInstances;
+    root["gc"] = profileToJson(sData.GC);
+    if (sData.Memory) {
+        root["memory"] = {
+            { "liveBytes", sData.Memory->LiveBytes },
+            { "peakBytes", sData.Memory->PeakBytes },
+            { "allocatedBytes", sData.Memory->AllocatedBytes },
+            { "freedBytes", sData.Memory->FreedBytes },
+            { "allocationCount", sData.Memory->AllocationCount },
+            { "pooledAllocationCount", sData.Memory->PooledAllocationCount },
+            { "reservedPoolBytes", sData.Memory->ReservedPoolBytes }
+        };
+    }
+
+    root["scripts"] = nlohmann::json::array();
+    for (auto& [scriptPath, entry] : sData.Scripts) {
+        nlohmann::json script = profileToJson(entry.Total);
+        script["path"] = scriptPath;
+        script["instances"] = nlohmann::json::array();
+        for (auto& [entity, instance] : entry.Instances) {
+            nlohmann::json instanceJson = profileToJson(instance);
+            instanceJson["entity"] = entity;
+            script["instances"].push_back(instanceJson);
+        }
+        root["scripts"].push_back(script);
+    }
+
+    File::WriteJSON(root, path);
+    LOG_INFO("Dumped script profile at {0}", path);
+}
@@ -0,0 +1,55 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-23 14:10:44
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+
+#include "ScriptAllocator.hpp"
+
+class Script;
+
+// Call statistics of a script, or of one of its instances.
+struct ScriptProfile
+{
+    UInt64 Calls = 0;
+    double TotalMs = 0.0;
+    double MaxMs = 0.0;
+    double FrameMs = 0.0;
+    UInt64 AllocatedBytes = 0;
+};
+
+// Per-script and per-instance timings of every call ScriptSystem makes into Lua.
+class ScriptProfiler
+{
+public:
+    static void BeginFrame();
+    static void Reset();
+
+    // entity is -1 for calls that cover several entities at once (batched scripts)
+    static void Record(Script* script, int entity, double ms, UInt64 allocatedBytes);
+    static void RecordGC(double ms);
+    static void RecordSkipped(UInt64 count) { sData.SkippedInstances += count; }
+
+    static void SetMemoryStats(const ScriptMemoryStats* stats) { sData.Memory = stats; }
+
+    static void OnUI();
+    static void Dump(const String& path);
+private:
+    struct ScriptEntry {
+        ScriptProfile Total;
+        UnorderedMap<int, ScriptProfile> Instances;
+    };
+
+    static void Accumulate(ScriptProfile& profile, double ms, UInt64 allocatedBytes);
+
+    static struct Data {
+        UnorderedMap<String, ScriptEntry> Scripts;
+        ScriptProfile GC;
+        double FrameMs = 0.0;
+        UInt64 SkippedInstances = 0;
+        const ScriptMemoryStats* Memory = nullptr;
+    } sData;
+};
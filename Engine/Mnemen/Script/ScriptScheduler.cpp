@@ -0,0 +1,196 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-22 16:20:13
+//
+
+#include "ScriptScheduler.hpp"
+
+#include <Core/Logger.hpp>
+#include <Core/Profiler.hpp>
+
+#include <cmath>
+
+ScriptScheduler::Data ScriptScheduler::sData;
+
+// The wait helpers only yield a request to the scheduler, which decides when the coroutine is resumed.
+static const char* sPrelude = R"(
+function wait(seconds) coroutine.yield(1, seconds) end
+function waitFrames(frames) coroutine.yield(2, frames) end
+function waitUntil(predicate) coroutine.yield(3, predicate) end
+function waitEvent(name) coroutine.yield(4, name) end
+)";
+
+void ScriptScheduler::Init(sol::state& state)
+{
+    sData.State = &state;
+
+    state.script(sPrelude);
+    state["startCoroutine"] = &ScriptScheduler::Start;
+    state["stopCoroutine"] = &ScriptScheduler::Stop;
+    state["emit"] = &ScriptScheduler::Emit;
+}
+
+void ScriptScheduler::Exit()
+{
+    Clear();
+    sData.State = nullptr;
+}
+
+void ScriptScheduler::Clear()
+{
+    sData.Coroutines.clear();
+    sData.TimeWheel.Clear();
+    sData.FrameWheel.Clear();
+    sData.Predicates.clear();
+    sData.EventWaiters.clear();
+    sData.PendingEvents.clear();
+    sData.Ready.clear();
+}
+
+UInt64 ScriptScheduler::Start(sol::function function)
+{
+    if (!sData.State || !function.valid())
+        return 0;
+
+    UInt64 id = sData.NextID++;
+
+    Coroutine coroutine;
+    coroutine.Thread = sol::thread::create(sData.State->lua_state());
+    coroutine.Routine = sol::coroutine(coroutine.Thread.thread_state(), function);
+    sData.Coroutines[id] = std::move(coroutine);
+
+    // Run until the first wait so that the coroutine's setup happens on the frame it was started
+    Resume(id);
+    return id;
+}
+
+void ScriptScheduler::Stop(UInt64 id)
+{
+    auto it = sData.Coroutines.find(id);
+    if (it == sData.Coroutines.end())
+        return;
+
+    // A coroutine stopping itself (or one further up the resume chain) is erased once its resume returns.
+    // Wheel and event entries of a stopped coroutine are dropped lazily when they come due
+    if (it->second.Running) {
+        it->second.Stopped = true;
+        return;
+    }
+    sData.Coroutines.erase(it);
+}
+
+void ScriptScheduler::Emit(const String& event)
+{
+    sData.PendingEvents.push_back(event);
+}
+
+void ScriptScheduler::Update(float dt)
+{
+    PROFILE_FUNCTION();
+
+    // Nothing is waiting: idle scripts cost nothing
+    if (sData.Coroutines.empty()) {
+        sData.PendingEvents.clear();
+        return;
+    }
+
+    sData.Frame++;
+    sData.Time += dt;
+
+    sData.Ready.clear();
+    sData.FrameWheel.Advance(sData.Frame, sData.Ready);
+    sData.TimeWheel.Advance((UInt64)(sData.Time * TicksPerSecond), sData.Ready);
+
+    // A predicate can start a coroutine that reaches waitUntil right away and appends to Predicates, so poll a
+    // swapped-out copy and hand the ones still waiting back after the new waiters.
+    sData.Polling.swap(sData.Predicates);
+    for (auto& [id, predicate] : sData.Polling) {
+        if (sData.Coroutines.count(id) == 0)
+            continue;
+
+        sol::protected_function_result result = predicate();
+        if (!result.valid()) {
+            sol::error err = result;
+            LOG_ERROR("[LUA::ERROR::WAITUNTIL] Error: {0}", err.what());
+            sData.Coroutines.erase(id);
+        } else if (result.get<bool>()) {
+            sData.Ready.push_back(id);
+        } else {
+            sData.Predicates.push_back({ id, std::move(predicate) });
+        }
+    }
+    sData.Polling.clear();
+
+    for (auto& event : sData.PendingEvents) {
+        auto it = sData.EventWaiters.find(event);
+        if (it == sData.EventWaiters.end())
+            continue;
+        sData.Ready.insert(sData.Ready.end(), it->second.begin(), it->second.end());
+        sData.EventWaiters.erase(it);
+    }
+    sData.PendingEvents.clear();
+
+    for (UInt64 i = 0; i < sData.Ready.size(); i++) {
+        Resume(sData.Ready[i]);
+    }
+}
+
+void ScriptScheduler::Resume(UInt64 id)
+{
+    auto it = sData.Coroutines.find(id);
+    if (it == sData.Coroutines.end())
+        return;
+
+    // Resuming may start new coroutines and grow the map, but references to existing elements stay valid
+    Coroutine& coroutine = it->second;
+    if (!coroutine.Routine.runnable()) {
+        sData.Coroutines.erase(id);
+        return;
+    }
+
+    coroutine.Running = true;
+    sol::protected_function_result result = coroutine.Routine();
+    coroutine.Running = false;
+    if (coroutine.Stopped) {
+        sData.Coroutines.erase(id);
+        return;
+    }
+    if (!result.valid()) {
+        sol::error err = result;
+        LOG_ERROR("[LUA::ERROR::COROUTINE] Error: {0}", err.what());
+        sData.Coroutines.erase(id);
+        return;
+    }
+    if (result.status() != sol::call_status::yielded) {
+        sData.Coroutines.erase(id);
+        return;
+    }
+
+    WaitType type = result.return_count() > 0 && result.get_type(0) == sol::type::number ? (WaitType)result.get<int>(0) : WaitType::None;
+    switch (type) {
+        case WaitType::Seconds: {
+            double seconds = std::max(0.0, result.get<double>(1));
+            UInt64 due = (UInt64)std::ceil((sData.Time + seconds) * TicksPerSecond);
+            sData.TimeWheel.Schedule(due, id);
+            break;
+        }
+        case WaitType::Frames: {
+            int frames = std::max(1, result.get<int>(1));
+            sData.FrameWheel.Schedule(sData.Frame + frames, id);
+            break;
+        }
+        case WaitType::Until: {
+            sData.Predicates.push_back({ id, result.get<sol::protected_function>(1) });
+            break;
+        }
+        case WaitType::Event: {
+            sData.EventWaiters[result.get<String>(1)].push_back(id);
+            break;
+        }
+        default: {
+            // A bare coroutine.yield() resumes on the next frame
+            sData.FrameWheel.Schedule(sData.Frame + 1, id);
+            break;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-22 16:02:51
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+#include <Utility/TimerWheel.hpp>
+
+#include <sol/sol.hpp>
+
+// Runs Lua coroutines started from scripts. Waiting coroutines are parked in timer wheels or event lists,
+// so only the ones that are due get resumed each frame.
+class ScriptScheduler
+{
+public:
+    static void Init(sol::state& state);
+    static void Exit();
+
+    static void Update(float dt);
+    static void Clear();
+
+    static UInt64 Start(sol::function function);
+    static void Stop(UInt64 id);
+    static void Emit(const String& event);
+
+    static UInt64 GetCoroutineCount() { return sData.Coroutines.size(); }
+private:
+    // Values yielded by the Lua-side wait helpers
+    enum class WaitType
+    {
+        None = 0,
+        Seconds = 1,
+        Frames = 2,
+        Until = 3,
+        Event = 4
+    };
+
+    struct Coroutine {
+        sol::thread Thread;
+        sol::coroutine Routine;
+        bool Running = false; // Being resumed, Stop only flags it so the thread isn't destroyed under its own feet
+        bool Stopped = false;
+    };
+
+    static void Resume(UInt64 id);
+
+    static constexpr float TicksPerSecond = 100.0f;
+
+    static struct Data {
+        sol::state* State = nullptr;
+
+        UnorderedMap<UInt64, Coroutine> Coroutines;
+        UInt64 NextID = 1;
+
+        double Time = 0.0;
+        UInt64 Frame = 0;
+        TimerWheel<UInt64> TimeWheel;
+        TimerWheel<UInt64> FrameWheel;
+        Vector<Pair<UInt64, sol::protected_function>> Predicates;
+        Vector<Pair<UInt64, sol::protected_function>> Polling;
+        UnorderedMap<String, Vector<UInt64>> EventWaiters;
+        Vector<String> PendingEvents;
+
+        Vector<UInt64> Ready;
+    } sData;
+};
@@ -6,15 +6,21 @@
 #include "ScriptSystem.hpp"
 #include "ScriptWrapper.hpp"
 #include "ScriptBinding.hpp"
+#include "ScriptScheduler.hpp"
+#include "ScriptProfiler.hpp"
 
 #include <sstream>
+#include <cmath>
 
 #include <Core/Logger.hpp>
 #include <Core/Profiler.hpp>
+#include <Core/Metrics.hpp>
+#include <Core/MemoryTracker.hpp>
+#include <Core/JobSystem.hpp>
 
 ScriptSystem::Data ScriptSystem::sData;
 
-void ScriptSystem::LogCallback(const sol::variadic_args& args)
+String ScriptSystem::FormatLogArgs(const sol::variadic_args& args)
 {
     std::stringstream ss;
         
@@ -31,7 +37,12 @@ void ScriptSystem::LogCallback(const sol::variadic_args& args)
             ss << (args[i].as<bool>() ? "true" : "false");
         }
     }
-    LOG_INFO("[LUA] {0}", ss.str());
+    return ss.str();
+}
+
+void ScriptSystem::LogCallback(const sol::variadic_args& args)
+{
+    LOG_INFO("[LUA] {0}", FormatLogArgs(args));
 }
 
 int ScriptSystem::PanicCallback(lua_State* L)
@@ -50,44 +61,341 @@ void ScriptSystem::Init()
                                sol::lib::table,
                                sol::lib::utf8,
                                sol::lib::io,
+                               sol::lib::coroutine,
                                sol::lib::jit);
     sData.State.set_function("print", &ScriptSystem::LogCallback);
     sData.State.set_panic(&ScriptSystem::PanicCallback);
+    ApplyGCSettings(sData.State);
 
     ScriptBinding::InitBindings(sData.State);
+    ScriptScheduler::Init(sData.State);
+    ScriptProfiler::SetMemoryStats(&sData.Allocator.GetStats());
+
+    for (UInt32 i = 0; i < JobSystem::GetWorkerCount(); i++) {
+        sData.Workers.push_back(MakeUnique<ScriptWorker>(i));
+    }
 
     LOG_INFO("Initialized Script System");
 }
 
 void ScriptSystem::Exit()
 {
-    
+    ScriptScheduler::Exit();
+    sData.Batches.clear();
+    sData.Workers.clear();
 }
 
 void ScriptSystem::Awake(Ref<Scene> scene)
 {
+    Timer timer;
     entt::registry* reg = scene->GetRegistry();
 
+    sData.Batches.clear();
+
+    UInt64 instanceCount = 0;
+
     auto view = reg->view<ScriptComponent>();
     for (auto [id, script] : view.each()) {
         for (auto& instance : script.Instances) {
+            if (!instance->Instance)
+                continue;
             instance->Instance->Reset((int)id);
             instance->Instance->Awake();
+            instanceCount++;
         }
     }
+
+    // One full collection for the whole scene, rather than one per script load as we used to.
+    Timer gcTimer;
+    sData.State.collect_garbage();
+    float gcTime = gcTimer.GetElapsed();
+    ScriptProfiler::RecordGC(gcTime);
+
+    reg->on_destroy<ScriptComponent>().connect<&ScriptSystem::OnScriptDestroyed>();
+
+    LOG_INFO("Awoke {0} script instances in {1}ms (GC {2}ms, {3}kb live Lua memory)", instanceCount, timer.GetElapsed(), gcTime, GetMemoryStats().LiveBytes / 1024);
 }
 
 void ScriptSystem::Update(Ref<Scene> scene, float dt)
 {
     PROFILE_FUNCTION();
+    MEMORY_TAG(MemoryTag::Script);
+
+    Timer frameTimer;
+    ScriptProfiler::BeginFrame();
 
     entt::registry* reg = scene->GetRegistry();
 
+    for (auto& [script, batch] : sData.Batches) {
+        batch.Entities.clear();
+    }
+    sData.LowPriority.clear();
+
     auto view = reg->view<ScriptComponent>();
     for (auto [id, script] : view.each()) {
         for (auto& instance : script.Instances) {
-            instance->Instance->Update(dt);
+            if (!instance->Instance)
+                continue;
+            // Entities spawned and scripts added during play haven't been through Awake.
+            if (!instance->Instance->IsAwake()) {
+                instance->Instance->Reset((int)id);
+                instance->Instance->Awake();
+            }
+            if (instance->Instance->IsBatched()) {
+                sData.Batches[instance->Instance->GetScript()].Entities.push_back((int)id);
+                continue;
+            }
+            if (sData.BudgetMs > 0.0f && instance->Instance->IsLowPriority()) {
+                sData.LowPriority.push_back(instance->Instance.get());
+                continue;
+            }
+            RunUpdate(instance->Instance.get(), dt);
+        }
+    }
+
+    DispatchBatches(dt);
+    DispatchParallelBatches(dt);
+    FlushWorkerCommands();
+    UpdateLowPriority(dt, frameTimer.GetElapsed());
+
+    ScriptScheduler::Update(dt);
+    StepGC();
+}
+
+void ScriptSystem::SetGCSettings(const ScriptGCSettings& settings)
+{
+    sData.GC = settings;
+    ApplyGCSettings(sData.State);
+    for (auto& worker : sData.Workers) {
+        ApplyGCSettings(worker->GetState());
+    }
+}
+
+void ScriptSystem::ApplyGCSettings(sol::state& state)
+{
+    const ScriptGCSettings& gc = sData.GC;
+    if (gc.Mode == ScriptGCMode::Generational) {
+        state.change_gc_mode_generational(gc.MinorMultiplier, gc.MajorMultiplier);
+    } else {
+        // Lua takes the step size as a power of two.
+        int stepSizeLog2 = (int)std::ceil(std::log2(std::max(gc.StepSizeKb, 1) * 1024.0));
+        state.change_gc_mode_incremental(gc.Pause, gc.StepMultiplier, stepSizeLog2);
+    }
+}
+
+void ScriptSystem::StepGC()
+{
+    const ScriptGCSettings& gc = sData.GC;
+    if (gc.Mode != ScriptGCMode::Incremental || gc.BudgetMs <= 0.0f)
+        return;
+
+    // Always make some progress, then keep stepping until the cycle ends or the budget is spent.
+    Timer timer;
+    while (!sData.State.step_gc(gc.StepSizeKb)) {
+        if (timer.GetElapsed() >= gc.BudgetMs)
+            break;
+    }
+    ScriptProfiler::RecordGC(timer.GetElapsed());
+}
+
+void ScriptSystem::RunLoadBenchmark(const String& scriptPath, UInt32 scriptCount, UInt32 instancesPerScript)
+{
+    LOG_INFO("[SCRIPT BENCHMARK] Loading {0} {1} times with {2} instances each", scriptPath, scriptCount, instancesPerScript);
+
+    auto loadScene = [&](sol::state& state, bool fullGCPerScript, const char* label, const ScriptAllocator* allocator) {
+        state.open_libraries(sol::lib::base, sol::lib::math, sol::lib::string, sol::lib::table);
+        sol::table instances = state.create_table();
+
+        Timer timer;
+        UInt64 collections = 0;
+        for (UInt32 i = 0; i < scriptCount; i++) {
+            sol::load_result chunk = state.load_file(scriptPath);
+            if (!chunk.valid()) {
+                sol::error err = chunk;
+                LOG_ERROR("[SCRIPT BENCHMARK] Failed to load {0}: {1}", scriptPath, err.what());
+                return;
+            }
+
+            // Same steps as Script::Reload and ScriptInstance::Reset, without calling into the engine bindings.
+            sol::protected_function_result constructor = chunk.get<sol::protected_function>()();
+            if (constructor.valid() && constructor.get_type() == sol::type::function) {
+                sol::protected_function newInstance = constructor;
+                for (UInt32 j = 0; j < instancesPerScript; j++) {
+                    sol::protected_function_result instance = newInstance((int)(i * instancesPerScript + j));
+                    if (instance.valid())
+                        instances.raw_set(i * instancesPerScript + j + 1, instance.get<sol::object>());
+                }
+            }
+            if (fullGCPerScript) {
+                state.collect_garbage();
+                collections++;
+            }
+        }
+        if (!fullGCPerScript) {
+            state.collect_garbage();
+            collections++;
         }
+
+        float elapsed = timer.GetElapsed();
+        if (allocator) {
+            const ScriptMemoryStats& stats = allocator->GetStats();
+            LOG_INFO("[SCRIPT BENCHMARK] {0}: {1}ms, {2} full collections, {3}kb live, {4} allocations ({5} pooled)",
+                     label, elapsed, collections, state.memory_used() / 1024, stats.AllocationCount, stats.PooledAllocationCount);
+        } else {
+            LOG_INFO("[SCRIPT BENCHMARK] {0}: {1}ms, {2} full collections, {3}kb live", label, elapsed, collections, state.memory_used() / 1024);
+        }
+    };
+
+    {
+        sol::state state;
+        loadScene(state, true, "Default allocator, full GC per script", nullptr);
+    }
+    {
+        sol::state state;
+        loadScene(state, false, "Default allocator, one GC", nullptr);
+    }
+    {
+        ScriptAllocator allocator;
+        sol::state state(sol::default_at_panic, &ScriptAllocator::Allocate, &allocator);
+        ApplyGCSettings(state);
+        loadScene(state, false, "Pool allocator, one GC", &allocator);
+    }
+}
+
+void ScriptSystem::RunUpdate(ScriptInstance* instance, float dt)
+{
+    Timer timer;
+    UInt64 allocated = sData.Allocator.GetStats().AllocatedBytes;
+
+    instance->Update(dt);
+    COUNTER_ADD("Scripts Run", 1);
+
+    ScriptProfiler::Record(instance->GetScript(), instance->GetEntity(), timer.GetElapsed(), sData.Allocator.GetStats().AllocatedBytes - allocated);
+}
+
+void ScriptSystem::UpdateLowPriority(float dt, float elapsedMs)
+{
+    UInt64 count = sData.LowPriority.size();
+    if (count == 0)
+        return;
+
+    // Round-robin from where the previous frame stopped, always running at least one instance so nothing starves.
+    Timer timer;
+    UInt64 start = sData.LowPriorityCursor % count;
+    UInt64 ran = 0;
+    while (ran < count) {
+        if (ran > 0 && elapsedMs + timer.GetElapsed() >= sData.BudgetMs)
+            break;
+
+        ScriptInstance* instance = sData.LowPriority[(start + ran) % count];
+        RunUpdate(instance, dt + instance->ConsumePendingTime());
+        ran++;
+    }
+
+    for (UInt64 i = ran; i < count; i++) {
+        sData.LowPriority[(start + i) % count]->AddPendingTime(dt);
+    }
+    sData.LowPriorityCursor = (start + ran) % count;
+    ScriptProfiler::RecordSkipped(count - ran);
+}
+
+void ScriptSystem::DispatchBatches(float dt)
+{
+    for (auto& [script, batch] : sData.Batches) {
+        if (batch.Entities.empty())
+            continue;
+        if (!script->IsBatched())
+            continue;
+        if (script->IsParallel() && !sData.Workers.empty())
+            continue;
+
+        // Reuse the same Lua array every frame and only trim the tail, so steady-state batches don't generate garbage.
+        if (!batch.Table.valid()) {
+            batch.Table = sData.State.create_table((int)batch.Entities.size(), 0);
+            batch.TableSize = 0;
+        }
+        for (UInt64 i = 0; i < batch.Entities.size(); i++) {
+            batch.Table.raw_set(i + 1, batch.Entities[i]);
+        }
+        for (UInt64 i = batch.Entities.size(); i < batch.TableSize; i++) {
+            batch.Table.raw_set(i + 1, sol::lua_nil);
+        }
+        batch.TableSize = batch.Entities.size();
+
+        Timer timer;
+        UInt64 allocated = sData.Allocator.GetStats().AllocatedBytes;
+
+        sol::protected_function_result result = script->GetUpdateAll()(batch.Table, dt);
+        COUNTER_ADD("Scripts Run", batch.Entities.size());
+        if (!result.valid()) {
+            sol::error err = result;
+            LOG_ERROR("[LUA::ERROR::UPDATEALL] Error: {0}", err.what());
+        }
+
+        ScriptProfiler::Record(script, -1, timer.GetElapsed(), sData.Allocator.GetStats().AllocatedBytes - allocated);
+    }
+}
+
+void ScriptSystem::DispatchParallelBatches(float dt)
+{
+    UInt64 workerCount = sData.Workers.size();
+    if (workerCount == 0)
+        return;
+
+    for (auto& [script, batch] : sData.Batches) {
+        if (batch.Entities.empty())
+            continue;
+        if (!script->IsBatched() || !script->IsParallel())
+            continue;
+
+        UInt64 entityCount = batch.Entities.size();
+        UInt64 jobCount = std::min(workerCount, (entityCount + MinEntitiesPerJob - 1) / MinEntitiesPerJob);
+        UInt64 jobSize = (entityCount + jobCount - 1) / jobCount;
+
+        // Each script type is waited on before the next one, so two parallel scripts on the same entity never race.
+        Script* parallelScript = script;
+        Vector<int>* entities = &batch.Entities;
+        Timer timer;
+        JobSystem::Counter counter;
+        JobSystem::Dispatch((UInt32)jobCount, [&](UInt32 jobIndex, UInt32 workerIndex) {
+            UInt64 begin = jobIndex * jobSize;
+            UInt64 end = std::min(begin + jobSize, entityCount);
+            if (begin < end) {
+                MEMORY_TAG(MemoryTag::Script);
+                sData.Workers[workerIndex]->Run(parallelScript, *entities, begin, end, dt);
+                COUNTER_ADD("Scripts Run", end - begin);
+            }
+        }, &counter);
+        JobSystem::Wait(&counter);
+
+        ScriptProfiler::Record(script, -1, timer.GetElapsed(), 0);
+    }
+}
+
+void ScriptSystem::FlushWorkerCommands()
+{
+    for (auto& worker : sData.Workers) {
+        for (auto& command : worker->GetCommands()) {
+            switch (command.Type) {
+                case ScriptCommandType::DeleteEntity: {
+                    LuaWrapper::LuaEntity::DeleteEntity(command.Entity);
+                    break;
+                }
+                case ScriptCommandType::SetName: {
+                    LuaWrapper::LuaEntity::SetName(command.Entity, command.Text.c_str());
+                    break;
+                }
+                case ScriptCommandType::Log: {
+                    LOG_INFO("[LUA] {0}", command.Text);
+                    break;
+                }
+                case ScriptCommandType::Error: {
+                    LOG_ERROR("{0}", command.Text);
+                    break;
+                }
+            }
+        }
+        worker->GetCommands().clear();
     }
 }
 
@@ -98,7 +406,20 @@ void ScriptSystem::Quit(Ref<Scene> scene)
     auto view = reg->view<ScriptComponent>();
     for (auto [id, script] : view.each()) {
         for (auto& instance : script.Instances) {
-            instance->Instance->Quit();
+            if (instance->Instance)
+                instance->Instance->Quit();
         }
     }
+
+    reg->on_destroy<ScriptComponent>().disconnect<&ScriptSystem::OnScriptDestroyed>();
+
+    ScriptScheduler::Clear();
+    LuaWrapper::LuaNavigation::ClearPaths();
+    sData.Batches.clear();
+}
+
+void ScriptSystem::OnScriptDestroyed(entt::registry& registry, entt::entity entity)
+{
+    // Nothing is left to read back the entity's paths.
+    LuaWrapper::LuaNavigation::DropPaths((int)entity);
 }
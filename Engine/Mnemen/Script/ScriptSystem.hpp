@@ -8,6 +8,33 @@
 #include <sol/sol.hpp>
 
 #include "World/Scene.hpp"
+#include "ScriptWorker.hpp"
+#include "ScriptAllocator.hpp"
+
+// Collector the Lua states run. Generational suits per-frame garbage, incremental spreads full cycles over frames.
+enum class ScriptGCMode
+{
+    Generational,
+    Incremental
+};
+
+struct ScriptGCSettings
+{
+    ScriptGCMode Mode = ScriptGCMode::Generational;
+    // Generational: a major collection happens once memory grows by MajorMultiplier% since the last one,
+    // a minor one once it grows by MinorMultiplier%.
+    int MinorMultiplier = 20;
+    int MajorMultiplier = 100;
+    // Incremental: a cycle starts once memory reaches Pause% of what survived the last one. StepMultiplier
+    // is how fast the collector runs relative to allocation, and each step does StepSizeKb of work.
+    int Pause = 200;
+    int StepMultiplier = 100;
+    int StepSizeKb = 8;
+    // Incremental only: time ScriptSystem spends stepping the collector at the end of every frame, on top of
+    // Lua's own pacing. 0 leaves collections to Lua alone. Generational mode is always left to Lua, forcing a
+    // young collection every frame costs a whole collection whether or not anything was allocated.
+    float BudgetMs = 0.0f;
+};
 
 class ScriptSystem
 {
@@ -20,12 +47,58 @@ public:
     static void Quit(Ref<Scene> scene);
 
     static sol::state* GetState() { return &sData.State; }    
+    static const ScriptMemoryStats& GetMemoryStats() { return sData.Allocator.GetStats(); }
+
+    // Per-frame time budget for low priority instances, in milliseconds. 0 disables time-slicing.
+    static void SetBudget(float ms) { sData.BudgetMs = ms; }
+    static float GetBudget() { return sData.BudgetMs; }
+
+    // Applies the collector settings to the main state and every worker state.
+    static void SetGCSettings(const ScriptGCSettings& settings);
+    static const ScriptGCSettings& GetGCSettings() { return sData.GC; }
+
+    // Scene load stress test: loads a script and builds its instances, with the default allocator and a full
+    // collection per script load as the engine used to, then with the pool allocator and a single collection.
+    static void RunLoadBenchmark(const String& scriptPath, UInt32 scriptCount, UInt32 instancesPerScript);
 private:
+    friend class ScriptWorker;
+
+    static String FormatLogArgs(const sol::variadic_args& args);
     static void LogCallback(const sol::variadic_args& args);
     static int PanicCallback(lua_State* L);
 
+    static void RunUpdate(ScriptInstance* instance, float dt);
+    static void UpdateLowPriority(float dt, float elapsedMs);
+    static void DispatchBatches(float dt);
+    static void DispatchParallelBatches(float dt);
+    static void FlushWorkerCommands();
+    static void OnScriptDestroyed(entt::registry& registry, entt::entity entity);
+
+    // Below this many entities per job, splitting a parallel batch costs more than it saves.
+    static constexpr UInt64 MinEntitiesPerJob = 64;
+
+    // Most script garbage is per-frame temporaries that die young: by default the states run the generational
+    // collector and Lua paces it. In incremental mode extra work can be stepped at the end of every frame, within a budget.
+    static void ApplyGCSettings(sol::state& state);
+    static void StepGC();
+
+    // Entities gathered this frame for a batched script, handed to updateAll in a single call.
+    struct ScriptBatch {
+        Vector<int> Entities;
+        sol::table Table;
+        UInt64 TableSize = 0;
+    };
+
     static struct Data {
-        sol::state State;
+        ScriptAllocator Allocator;
+        sol::state State{ sol::default_at_panic, &ScriptAllocator::Allocate, &Allocator };
+        UnorderedMap<Script*, ScriptBatch> Batches;
+        Vector<Unique<ScriptWorker>> Workers;
+
+        float BudgetMs = 0.0f;
+        ScriptGCSettings GC;
+        Vector<ScriptInstance*> LowPriority;
+        UInt64 LowPriorityCursor = 0;
     } sData;
 };
 
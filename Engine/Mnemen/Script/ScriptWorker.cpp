@@ -0,0 +1,103 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-21 11:15:20
+//
+
+#include "ScriptWorker.hpp"
+#include "ScriptSystem.hpp"
+#include "ScriptBinding.hpp"
+
+#include <Core/Logger.hpp>
+
+static thread_local ScriptWorker* sCurrentWorker = nullptr;
+
+ScriptWorker::ScriptWorker(UInt32 index)
+    : mIndex(index), mState(sol::default_at_panic, &ScriptAllocator::Allocate, &mAllocator)
+{
+    mState.open_libraries(sol::lib::base,
+                          sol::lib::math,
+                          sol::lib::os,
+                          sol::lib::string,
+                          sol::lib::table,
+                          sol::lib::utf8,
+                          sol::lib::io);
+    mState.set_function("print", &ScriptWorker::LogCallback);
+    mState.set_panic(&ScriptSystem::PanicCallback);
+    ScriptSystem::ApplyGCSettings(mState);
+
+    ScriptBinding::InitBindings(mState);
+
+    mEntities = mState.create_table();
+}
+
+ScriptWorker* ScriptWorker::GetCurrent()
+{
+    return sCurrentWorker;
+}
+
+void ScriptWorker::LogCallback(const sol::variadic_args& args)
+{
+    String message = ScriptSystem::FormatLogArgs(args);
+    if (sCurrentWorker) {
+        sCurrentWorker->PushCommand({ ScriptCommandType::Log, -1, message });
+    } else {
+        LOG_INFO("[LUA] {0}", message);
+    }
+}
+
+ScriptWorker::LoadedScript* ScriptWorker::Load(Script* script)
+{
+    LoadedScript& loaded = mScripts[script->GetPath()];
+    if (loaded.Attempted && loaded.Version == script->GetVersion())
+        return loaded.UpdateAll.valid() ? &loaded : nullptr;
+
+    // A failed load stays failed until the script is reloaded with a new version.
+    loaded.Version = script->GetVersion();
+    loaded.Attempted = true;
+    loaded.UpdateAll = sol::lua_nil;
+
+    // Reuse the bytecode the main state loaded instead of compiling the source again on every worker.
+    const Vector<UInt8>& bytecode = script->GetBytecode();
+    sol::load_result chunk = bytecode.empty() ? mState.load_file(script->GetPath())
+                                              : mState.load_buffer(reinterpret_cast<const char*>(bytecode.data()), bytecode.size(), "@" + script->GetPath(), sol::load_mode::binary);
+    if (!chunk.valid()) {
+        sol::error err = chunk;
+        PushCommand({ ScriptCommandType::Error, -1, fmt::format("[LUA::ERROR::WORKER{0}] Failed to load {1}: {2}", mIndex, script->GetPath(), err.what()) });
+        return nullptr;
+    }
+
+    sol::protected_function_result result = chunk.get<sol::protected_function>()();
+    if (!result.valid() || result.get_type() != sol::type::table) {
+        PushCommand({ ScriptCommandType::Error, -1, fmt::format("[LUA::ERROR::WORKER{0}] {1} did not return a module table", mIndex, script->GetPath()) });
+        return nullptr;
+    }
+
+    sol::table module = result;
+    loaded.UpdateAll = module["updateAll"];
+    return &loaded;
+}
+
+void ScriptWorker::Run(Script* script, const Vector<int>& entities, UInt64 begin, UInt64 end, float dt)
+{
+    sCurrentWorker = this;
+
+    LoadedScript* loaded = Load(script);
+    if (loaded && loaded->UpdateAll.valid()) {
+        UInt64 count = end - begin;
+        for (UInt64 i = 0; i < count; i++) {
+            mEntities.raw_set(i + 1, entities[begin + i]);
+        }
+        for (UInt64 i = count; i < mEntitiesSize; i++) {
+            mEntities.raw_set(i + 1, sol::lua_nil);
+        }
+        mEntitiesSize = count;
+
+        sol::protected_function_result result = loaded->UpdateAll(mEntities, dt);
+        if (!result.valid()) {
+            sol::error err = result;
+            PushCommand({ ScriptCommandType::Error, -1, fmt::format("[LUA::ERROR::UPDATEALL] Error: {0}", err.what()) });
+        }
+    }
+
+    sCurrentWorker = nullptr;
+}
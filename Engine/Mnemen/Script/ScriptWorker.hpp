@@ -0,0 +1,61 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-21 11:02:45
+//
+
+#pragma once
+
+#include "Script.hpp"
+#include "ScriptAllocator.hpp"
+
+enum class ScriptCommandType
+{
+    DeleteEntity,
+    SetName,
+    Log,
+    Error
+};
+
+// Structural changes requested by a script running on a worker, replayed on the main thread once the workers are done.
+struct ScriptCommand
+{
+    ScriptCommandType Type;
+    int Entity = -1;
+    String Text;
+};
+
+class ScriptWorker
+{
+public:
+    ScriptWorker(UInt32 index);
+    ~ScriptWorker() = default;
+
+    // Runs the worker's own copy of the script's updateAll over entities [begin, end).
+    void Run(Script* script, const Vector<int>& entities, UInt64 begin, UInt64 end, float dt);
+
+    void PushCommand(const ScriptCommand& command) { mCommands.push_back(command); }
+    Vector<ScriptCommand>& GetCommands() { return mCommands; }
+    sol::state& GetState() { return mState; }
+
+    // The worker bound to the calling thread while it runs a script, null on the main thread.
+    static ScriptWorker* GetCurrent();
+private:
+    struct LoadedScript {
+        UInt64 Version = 0;
+        bool Attempted = false; ///< Set once Version was loaded, even if it failed, so a broken script isn't reloaded every frame.
+        sol::protected_function UpdateAll;
+    };
+
+    LoadedScript* Load(Script* script);
+    static void LogCallback(const sol::variadic_args& args);
+
+    UInt32 mIndex;
+    ScriptAllocator mAllocator;
+    sol::state mState;
+    UnorderedMap<String, LoadedScript> mScripts;
+
+    sol::table mEntities;
+    UInt64 mEntitiesSize = 0;
+
+    Vector<ScriptCommand> mCommands;
+};
@@ -4,13 +4,23 @@
 //
 
 #include "ScriptWrapper.hpp"
+#include "ScriptWorker.hpp"
 
 #include <Core/Application.hpp>
 #include <World/Scene.hpp>
 #include <World/Entity.hpp>
+#include <Physics/PhysicsSystem.hpp>
+#include <AI/NavPathfinder.hpp>
+
+#include <mutex>
 
 void LuaWrapper::LuaEntity::DeleteEntity(int entity)
 {
+    if (ScriptWorker* worker = ScriptWorker::GetCurrent()) {
+        worker->PushCommand({ ScriptCommandType::DeleteEntity, entity });
+        return;
+    }
+
     auto scene = Application::Get()->GetScene();
     auto registry = scene->GetRegistry();
 
@@ -33,6 +43,11 @@ String LuaWrapper::LuaEntity::GetName(int entity)
 
 void LuaWrapper::LuaEntity::SetName(int entity, const char* name)
 {
+    if (ScriptWorker* worker = ScriptWorker::GetCurrent()) {
+        worker->PushCommand({ ScriptCommandType::SetName, entity, name });
+        return;
+    }
+
     auto scene = Application::Get()->GetScene();
     auto registry = scene->GetRegistry();
 
@@ -88,3 +103,318 @@ AudioSourceComponent& LuaWrapper::LuaEntity::GetAudioSource(int entity)
 
     return wrap.GetComponent<AudioSourceComponent>();
 }
+
+template<int Count, typename T>
+static int ReadTransformArray(lua_State* L, T TransformComponent::* field)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    entt::registry* registry = Application::Get()->GetScene()->GetRegistry();
+    lua_Integer entityCount = (lua_Integer)lua_rawlen(L, 1);
+    for (lua_Integer i = 0; i < entityCount; i++) {
+        lua_rawgeti(L, 1, i + 1);
+        entt::entity id = (entt::entity)lua_tointeger(L, -1);
+        lua_pop(L, 1);
+
+        TransformComponent* transform = registry->try_get<TransformComponent>(id);
+        const float* values = transform ? &((transform->*field)[0]) : nullptr;
+        for (int c = 0; c < Count; c++) {
+            lua_pushnumber(L, values ? values[c] : 0.0f);
+            lua_rawseti(L, 2, i * Count + c + 1);
+        }
+    }
+    return 0;
+}
+
+template<int Count, typename T>
+static int WriteTransformArray(lua_State* L, T TransformComponent::* field)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    entt::registry* registry = Application::Get()->GetScene()->GetRegistry();
+    lua_Integer entityCount = (lua_Integer)lua_rawlen(L, 1);
+    for (lua_Integer i = 0; i < entityCount; i++) {
+        lua_rawgeti(L, 1, i + 1);
+        entt::entity id = (entt::entity)lua_tointeger(L, -1);
+        lua_pop(L, 1);
+
+        TransformComponent* transform = registry->try_get<TransformComponent>(id);
+        if (!transform)
+            continue;
+        float* values = &((transform->*field)[0]);
+        for (int c = 0; c < Count; c++) {
+            lua_rawgeti(L, 2, i * Count + c + 1);
+            values[c] = (float)lua_tonumber(L, -1);
+            lua_pop(L, 1);
+        }
+    }
+    return 0;
+}
+
+int LuaWrapper::LuaTransformArrays::ReadPositions(lua_State* L)
+{
+    return ReadTransformArray<3>(L, &TransformComponent::Position);
+}
+
+int LuaWrapper::LuaTransformArrays::WritePositions(lua_State* L)
+{
+    return WriteTransformArray<3>(L, &TransformComponent::Position);
+}
+
+int LuaWrapper::LuaTransformArrays::ReadRotations(lua_State* L)
+{
+    // glm::quat stores x, y, z, w in memory order
+    return ReadTransformArray<4>(L, &TransformComponent::Rotation);
+}
+
+int LuaWrapper::LuaTransformArrays::WriteRotations(lua_State* L)
+{
+    return WriteTransformArray<4>(L, &TransformComponent::Rotation);
+}
+
+int LuaWrapper::LuaTransformArrays::ReadScales(lua_State* L)
+{
+    return ReadTransformArray<3>(L, &TransformComponent::Scale);
+}
+
+int LuaWrapper::LuaTransformArrays::WriteScales(lua_State* L)
+{
+    return WriteTransformArray<3>(L, &TransformComponent::Scale);
+}
+
+// Query and result storage reused by every batch issued from the same thread.
+static thread_local Vector<PhysicsQuery> sQueries;
+static thread_local Vector<PhysicsHit> sHits;
+
+static glm::vec3 GetVec3(lua_State* L, int index, lua_Integer i)
+{
+    glm::vec3 result;
+    for (int c = 0; c < 3; c++) {
+        lua_rawgeti(L, index, i * 3 + c + 1);
+        result[c] = (float)lua_tonumber(L, -1);
+        lua_pop(L, 1);
+    }
+    return result;
+}
+
+// A number shared by the whole batch, or an array with one value per query.
+static float GetScalar(lua_State* L, int index, lua_Integer i)
+{
+    if (!lua_istable(L, index))
+        return (float)luaL_checknumber(L, index);
+    lua_rawgeti(L, index, i + 1);
+    float result = (float)lua_tonumber(L, -1);
+    lua_pop(L, 1);
+    return result;
+}
+
+// A single {x, y, z} for the whole batch, or a flat array with x, y, z per query.
+static glm::vec3 GetExtents(lua_State* L, int index, lua_Integer i)
+{
+    luaL_checktype(L, index, LUA_TTABLE);
+    return lua_rawlen(L, index) == 3 ? GetVec3(L, index, 0) : GetVec3(L, index, i);
+}
+
+static void PushResultArray(lua_State* L, int results, const char* name)
+{
+    if (lua_getfield(L, results, name) != LUA_TTABLE) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, results, name);
+    }
+}
+
+static int RunQueries(lua_State* L, int results, lua_Integer count)
+{
+    luaL_checktype(L, results, LUA_TTABLE);
+
+    int ignore = results + 1;
+    if (lua_istable(L, ignore)) {
+        for (lua_Integer i = 0; i < count; i++) {
+            lua_rawgeti(L, ignore, i + 1);
+            sQueries[i].IgnoreEntity = lua_isinteger(L, -1) ? (int)lua_tointeger(L, -1) : -1;
+            lua_pop(L, 1);
+        }
+    }
+
+    sHits.resize(count);
+    UInt32 hitCount = PhysicsSystem::QueryBatch(sQueries.data(), sHits.data(), (UInt32)count);
+
+    PushResultArray(L, results, "hit");
+    PushResultArray(L, results, "entity");
+    PushResultArray(L, results, "distance");
+    PushResultArray(L, results, "point");
+    PushResultArray(L, results, "normal");
+    int hit = lua_gettop(L) - 4;
+    for (lua_Integer i = 0; i < count; i++) {
+        const PhysicsHit& result = sHits[i];
+        lua_pushboolean(L, result.Hit);
+        lua_rawseti(L, hit, i + 1);
+        lua_pushinteger(L, result.Entity);
+        lua_rawseti(L, hit + 1, i + 1);
+        lua_pushnumber(L, result.Distance);
+        lua_rawseti(L, hit + 2, i + 1);
+        for (int c = 0; c < 3; c++) {
+            lua_pushnumber(L, result.Point[c]);
+            lua_rawseti(L, hit + 3, i * 3 + c + 1);
+            lua_pushnumber(L, result.Normal[c]);
+            lua_rawseti(L, hit + 4, i * 3 + c + 1);
+        }
+    }
+    lua_pop(L, 5);
+
+    lua_pushinteger(L, hitCount);
+    return 1;
+}
+
+static lua_Integer BeginQueries(lua_State* L, PhysicsQueryType type, bool directions)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    if (directions)
+        luaL_checktype(L, 2, LUA_TTABLE);
+
+    lua_Integer count = (lua_Integer)lua_rawlen(L, 1) / 3;
+    sQueries.resize(count);
+    for (lua_Integer i = 0; i < count; i++) {
+        PhysicsQuery& query = sQueries[i];
+        query = PhysicsQuery();
+        query.Type = type;
+        query.Origin = GetVec3(L, 1, i);
+        if (directions)
+            query.Direction = GetVec3(L, 2, i);
+    }
+    return count;
+}
+
+int LuaWrapper::LuaPhysics::Raycast(lua_State* L)
+{
+    lua_Integer count = BeginQueries(L, PhysicsQueryType::Ray, true);
+    for (lua_Integer i = 0; i < count; i++) {
+        sQueries[i].MaxDistance = GetScalar(L, 3, i);
+    }
+    return RunQueries(L, 4, count);
+}
+
+int LuaWrapper::LuaPhysics::SphereCast(lua_State* L)
+{
+    lua_Integer count = BeginQueries(L, PhysicsQueryType::SphereCast, true);
+    for (lua_Integer i = 0; i < count; i++) {
+        sQueries[i].Radius = GetScalar(L, 3, i);
+        sQueries[i].MaxDistance = GetScalar(L, 4, i);
+    }
+    return RunQueries(L, 5, count);
+}
+
+int LuaWrapper::LuaPhysics::BoxCast(lua_State* L)
+{
+    lua_Integer count = BeginQueries(L, PhysicsQueryType::BoxCast, true);
+    for (lua_Integer i = 0; i < count; i++) {
+        sQueries[i].HalfExtents = GetExtents(L, 3, i);
+        sQueries[i].MaxDistance = GetScalar(L, 4, i);
+    }
+    return RunQueries(L, 5, count);
+}
+
+int LuaWrapper::LuaPhysics::OverlapSphere(lua_State* L)
+{
+    lua_Integer count = BeginQueries(L, PhysicsQueryType::SphereOverlap, false);
+    for (lua_Integer i = 0; i < count; i++) {
+        sQueries[i].Radius = GetScalar(L, 2, i);
+    }
+    return RunQueries(L, 3, count);
+}
+
+int LuaWrapper::LuaPhysics::OverlapBox(lua_State* L)
+{
+    lua_Integer count = BeginQueries(L, PhysicsQueryType::BoxOverlap, false);
+    for (lua_Integer i = 0; i < count; i++) {
+        sQueries[i].HalfExtents = GetExtents(L, 2, i);
+    }
+    return RunQueries(L, 3, count);
+}
+
+// Registered when requested, filled from the pathfinder's sync point, polled from any script worker.
+struct LuaPathRequest
+{
+    int Entity = -1;
+    bool Done = false;
+    NavPathResult Result;
+};
+
+static std::mutex sPathMutex;
+static UnorderedMap<UInt64, LuaPathRequest> sPaths;
+
+UInt64 LuaWrapper::LuaNavigation::RequestPath(const glm::vec3& start, const glm::vec3& goal, sol::optional<int> entity)
+{
+    // Held across the request so the entry exists before the sync point can complete it. The callback only
+    // runs from the sync point, never from inside RequestPath.
+    std::lock_guard<std::mutex> lock(sPathMutex);
+    UInt64 request = NavPathfinder::RequestPath(start, goal, [](const NavPathResult& result) {
+        std::lock_guard<std::mutex> lock(sPathMutex);
+        auto it = sPaths.find(result.Request);
+        if (it == sPaths.end())
+            return; // Dropped while in flight.
+        it->second.Done = true;
+        it->second.Result = result;
+    });
+    if (request != 0)
+        sPaths[request].Entity = entity.value_or(-1);
+    return request;
+}
+
+sol::object LuaWrapper::LuaNavigation::GetPath(UInt64 request, sol::this_state state)
+{
+    NavPathResult result;
+    {
+        std::lock_guard<std::mutex> lock(sPathMutex);
+        auto it = sPaths.find(request);
+        if (it == sPaths.end() || !it->second.Done)
+            return sol::lua_nil;
+        result = std::move(it->second.Result);
+        sPaths.erase(it);
+    }
+
+    sol::state_view lua(state);
+    if (!result.Found)
+        return sol::make_object(lua, false);
+
+    sol::table points = lua.create_table((int)result.Points.size(), 0);
+    for (UInt64 i = 0; i < result.Points.size(); i++)
+        points[i + 1] = result.Points[i];
+    return points;
+}
+
+void LuaWrapper::LuaNavigation::CancelPath(UInt64 request)
+{
+    NavPathfinder::Cancel(request);
+
+    std::lock_guard<std::mutex> lock(sPathMutex);
+    sPaths.erase(request);
+}
+
+void LuaWrapper::LuaNavigation::DropPaths(int entity)
+{
+    std::lock_guard<std::mutex> lock(sPathMutex);
+    for (auto it = sPaths.begin(); it != sPaths.end();) {
+        if (it->second.Entity != entity) {
+            ++it;
+            continue;
+        }
+        if (!it->second.Done)
+            NavPathfinder::Cancel(it->first);
+        it = sPaths.erase(it);
+    }
+}
+
+void LuaWrapper::LuaNavigation::ClearPaths()
+{
+    std::lock_guard<std::mutex> lock(sPathMutex);
+    for (auto& [request, path] : sPaths) {
+        if (!path.Done)
+            NavPathfinder::Cancel(request);
+    }
+    sPaths.clear();
+}
@@ -9,6 +9,8 @@
 
 #include <World/Entity.hpp>
 
+#include <sol/sol.hpp>
+
 namespace LuaWrapper
 {
     enum class Keycode
@@ -131,4 +133,68 @@ namespace LuaWrapper
         static CameraComponent& GetCamera(int entity);
         static AudioSourceComponent& GetAudioSource(int entity);
     };
+
+    /// @brief Bulk access to transform storage as flat Lua number arrays.
+    ///
+    /// Each function takes an array of entity IDs and an array of numbers laid out as x, y, z(, w) per entity.
+    /// They are raw Lua C functions, so a whole batch crosses the boundary once and the script's inner loop
+    /// only touches plain tables instead of vec3/quat usertypes and their metatables.
+    class LuaTransformArrays
+    {
+    public:
+        static int ReadPositions(lua_State* L);
+        static int WritePositions(lua_State* L);
+        static int ReadRotations(lua_State* L);
+        static int WriteRotations(lua_State* L);
+        static int ReadScales(lua_State* L);
+        static int WriteScales(lua_State* L);
+    };
+
+    /// @brief Batched physics scene queries.
+    ///
+    /// Positions, directions and results are flat arrays (x, y, z per query) like the transform arrays.
+    /// The results table is filled in place, with `hit`, `entity`, `distance`, `point` and `normal` arrays
+    /// (created on first use), so a script reusing it across frames doesn't allocate. Every function
+    /// returns the number of queries that hit something. Radii, distances and half extents take either a
+    /// single value for the whole batch or one per query. The optional `ignore` array holds, per query,
+    /// an entity whose body is skipped (usually the one casting).
+    ///
+    ///     Physics.Raycast(origins, directions, maxDistance, results, ignore)
+    ///     Physics.SphereCast(origins, directions, radius, maxDistance, results, ignore)
+    ///     Physics.BoxCast(origins, directions, halfExtents, maxDistance, results, ignore)
+    ///     Physics.OverlapSphere(centers, radius, results, ignore)
+    ///     Physics.OverlapBox(centers, halfExtents, results, ignore)
+    class LuaPhysics
+    {
+    public:
+        static int Raycast(lua_State* L);
+        static int SphereCast(lua_State* L);
+        static int BoxCast(lua_State* L);
+        static int OverlapSphere(lua_State* L);
+        static int OverlapBox(lua_State* L);
+    };
+
+    /// @brief Asynchronous navmesh paths.
+    ///
+    /// Requests go to the pathfinder and are polled back, a Lua callback couldn't be called safely from the
+    /// sync point while the script lives on a worker's Lua state. `GetPath` returns nil while the request
+    /// is pending, false if there is no path, and a table of vec3 corners once, after which the request is
+    /// forgotten. `RequestPath` returns 0 if there is no navmesh. Passing the requesting entity ties the
+    /// request to it, so that it is dropped if the entity goes away before reading it back. Every request
+    /// is dropped when the scene quits.
+    ///
+    ///     local id = Navigation.RequestPath(start, goal, entityID)
+    ///     local path = Navigation.GetPath(id)
+    ///     Navigation.CancelPath(id)
+    class LuaNavigation
+    {
+    public:
+        static UInt64 RequestPath(const glm::vec3& start, const glm::vec3& goal, sol::optional<int> entity);
+        static sol::object GetPath(UInt64 request, sol::this_state state);
+        static void CancelPath(UInt64 request);
+
+        // Not exposed to Lua: the script system drops requests for destroyed entities, and all of them on quit.
+        static void DropPaths(int entity);
+        static void ClearPaths();
+    };
 }
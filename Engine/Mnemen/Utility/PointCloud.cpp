@@ -11,13 +11,14 @@
 
 #include "PointCloud.hpp"
 
-void ProcessNode(aiNode* node, const aiScene* scene, Vector<float>& vertices, Vector<UInt32>& indices)
+void ProcessNode(aiNode* node, const aiScene* scene, Vector<float>& vertices, Vector<UInt32>& indices, Vector<PointCloud::Submesh>& submeshes)
 {
     for (UInt32 i = 0; i < node->mNumMeshes; ++i) {
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
 
         // Offset to maintain global indices
         int indexOffset = vertices.size() / 3;
+        submeshes.push_back({ (UInt32)indexOffset, mesh->mNumVertices });
 
         // Extract vertices
         for (unsigned int j = 0; j < mesh->mNumVertices; ++j) {
@@ -42,7 +43,7 @@ void ProcessNode(aiNode* node, const aiScene* scene, Vector<float>& vertices, Ve
 
     // Recursively process child nodes
     for (UInt32 i = 0; i < node->mNumChildren; ++i) {
-        ProcessNode(node->mChildren[i], scene, vertices, indices);
+        ProcessNode(node->mChildren[i], scene, vertices, indices, submeshes);
     }
 }
 
@@ -58,7 +59,8 @@ void PointCloud::Load(const String& path)
 
     if (!scene || !scene->mRootNode || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) {
         LOG_ERROR("Failed to load point cloud!");
+        return;
     }
 
-    ProcessNode(scene->mRootNode, scene, Points, Indices);
+    ProcessNode(scene->mRootNode, scene, Points, Indices, Submeshes);
 }
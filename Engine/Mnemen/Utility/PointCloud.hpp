@@ -30,6 +30,18 @@ public:
     Vector<float> Points;
     /// @brief The indices of the point cloud
     Vector<UInt32> Indices;
+
+    /// @brief The range of points each mesh of the file occupies
+    struct Submesh
+    {
+        /// @brief The index of the first point of the mesh
+        UInt32 FirstVertex;
+        /// @brief The number of points of the mesh
+        UInt32 VertexCount;
+    };
+
+    /// @brief The meshes of the file, in load order
+    Vector<Submesh> Submeshes;
     
     /// @brief Load a point cloud from the given 3D mesh path.
     /// @param path The path of the mesh to load.
@@ -0,0 +1,82 @@
+//
+// > Notice: Amélie Heinrich @ 2025
+// > Create Time: 2025-02-22 15:41:09
+//
+
+#pragma once
+
+#include <Core/Common.hpp>
+
+/// @brief A hashed timing wheel.
+///
+/// Values are scheduled at an absolute tick and bucketed by `tick % SlotCount`, so advancing the wheel
+/// only touches the slots between the previous and the current tick instead of every pending value.
+/// Values scheduled more than `SlotCount` ticks ahead simply stay in their slot until their round comes.
+///
+/// @tparam T The type of the scheduled values.
+/// @tparam SlotCount The number of slots in the wheel.
+template<typename T, UInt64 SlotCount = 256>
+class TimerWheel
+{
+public:
+    /// @brief Schedules a value to expire at the given tick.
+    /// @param dueTick The absolute tick at which the value expires. Ticks in the past expire on the next advance.
+    /// @param value The value to schedule.
+    void Schedule(UInt64 dueTick, const T& value)
+    {
+        if (dueTick <= mCurrentTick)
+            dueTick = mCurrentTick + 1;
+        mSlots[dueTick % SlotCount].push_back({ dueTick, value });
+        mSize++;
+    }
+
+    /// @brief Advances the wheel up to the given tick and collects every expired value.
+    /// @param tick The new current tick.
+    /// @param expired The vector the expired values are appended to.
+    void Advance(UInt64 tick, Vector<T>& expired)
+    {
+        while (mCurrentTick < tick) {
+            if (mSize == 0) {
+                mCurrentTick = tick;
+                break;
+            }
+            mCurrentTick++;
+
+            Vector<Entry>& slot = mSlots[mCurrentTick % SlotCount];
+            for (UInt64 i = 0; i < slot.size();) {
+                if (slot[i].Due <= mCurrentTick) {
+                    expired.push_back(slot[i].Value);
+                    slot[i] = slot.back();
+                    slot.pop_back();
+                    mSize--;
+                } else {
+                    i++;
+                }
+            }
+        }
+    }
+
+    /// @brief Removes every scheduled value.
+    void Clear()
+    {
+        for (auto& slot : mSlots)
+            slot.clear();
+        mSize = 0;
+    }
+
+    /// @brief Returns the current tick of the wheel.
+    UInt64 GetCurrentTick() const { return mCurrentTick; }
+
+    /// @brief Returns the number of scheduled values.
+    UInt64 GetSize() const { return mSize; }
+private:
+    struct Entry
+    {
+        UInt64 Due;
+        T Value;
+    };
+
+    Array<Vector<Entry>, SlotCount> mSlots;
+    UInt64 mCurrentTick = 0;
+    UInt64 mSize = 0;
+};
@@ -9,47 +9,34 @@
 
 void AudioSourceComponent::Init(const String& path)
 {
-    auto engine = AudioSystem::GetEngine();
-
     Free();
     Handle = AssetManager::Get(path, AssetType::Audio);
-    if (Handle) {
-        ma_result result = ma_sound_init_from_data_source(engine, Handle->Audio->GetDecoder(), 0, nullptr, &Sound);
-        if (result != MA_SUCCESS) {
-            LOG_CRITICAL("Failed to create sound source copy!");
-        }
-        ma_sound_set_position(&Sound, 0.0f, 0.0f, 0.0f);
-    }
 }
 
 void AudioSourceComponent::Free()
 {
     Stop();
+    if (Voice >= 0) {
+        AudioSystem::ReleaseVoice(Voice);
+        Voice = -1;
+    }
     if (Handle) {
-        ma_sound_uninit(&Sound);
         AssetManager::GiveBack(Handle->Path);
+        Handle = nullptr;
     }
 }
 
 void AudioSourceComponent::Play()
 {
     if (Handle) {
-        ma_sound_start(&Sound);
+        Playing = true;
+        Restart = true;
+        Cursor = 0.0f;
     }
 }
 
 void AudioSourceComponent::Stop()
 {
-    if (Handle) {
-        ma_sound_stop(&Sound);
-        ma_sound_seek_to_pcm_frame(&Sound, 0);
-    }
-}
-
-void AudioSourceComponent::Update()
-{
-    if (Handle) {
-        ma_sound_set_looping(&Sound, Looping);
-        ma_sound_set_volume(&Sound, Volume);
-    }
+    Playing = false;
+    Cursor = 0.0f;
 }
@@ -12,6 +12,8 @@
 #include <Asset/AssetManager.hpp>
 #include <Script/ScriptInstance.hpp>
 #include <Renderer/PostProcessVolume.hpp>
+#include <AI/NavMeshBuilder.hpp>
+#include <AI/NavCrowd.hpp>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -273,9 +275,6 @@ struct AudioSourceComponent
     /// @brief The handle to the audio asset representing the sound.
     Asset::Handle Handle;
 
-    /// @brief The sound instance that manages the audio playback.
-    ma_sound Sound;
-
     /// @brief Flag indicating whether the sound should loop during playback.
     bool Looping = false;
 
@@ -285,6 +284,51 @@ struct AudioSourceComponent
     /// @brief The volume of the sound, ranging from 0.0f (muted) to 1.0f (full volume).
     float Volume = 1.0f;
 
+    /// @brief Sources of higher priority get a voice before any source of lower priority, however loud.
+    Int32 Priority = 0;
+
+    /// @brief Whether the sound comes from the entity's transform, or plays as is.
+    bool Spatial = true;
+
+    /// @brief The distance under which the sound plays at full volume.
+    float MinDistance = 1.0f;
+
+    /// @brief The distance past which the sound stops getting quieter.
+    float MaxDistance = 50.0f;
+
+    /// @brief How fast the sound gets quieter between the min and max distance.
+    float Rolloff = 1.0f;
+
+    /// @brief The angle of the cone, around the entity's forward axis, where the sound plays at full volume. 360 for all around.
+    float ConeInnerAngle = 360.0f;
+
+    /// @brief The angle of the cone outside of which the sound plays at `ConeOuterGain`.
+    float ConeOuterAngle = 360.0f;
+
+    /// @brief The volume multiplier outside of the outer cone.
+    float ConeOuterGain = 0.0f;
+
+    /// @brief How strong the doppler effect is, 0 to disable it.
+    float DopplerFactor = 1.0f;
+
+    /// @brief The position of the entity at the last audio update, to find its velocity.
+    glm::vec3 LastPosition = glm::vec3(0.0f);
+
+    /// @brief Whether `LastPosition` was set yet.
+    bool HasLastPosition = false;
+
+    /// @brief Whether the source is playing, with a voice or virtually.
+    bool Playing = false;
+
+    /// @brief Set by `Play` so a source that already has a voice starts over.
+    bool Restart = false;
+
+    /// @brief The playback position in seconds, kept up to date while the source is virtual.
+    float Cursor = 0.0f;
+
+    /// @brief The voice of the source in the audio system's pool, -1 while it's virtual or stopped.
+    Int32 Voice = -1;
+
     /// @brief Initializes the audio source with a specified sound file.
     ///
     /// This function loads and prepares the sound file for playback from the given path.
@@ -300,17 +344,163 @@ struct AudioSourceComponent
     /// @brief Plays the sound from the beginning.
     ///
     /// This function starts the audio playback from the beginning, respecting the `Looping`
-    /// and `Volume` properties.
+    /// and `Volume` properties. The source gets a voice on the next audio update if it ranks high enough.
     void Play();
 
     /// @brief Stops the sound if it is currently playing.
     ///
-    /// This function stops the audio playback and resets it to the idle state.
+    /// This function stops the audio playback and resets it to the idle state. The voice is given back on the next audio update.
     void Stop();
+};
 
-    /// @brief Updates the audio source, typically called every frame.
-    ///
-    /// This function can be used to update properties or check the status of the audio playback
-    /// during the game loop, such as whether the sound has finished playing.
-    void Update();
+/// @brief How a rigid body is moved.
+enum class RigidBodyType
+{
+    Static,    ///< Never moves.
+    Kinematic, ///< Moved by its transform, pushes dynamic bodies but isn't affected by them.
+    Dynamic    ///< Moved by the simulation, written back into its transform.
+};
+
+/// @struct RigidBodyComponent
+/// @brief A component making the entity part of the physics simulation. Needs a `ColliderComponent` to get a body.
+struct RigidBodyComponent
+{
+    /// @brief How the body is moved.
+    RigidBodyType Type = RigidBodyType::Dynamic;
+
+    /// @brief The mass of the body in kilograms. Only used by dynamic bodies.
+    float Mass = 1.0f;
+
+    /// @brief The friction coefficient, usually between 0 and 1.
+    float Friction = 0.5f;
+
+    /// @brief The restitution (bounciness), between 0 and 1.
+    float Restitution = 0.0f;
+
+    /// @brief Linear velocity damping.
+    float LinearDamping = 0.05f;
+
+    /// @brief Angular velocity damping.
+    float AngularDamping = 0.05f;
+
+    /// @brief Multiplier applied to the world gravity.
+    float GravityFactor = 1.0f;
+
+    /// @brief The Jolt body ID, set by the physics system while the scene is playing. Not serialized.
+    /// The default is `JPH::BodyID::cInvalidBodyID`, which this header can't include.
+    UInt32 BodyID = 0xFFFFFFFF;
+
+    /// @brief Position of the body at the step before the last one. Runtime only.
+    glm::vec3 PreviousPosition = glm::vec3(0.0f);
+    /// @brief Position of the body at the last step. Runtime only.
+    glm::vec3 CurrentPosition = glm::vec3(0.0f);
+    /// @brief Rotation of the body at the step before the last one. Runtime only.
+    glm::quat PreviousRotation = glm::quat();
+    /// @brief Rotation of the body at the last step. Runtime only.
+    glm::quat CurrentRotation = glm::quat();
+};
+
+/// @brief The shape of a collider.
+enum class ColliderShape
+{
+    Box,
+    Sphere,
+    Capsule,
+    Mesh,      ///< The triangles of a mesh file, baked in the asset cache. Static and kinematic bodies only.
+    ConvexHull ///< Convex hulls of the meshes of a file, baked in the asset cache.
+};
+
+/// @struct ColliderComponent
+/// @brief A component describing the collision shape of a rigid body. Dimensions are scaled by the entity's transform.
+struct ColliderComponent
+{
+    /// @brief The shape of the collider.
+    ColliderShape Shape = ColliderShape::Box;
+
+    /// @brief Half the size of the box on each axis.
+    glm::vec3 HalfExtents = glm::vec3(0.5f);
+
+    /// @brief Radius of the sphere or capsule.
+    float Radius = 0.5f;
+
+    /// @brief Half the height of the cylinder part of the capsule, along Y.
+    float HalfHeight = 0.5f;
+
+    /// @brief The mesh file the shape is baked from, for mesh and convex hull colliders.
+    String MeshPath = "";
+};
+
+/// @struct NavMeshComponent
+/// @brief A component marking the level geometry agents navigate on. The navmesh is built (or read from the asset cache) when the scene starts playing.
+struct NavMeshComponent
+{
+    /// @brief The mesh file the navmesh is built from.
+    String MeshPath = "";
+
+    /// @brief The agent and voxelization parameters of the build.
+    NavMeshSettings Settings;
+
+    /// @brief Whether NavObstacleComponents can carve the navmesh at runtime. Builds a tile cache, which takes more memory.
+    bool Dynamic = false;
+};
+
+/// @brief The shape an obstacle carves out of the navmesh.
+enum class NavObstacleShape
+{
+    Cylinder, ///< Upright cylinder, centered on the entity.
+    Box       ///< Box rotated around Y only, centered on the entity.
+};
+
+/// @struct NavObstacleComponent
+/// @brief A component making the entity block a dynamic navmesh. Moving the entity only rebuilds the tiles it leaves and enters. Dimensions are scaled by the entity's transform.
+struct NavObstacleComponent
+{
+    /// @brief The shape of the obstacle.
+    NavObstacleShape Shape = NavObstacleShape::Box;
+
+    /// @brief Half the size of the box on each axis.
+    glm::vec3 HalfExtents = glm::vec3(0.5f);
+
+    /// @brief Radius of the cylinder.
+    float Radius = 0.5f;
+
+    /// @brief Height of the cylinder.
+    float Height = 2.0f;
+};
+
+/// @struct NavAgentComponent
+/// @brief A component making the entity walk the navmesh as part of the crowd. The AI system drives its position while the scene plays.
+struct NavAgentComponent
+{
+    /// @brief The movement parameters of the agent.
+    NavAgentParams Params;
+
+    /// @brief Where the agent is heading.
+    glm::vec3 Destination = glm::vec3(0.0f);
+
+    /// @brief Whether the agent has somewhere to go.
+    bool HasDestination = false;
+
+    /// @brief Set when the destination changes, cleared once the crowd accepted the request. Not serialized.
+    bool DestinationChanged = false;
+
+    /// @brief Set while the destination can't be placed on the navmesh. The request is retried every frame. Not serialized.
+    bool DestinationUnreachable = false;
+
+    /// @brief Sends the agent somewhere. The path is computed over the next frames.
+    void SetDestination(const glm::vec3& destination)
+    {
+        Destination = destination;
+        HasDestination = true;
+        DestinationChanged = true;
+        DestinationUnreachable = false;
+    }
+
+    /// @brief Stops the agent where it is.
+    void Stop()
+    {
+        HasDestination = false;
+        DestinationChanged = true;
+        DestinationUnreachable = false;
+    }
 };
@@ -113,10 +113,77 @@ nlohmann::json SceneSerializer::SerializeEntity(Entity entity)
             { "volume", source.Volume },
             { "looping", source.Looping },
             { "playOnAwake", source.PlayOnAwake },
+            { "priority", source.Priority },
+            { "spatial", source.Spatial },
+            { "minDistance", source.MinDistance },
+            { "maxDistance", source.MaxDistance },
+            { "rolloff", source.Rolloff },
+            { "coneInnerAngle", source.ConeInnerAngle },
+            { "coneOuterAngle", source.ConeOuterAngle },
+            { "coneOuterGain", source.ConeOuterGain },
+            { "dopplerFactor", source.DopplerFactor },
             { "path", source.Handle ? source.Handle->Path : nullptr }
         };
     }
 
+    // Physics components
+    if (entity.HasComponent<RigidBodyComponent>()) {
+        RigidBodyComponent rigidBody = entity.GetComponent<RigidBodyComponent>();
+        entityJson["rigidBody"] = {
+            { "type", (int)rigidBody.Type },
+            { "mass", rigidBody.Mass },
+            { "friction", rigidBody.Friction },
+            { "restitution", rigidBody.Restitution },
+            { "linearDamping", rigidBody.LinearDamping },
+            { "angularDamping", rigidBody.AngularDamping },
+            { "gravityFactor", rigidBody.GravityFactor }
+        };
+    }
+    if (entity.HasComponent<ColliderComponent>()) {
+        ColliderComponent collider = entity.GetComponent<ColliderComponent>();
+        entityJson["collider"] = {
+            { "shape", (int)collider.Shape },
+            { "halfExtents", { collider.HalfExtents.x, collider.HalfExtents.y, collider.HalfExtents.z } },
+            { "radius", collider.Radius },
+            { "halfHeight", collider.HalfHeight },
+            { "meshPath", collider.MeshPath }
+        };
+    }
+    if (entity.HasComponent<NavMeshComponent>()) {
+        NavMeshComponent navMesh = entity.GetComponent<NavMeshComponent>();
+        entityJson["navMesh"] = {
+            { "meshPath", navMesh.MeshPath },
+            { "cellSize", navMesh.Settings.CellSize },
+            { "cellHeight", navMesh.Settings.CellHeight },
+            { "agentHeight", navMesh.Settings.AgentHeight },
+            { "agentRadius", navMesh.Settings.AgentRadius },
+            { "agentMaxClimb", navMesh.Settings.AgentMaxClimb },
+            { "agentMaxSlope", navMesh.Settings.AgentMaxSlope },
+            { "tileSize", navMesh.Settings.TileSize },
+            { "dynamic", navMesh.Dynamic }
+        };
+    }
+    if (entity.HasComponent<NavObstacleComponent>()) {
+        NavObstacleComponent obstacle = entity.GetComponent<NavObstacleComponent>();
+        entityJson["navObstacle"] = {
+            { "shape", (int)obstacle.Shape },
+            { "halfExtents", { obstacle.HalfExtents.x, obstacle.HalfExtents.y, obstacle.HalfExtents.z } },
+            { "radius", obstacle.Radius },
+            { "height", obstacle.Height }
+        };
+    }
+    if (entity.HasComponent<NavAgentComponent>()) {
+        NavAgentComponent agent = entity.GetComponent<NavAgentComponent>();
+        entityJson["navAgent"] = {
+            { "radius", agent.Params.Radius },
+            { "height", agent.Params.Height },
+            { "maxSpeed", agent.Params.MaxSpeed },
+            { "maxAcceleration", agent.Params.MaxAcceleration },
+            { "hasDestination", agent.HasDestination },
+            { "destination", { agent.Destination.x, agent.Destination.y, agent.Destination.z } }
+        };
+    }
+
     return entityJson;
 }
 
@@ -157,6 +224,67 @@ Entity SceneSerializer::DeserializeEntity(Ref<Scene> scene, const nlohmann::json
         audio.Looping = a["looping"];
         audio.PlayOnAwake = a["playOnAwake"];
         audio.Volume = a["volume"];
+        audio.Priority = a.value("priority", 0);
+        // Scenes from before spatial audio played everything flat.
+        audio.Spatial = a.value("spatial", false);
+        audio.MinDistance = a.value("minDistance", audio.MinDistance);
+        audio.MaxDistance = a.value("maxDistance", audio.MaxDistance);
+        audio.Rolloff = a.value("rolloff", audio.Rolloff);
+        audio.ConeInnerAngle = a.value("coneInnerAngle", audio.ConeInnerAngle);
+        audio.ConeOuterAngle = a.value("coneOuterAngle", audio.ConeOuterAngle);
+        audio.ConeOuterGain = a.value("coneOuterGain", audio.ConeOuterGain);
+        audio.DopplerFactor = a.value("dopplerFactor", audio.DopplerFactor);
+    }
+    if (entityJson.contains("rigidBody")) {
+        auto& rigidBody = entity.AddComponent<RigidBodyComponent>();
+        auto r = entityJson["rigidBody"];
+        rigidBody.Type = (RigidBodyType)r["type"].get<int>();
+        rigidBody.Mass = r["mass"];
+        rigidBody.Friction = r["friction"];
+        rigidBody.Restitution = r["restitution"];
+        rigidBody.LinearDamping = r["linearDamping"];
+        rigidBody.AngularDamping = r["angularDamping"];
+        rigidBody.GravityFactor = r["gravityFactor"];
+    }
+    if (entityJson.contains("collider")) {
+        auto& collider = entity.AddComponent<ColliderComponent>();
+        auto c = entityJson["collider"];
+        collider.Shape = (ColliderShape)c["shape"].get<int>();
+        collider.HalfExtents = {c["halfExtents"][0], c["halfExtents"][1], c["halfExtents"][2]};
+        collider.Radius = c["radius"];
+        collider.HalfHeight = c["halfHeight"];
+        collider.MeshPath = c.value("meshPath", "");
+    }
+    if (entityJson.contains("navMesh")) {
+        auto& navMesh = entity.AddComponent<NavMeshComponent>();
+        auto n = entityJson["navMesh"];
+        navMesh.MeshPath = n["meshPath"];
+        navMesh.Settings.CellSize = n["cellSize"];
+        navMesh.Settings.CellHeight = n["cellHeight"];
+        navMesh.Settings.AgentHeight = n["agentHeight"];
+        navMesh.Settings.AgentRadius = n["agentRadius"];
+        navMesh.Settings.AgentMaxClimb = n["agentMaxClimb"];
+        navMesh.Settings.AgentMaxSlope = n["agentMaxSlope"];
+        navMesh.Settings.TileSize = n["tileSize"];
+        navMesh.Dynamic = n.value("dynamic", false);
+    }
+    if (entityJson.contains("navObstacle")) {
+        auto& obstacle = entity.AddComponent<NavObstacleComponent>();
+        auto o = entityJson["navObstacle"];
+        obstacle.Shape = (NavObstacleShape)o["shape"].get<int>();
+        obstacle.HalfExtents = {o["halfExtents"][0], o["halfExtents"][1], o["halfExtents"][2]};
+        obstacle.Radius = o["radius"];
+        obstacle.Height = o["height"];
+    }
+    if (entityJson.contains("navAgent")) {
+        auto& agent = entity.AddComponent<NavAgentComponent>();
+        auto a = entityJson["navAgent"];
+        agent.Params.Radius = a["radius"];
+        agent.Params.Height = a["height"];
+        agent.Params.MaxSpeed = a["maxSpeed"];
+        agent.Params.MaxAcceleration = a["maxAcceleration"];
+        agent.HasDestination = a["hasDestination"];
+        agent.Destination = {a["destination"][0], a["destination"][1], a["destination"][2]};
     }
     for (auto& script : entityJson["scripts"]) {
         auto& sc = entity.GetComponent<ScriptComponent>();
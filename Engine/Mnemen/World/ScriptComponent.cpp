@@ -26,7 +26,7 @@ void ScriptComponent::EntityScript::Load(const String& path)
     }
     Handle = AssetManager::Get(path, AssetType::Script);
     if (Handle)
-        Instance = MakeRef<ScriptInstance>(Handle->Script->GetHandle());
+        Instance = MakeRef<ScriptInstance>(Handle->Script.get());
 }
 
 void ScriptComponent::AddEmptyScript()
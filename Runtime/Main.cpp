@@ -5,15 +5,172 @@
 
 #include "Runtime.hpp"
 
-int main()
+// Headless physics stress test, `Runtime --physics-benchmark [bodyCount]`
+static int RunPhysicsBenchmark(int argc, char** argv, int flagIndex)
 {
+    UInt32 bodyCount = 10000;
+    if (flagIndex + 1 < argc)
+        bodyCount = std::stoul(argv[flagIndex + 1]);
+
+    Logger::Init();
+    JobSystem::Init();
+    PhysicsSystem::Init();
+    PhysicsSystem::RunBenchmark(bodyCount);
+    PhysicsSystem::Exit();
+    JobSystem::Exit();
+    Logger::Exit();
+    return 0;
+}
+
+// Voice pool and mixing stress test without a sound card, `Runtime --audio-benchmark [clipPath] [emitterCount] [captureWav]`
+static int RunAudioBenchmark(int argc, char** argv, int flagIndex)
+{
+    String clipPath = "Assets/Audio/Back_music.MP3";
+    UInt32 emitterCount = 10000;
+    if (flagIndex + 1 < argc)
+        clipPath = argv[flagIndex + 1];
+    if (flagIndex + 2 < argc)
+        emitterCount = std::stoul(argv[flagIndex + 2]);
+
+    Logger::Init();
+    AudioSystem::Init(AudioBackend::Offline);
+    if (flagIndex + 3 < argc)
+        AudioSystem::StartCapture(argv[flagIndex + 3]);
+    AudioSystem::RunBenchmark(clipPath, emitterCount);
+    AudioSystem::Exit();
+    Logger::Exit();
+    return 0;
+}
+
+// Headless navmesh build, `Runtime --navmesh-benchmark [meshPath]`
+static int RunNavMeshBenchmark(int argc, char** argv, int flagIndex)
+{
+    String meshPath = "Assets/Models/Sponza/Sponza.gltf";
+    if (flagIndex + 1 < argc)
+        meshPath = argv[flagIndex + 1];
+
+    Logger::Init();
+    JobSystem::Init();
+    NavMeshBuilder::RunBenchmark(meshPath);
+    JobSystem::Exit();
+    Logger::Exit();
+    return 0;
+}
+
+// Headless crowd simulation, `Runtime --crowd-benchmark [meshPath]`
+static int RunCrowdBenchmark(int argc, char** argv, int flagIndex)
+{
+    String meshPath = "Assets/Models/Sponza/Sponza.gltf";
+    if (flagIndex + 1 < argc)
+        meshPath = argv[flagIndex + 1];
+
+    Logger::Init();
+    JobSystem::Init();
+    NavCrowd::RunBenchmark(meshPath);
+    JobSystem::Exit();
+    Logger::Exit();
+    return 0;
+}
+
+// Headless burst of path requests, `Runtime --pathfinding-benchmark [meshPath] [requestCount]`
+static int RunPathfindingBenchmark(int argc, char** argv, int flagIndex)
+{
+    String meshPath = "Assets/Models/Sponza/Sponza.gltf";
+    UInt32 requestCount = 500;
+    if (flagIndex + 1 < argc)
+        meshPath = argv[flagIndex + 1];
+    if (flagIndex + 2 < argc)
+        requestCount = std::stoul(argv[flagIndex + 2]);
+
+    Logger::Init();
+    JobSystem::Init();
+    NavPathfinder::RunBenchmark(meshPath, requestCount);
+    JobSystem::Exit();
+    Logger::Exit();
+    return 0;
+}
+
+// Scene load with the default allocator against the pool allocator, `Runtime --script-benchmark [scriptPath] [scriptCount] [instancesPerScript]`
+static int RunScriptBenchmark(int argc, char** argv, int flagIndex)
+{
+    String scriptPath = "Assets/Scripts/Translate.lua";
+    UInt32 scriptCount = 1000;
+    UInt32 instancesPerScript = 10;
+    if (flagIndex + 1 < argc)
+        scriptPath = argv[flagIndex + 1];
+    if (flagIndex + 2 < argc)
+        scriptCount = std::stoul(argv[flagIndex + 2]);
+    if (flagIndex + 3 < argc)
+        instancesPerScript = std::stoul(argv[flagIndex + 3]);
+
+    Logger::Init();
+    ScriptSystem::RunLoadBenchmark(scriptPath, scriptCount, instancesPerScript);
+    Logger::Exit();
+    return 0;
+}
+
+// Log call cost, synchronous against asynchronous, `Runtime --log-benchmark [lineCount]`
+static int RunLogBenchmark(int argc, char** argv, int flagIndex)
+{
+    UInt32 lineCount = 200000;
+    if (flagIndex + 1 < argc)
+        lineCount = std::stoul(argv[flagIndex + 1]);
+
+    Logger::Init();
+    Logger::RunBenchmark(lineCount);
+    Logger::Exit();
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++) {
+        if (String(argv[i]) == "--physics-benchmark")
+            return RunPhysicsBenchmark(argc, argv, i);
+        if (String(argv[i]) == "--audio-benchmark")
+            return RunAudioBenchmark(argc, argv, i);
+        if (String(argv[i]) == "--navmesh-benchmark")
+            return RunNavMeshBenchmark(argc, argv, i);
+        if (String(argv[i]) == "--crowd-benchmark")
+            return RunCrowdBenchmark(argc, argv, i);
+        if (String(argv[i]) == "--pathfinding-benchmark")
+            return RunPathfindingBenchmark(argc, argv, i);
+        if (String(argv[i]) == "--script-benchmark")
+            return RunScriptBenchmark(argc, argv, i);
+        if (String(argv[i]) == "--log-benchmark")
+            return RunLogBenchmark(argc, argv, i);
+    }
+
     ApplicationSpecs specs;
     specs.Width = 1280;
     specs.Height = 720;
     specs.WindowTitle = "Game Demo";
     specs.ProjectPath = "TestGame.mpj";
     specs.CopyToBackBuffer = true;
+    // Profiler capture, `Runtime --trace <path> [--trace-frames count] [--trace-delay frames]`
+    // Metrics export, `Runtime --metrics-csv <path>`, written on exit
+    String tracePath;
+    String metricsPath;
+    UInt32 traceFrames = 300;
+    UInt32 traceDelay = 0;
+    for (int i = 1; i < argc; i++) {
+        String arg = argv[i];
+        if (arg == "--null-audio")
+            specs.Audio = AudioBackend::Null;
+        else if (arg == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (arg == "--trace-frames" && i + 1 < argc)
+            traceFrames = std::stoul(argv[++i]);
+        else if (arg == "--trace-delay" && i + 1 < argc)
+            traceDelay = std::stoul(argv[++i]);
+        else if (arg == "--metrics-csv" && i + 1 < argc)
+            metricsPath = argv[++i];
+    }
 
     Runtime runtime(specs);
+    if (!tracePath.empty())
+        Profiler::StartCapture(tracePath, traceFrames, traceDelay);
+    if (!metricsPath.empty())
+        Metrics::StartCSV(metricsPath);
     runtime.Run();
 }
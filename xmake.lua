@@ -7,6 +7,12 @@ add_rules("mode.debug", "mode.release", "mode.releasedbg")
 
 includes("ThirdParty")
 
+option("track_allocations")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Track heap allocations per engine subsystem")
+option_end()
+
 target("Mnemen")
     set_kind("static")
     set_group("Engine")
@@ -22,6 +28,7 @@ target("Mnemen")
              "Recast",
              "Detour",
              "DetourCrowd",
+             "DetourTileCache",
              "DetourDebugUtils",
              "Lua")
     
@@ -50,6 +57,9 @@ target("Mnemen")
                     "ThirdParty/Lua/src")
     add_linkdirs("ThirdParty/SDL3/lib")
     add_defines("GLM_ENABLE_EXPERIMENTAL", "USE_PIX", "GLM_FORCE_DEPTH_ZERO_TO_ONE")
+    if has_config("track_allocations") then
+        add_defines("MNEMEN_TRACK_ALLOCATIONS", {public = true})
+    end
 
     if is_plat("windows") then
         add_syslinks("user32",